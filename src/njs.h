@@ -169,9 +169,30 @@ typedef struct {
     uint8_t                         sandbox;         /* 1 bit */
     uint8_t                         unsafe;          /* 1 bit */
     uint8_t                         module;          /* 1 bit */
+
+/*
+ * regexp_prewarm - compiles RegExp literals both for byte and UTF-8 strings
+ *  when the script is compiled, so the clones do not compile them on first
+ *  use.  Only the UTF-8 variant is compiled in advance otherwise.
+ *
+ * regexp_cache_size - the number of RegExp patterns created from strings
+ *  which are kept compiled for the VM and its clones, 256 if zero.
+ */
+
+    uint8_t                         regexp_prewarm;  /* 1 bit */
+
+    njs_uint_t                      regexp_cache_size;
 } njs_vm_opt_t;
 
 
+typedef struct {
+    njs_uint_t                      size;
+    njs_uint_t                      max;
+    uint64_t                        hits;
+    uint64_t                        misses;
+} njs_vm_regexp_cache_stat_t;
+
+
 NJS_EXPORT njs_vm_t *njs_vm_create(njs_vm_opt_t *options);
 NJS_EXPORT void njs_vm_destroy(njs_vm_t *vm);
 
@@ -231,6 +252,9 @@ NJS_EXPORT njs_int_t njs_vm_start(njs_vm_t *vm);
 
 NJS_EXPORT njs_int_t njs_vm_add_path(njs_vm_t *vm, const njs_str_t *path);
 
+NJS_EXPORT void njs_vm_regexp_cache_stat(njs_vm_t *vm,
+    njs_vm_regexp_cache_stat_t *stat);
+
 NJS_EXPORT const njs_extern_t *njs_vm_external_prototype(njs_vm_t *vm,
     njs_external_t *external);
 NJS_EXPORT njs_int_t njs_vm_external_create(njs_vm_t *vm,
@@ -315,5 +339,9 @@ NJS_EXPORT njs_int_t njs_vm_json_parse(njs_vm_t *vm, njs_value_t *args,
     njs_uint_t nargs);
 NJS_EXPORT njs_int_t njs_vm_json_stringify(njs_vm_t *vm, njs_value_t *args,
     njs_uint_t nargs);
+NJS_EXPORT njs_int_t njs_vm_json_parser_create(njs_vm_t *vm,
+    njs_value_t *args, njs_uint_t nargs);
+NJS_EXPORT njs_int_t njs_vm_json_parse_chunk(njs_vm_t *vm,
+    njs_value_t *parser, const u_char *start, size_t size, njs_bool_t last);
 
 #endif /* _NJS_H_INCLUDED_ */
@@ -1128,6 +1128,7 @@ njs_array_prototype_join(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     njs_int_t          ret;
     njs_chb_t          chain;
     njs_uint_t         i;
+    njs_bool_t         converted;
     njs_array_t        *array;
     njs_value_t        *value;
     njs_string_prop_t  separator, string;
@@ -1163,6 +1164,7 @@ njs_array_prototype_join(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     njs_chb_init(&chain, vm->mem_pool);
 
     length = 0;
+    converted = 0;
 
     for (i = 0; i < array->length; i++) {
         value = &array->start[i];
@@ -1173,6 +1175,8 @@ njs_array_prototype_join(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
                     return ret;
                 }
 
+                converted = 1;
+
             } else {
                 (void) njs_string_prop(&string, value);
                 length += string.length;
@@ -1189,7 +1193,16 @@ njs_array_prototype_join(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 
     size = njs_chb_size(&chain);
 
-    if (length != 0) {
+    if (converted) {
+        /* The converted values are not counted above. */
+
+        length = njs_chb_utf8_length(&chain);
+
+        if (length < 0) {
+            length = 0;
+        }
+
+    } else if (length != 0) {
         length -= separator.length;
     }
 
@@ -71,6 +71,9 @@ static const njs_object_type_init_t *const
 
     &njs_hash_type_init,
     &njs_hmac_type_init,
+    &njs_string_builder_type_init,
+    &njs_json_parser_type_init,
+    &njs_json_view_type_init,
 
     /* Error types. */
 
@@ -137,6 +140,11 @@ njs_builtin_objects_create(njs_vm_t *vm)
 
     shared->empty_regexp_pattern = pattern;
 
+    shared->regexp_cache = njs_regexp_cache_create(vm);
+    if (njs_slow_path(shared->regexp_cache == NULL)) {
+        return NJS_ERROR;
+    }
+
     ret = njs_object_hash_init(vm, &shared->array_instance_hash,
                                &njs_array_instance_init);
     if (njs_slow_path(ret != NJS_OK)) {
@@ -1290,6 +1298,24 @@ static const njs_object_prop_t  njs_njs_object_properties[] =
         .value = njs_native_function(njs_dump_value, 0),
         .configurable = 1,
     },
+
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("jsonView"),
+        .value = njs_native_function(njs_json_view_create, 1),
+        .writable = 1,
+        .configurable = 1,
+    },
+
+    {
+        .type = NJS_PROPERTY_HANDLER,
+        .name = njs_string("StringBuilder"),
+        .value = njs_prop_handler2(njs_top_level_constructor,
+                                   NJS_OBJ_TYPE_STRING_BUILDER,
+                                   NJS_STRING_BUILDER_HASH),
+        .writable = 1,
+        .configurable = 1,
+    },
 };
 
 
@@ -122,6 +122,33 @@ njs_leading_zeros64(uint64_t x)
 #endif
 
 
+#if (NJS_HAVE_BUILTIN_CTZLL)
+#define njs_trailing_zeros64(x)  (((x) == 0) ? 64 : __builtin_ctzll(x))
+
+#else
+
+njs_inline uint64_t
+njs_trailing_zeros64(uint64_t x)
+{
+    uint64_t  n;
+
+    if (x == 0) {
+        return 64;
+    }
+
+    n = 0;
+
+    while ((x & 1) == 0) {
+        n++;
+        x >>= 1;
+    }
+
+    return n;
+}
+
+#endif
+
+
 #if (NJS_HAVE_GCC_ATTRIBUTE_VISIBILITY)
 #define NJS_EXPORT         __attribute__((visibility("default")))
 
@@ -17,8 +17,6 @@ typedef struct {
 
 static njs_code_name_t  code_names[] = {
 
-    { NJS_VMCODE_OBJECT, sizeof(njs_vmcode_object_t),
-          njs_str("OBJECT          ") },
     { NJS_VMCODE_FUNCTION, sizeof(njs_vmcode_function_t),
           njs_str("FUNCTION        ") },
     { NJS_VMCODE_THIS, sizeof(njs_vmcode_this_t),
@@ -27,8 +25,6 @@ static njs_code_name_t  code_names[] = {
           njs_str("ARGUMENTS       ") },
     { NJS_VMCODE_REGEXP, sizeof(njs_vmcode_regexp_t),
           njs_str("REGEXP          ") },
-    { NJS_VMCODE_TEMPLATE_LITERAL, sizeof(njs_vmcode_template_literal_t),
-          njs_str("TEMPLATE LITERAL") },
     { NJS_VMCODE_OBJECT_COPY, sizeof(njs_vmcode_object_copy_t),
           njs_str("OBJECT COPY     ") },
 
@@ -159,31 +155,35 @@ njs_disassembler(njs_vm_t *vm)
 void
 njs_disassemble(u_char *start, u_char *end)
 {
-    u_char                       *p;
-    njs_str_t                    *name;
-    njs_uint_t                   n;
-    const char                   *sign;
-    njs_code_name_t              *code_name;
-    njs_vmcode_jump_t            *jump;
-    njs_vmcode_1addr_t           *code1;
-    njs_vmcode_2addr_t           *code2;
-    njs_vmcode_3addr_t           *code3;
-    njs_vmcode_array_t           *array;
-    njs_vmcode_catch_t           *catch;
-    njs_vmcode_finally_t         *finally;
-    njs_vmcode_try_end_t         *try_end;
-    njs_vmcode_try_start_t       *try_start;
-    njs_vmcode_operation_t       operation;
-    njs_vmcode_cond_jump_t       *cond_jump;
-    njs_vmcode_test_jump_t       *test_jump;
-    njs_vmcode_prop_next_t       *prop_next;
-    njs_vmcode_try_return_t      *try_return;
-    njs_vmcode_equal_jump_t      *equal;
-    njs_vmcode_prop_foreach_t    *prop_foreach;
-    njs_vmcode_method_frame_t    *method;
-    njs_vmcode_prop_accessor_t   *prop_accessor;
-    njs_vmcode_try_trampoline_t  *try_tramp;
-    njs_vmcode_function_frame_t  *function;
+    u_char                         *p;
+    njs_str_t                      *name;
+    njs_uint_t                     n, i;
+    njs_index_t                    *parts;
+    const char                     *sign;
+    njs_code_name_t                *code_name;
+    njs_vmcode_jump_t              *jump;
+    njs_vmcode_1addr_t             *code1;
+    njs_vmcode_2addr_t             *code2;
+    njs_vmcode_3addr_t             *code3;
+    njs_vmcode_array_t             *array;
+    njs_vmcode_object_t            *object;
+    njs_vmcode_catch_t             *catch;
+    njs_vmcode_finally_t           *finally;
+    njs_vmcode_try_end_t           *try_end;
+    njs_vmcode_try_start_t         *try_start;
+    njs_vmcode_operation_t         operation;
+    njs_vmcode_cond_jump_t         *cond_jump;
+    njs_vmcode_test_jump_t         *test_jump;
+    njs_vmcode_prop_next_t         *prop_next;
+    njs_vmcode_try_return_t        *try_return;
+    njs_vmcode_equal_jump_t        *equal;
+    njs_vmcode_prop_foreach_t      *prop_foreach;
+    njs_vmcode_method_frame_t      *method;
+    njs_vmcode_prop_slot_t         *prop_slot;
+    njs_vmcode_prop_accessor_t     *prop_accessor;
+    njs_vmcode_try_trampoline_t    *try_tramp;
+    njs_vmcode_function_frame_t    *function;
+    njs_vmcode_template_literal_t  *template;
 
     p = start;
 
@@ -196,12 +196,44 @@ njs_disassemble(u_char *start, u_char *end)
     while (p < end) {
         operation = *(njs_vmcode_operation_t *) p;
 
+        if (operation == NJS_VMCODE_OBJECT) {
+            object = (njs_vmcode_object_t *) p;
+
+            njs_printf("%05uz OBJECT            %04Xz%s\n",
+                       p - start, (size_t) object->retval,
+                       (object->boilerplate != NULL) ? " BOILERPLATE" : "");
+
+            p += sizeof(njs_vmcode_object_t);
+
+            continue;
+        }
+
+        if (operation == NJS_VMCODE_TEMPLATE_LITERAL) {
+            template = (njs_vmcode_template_literal_t *) p;
+            parts = njs_vmcode_template_literal_parts(template);
+
+            njs_printf("%05uz TEMPLATE LITERAL  %04Xz",
+                       p - start, (size_t) template->retval);
+
+            for (i = 0; i < template->nparts; i++) {
+                njs_printf(" %04Xz", (size_t) parts[i]);
+            }
+
+            njs_printf("\n");
+
+            p += njs_vmcode_template_literal_size(template);
+
+            continue;
+        }
+
         if (operation == NJS_VMCODE_ARRAY) {
             array = (njs_vmcode_array_t *) p;
 
             njs_printf("%05uz ARRAY             %04Xz %uz%s\n",
                        p - start, (size_t) array->retval,
-                       (size_t) array->length, array->ctor ? " INIT" : "");
+                       (size_t) array->length,
+                       (array->items != NULL) ? " ITEMS"
+                                              : array->ctor ? " INIT" : "");
 
             p += sizeof(njs_vmcode_array_t);
 
@@ -347,6 +379,18 @@ njs_disassemble(u_char *start, u_char *end)
             continue;
         }
 
+        if (operation == NJS_VMCODE_PROPERTY_SLOT) {
+            prop_slot = (njs_vmcode_prop_slot_t *) p;
+
+            njs_printf("%05uz PROP SLOT         %04Xz %04Xz %uz\n",
+                       p - start, (size_t) prop_slot->value,
+                       (size_t) prop_slot->object, (size_t) prop_slot->slot);
+
+            p += sizeof(njs_vmcode_prop_slot_t);
+
+            continue;
+        }
+
         if (operation == NJS_VMCODE_TRY_START) {
             try_start = (njs_vmcode_try_start_t *) p;
 
@@ -117,10 +117,19 @@ static njs_int_t njs_generate_operation_assignment(njs_vm_t *vm,
     njs_generator_t *generator, njs_parser_node_t *node);
 static njs_int_t njs_generate_object(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node);
+static njs_int_t njs_generate_object_boilerplate(njs_vm_t *vm,
+    njs_parser_node_t *node, njs_object_boilerplate_t **boilerplate);
+static njs_int_t njs_generate_object_slots(njs_vm_t *vm,
+    njs_generator_t *generator, njs_parser_node_t *object,
+    njs_parser_node_t *stmt, njs_uint_t *slot);
 static njs_int_t njs_generate_property_accessor(njs_vm_t *vm,
     njs_generator_t *generator, njs_parser_node_t *node);
 static njs_int_t njs_generate_array(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node);
+static njs_int_t njs_generate_array_items(njs_vm_t *vm,
+    njs_parser_node_t *node, njs_value_t **items);
+static njs_int_t njs_generate_array_slots(njs_vm_t *vm,
+    njs_generator_t *generator, njs_parser_node_t *stmt);
 static njs_int_t njs_generate_function(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node);
 static njs_int_t njs_generate_regexp(njs_vm_t *vm, njs_generator_t *generator,
@@ -1858,19 +1867,195 @@ static njs_int_t
 njs_generate_object(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
 {
-    njs_vmcode_object_t  *object;
+    njs_int_t                 ret;
+    njs_uint_t                slot;
+    njs_vmcode_object_t       *object;
+    njs_object_boilerplate_t  *boilerplate;
 
     node->index = njs_generate_object_dest_index(vm, generator, node);
     if (njs_slow_path(node->index == NJS_INDEX_ERROR)) {
         return NJS_ERROR;
     }
 
+    ret = njs_generate_object_boilerplate(vm, node, &boilerplate);
+    if (njs_slow_path(ret == NJS_ERROR)) {
+        return NJS_ERROR;
+    }
+
     njs_generate_code(generator, njs_vmcode_object_t, object,
                       NJS_VMCODE_OBJECT, 1);
     object->retval = node->index;
+    object->boilerplate = boilerplate;
+
+    if (boilerplate == NULL) {
+        /* Initialize object. */
+        return njs_generator(vm, generator, node->left);
+    }
+
+    slot = 0;
+
+    return njs_generate_object_slots(vm, generator, node, node->left, &slot);
+}
+
+
+/*
+ * An object literal with only constant property names, such as
+ * {a: 1, b: x, "c": [], 2: 'z'}, is compiled to a boilerplate: a property
+ * table with precomputed name hashes which is cloned by a single allocation.
+ * Constant values are stored in the boilerplate, other values are
+ * evaluated in the source order and stored to their property slots.
+ * Literals with accessors, __proto__, computed or duplicate names
+ * are initialized property by property.
+ */
+
+static njs_int_t
+njs_generate_object_boilerplate(njs_vm_t *vm, njs_parser_node_t *node,
+    njs_object_boilerplate_t **boilerplate)
+{
+    uint32_t                  *hashes;
+    njs_int_t                 ret;
+    njs_str_t                 name;
+    njs_uint_t                i, j, n;
+    njs_object_prop_t         *prop, *properties;
+    njs_parser_node_t         *stmt, *assign, *key, *value;
+    njs_object_boilerplate_t  *bp;
+
+    *boilerplate = NULL;
+
+    n = 0;
+
+    for (stmt = node->left; stmt != NULL; stmt = stmt->left) {
+        assign = stmt->right;
+
+        if (assign->token != NJS_TOKEN_ASSIGNMENT
+            || assign->left->token != NJS_TOKEN_PROPERTY_INIT)
+        {
+            return NJS_DECLINED;
+        }
+
+        key = assign->left->right;
+
+        if (key->token != NJS_TOKEN_STRING && key->token != NJS_TOKEN_NUMBER) {
+            return NJS_DECLINED;
+        }
+
+        n++;
+    }
+
+    if (n == 0) {
+        return NJS_DECLINED;
+    }
+
+    bp = njs_mp_alloc(vm->mem_pool, sizeof(njs_object_boilerplate_t));
+    properties = njs_mp_align(vm->mem_pool, sizeof(njs_value_t),
+                              n * sizeof(njs_object_prop_t));
+    hashes = njs_mp_alloc(vm->mem_pool, n * sizeof(uint32_t));
+
+    if (njs_slow_path(bp == NULL || properties == NULL || hashes == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    i = n;
+
+    for (stmt = node->left; stmt != NULL; stmt = stmt->left) {
+        i--;
+
+        prop = &properties[i];
+        key = stmt->right->left->right;
+        value = stmt->right->right;
+
+        ret = njs_primitive_value_to_key(vm, &prop->name, &key->u.value);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return NJS_ERROR;
+        }
+
+        if (value->token >= NJS_TOKEN_FIRST_CONST
+            && value->token <= NJS_TOKEN_LAST_CONST)
+        {
+            prop->value = value->u.value;
+
+        } else {
+            njs_set_undefined(&prop->value);
+        }
+
+        prop->type = NJS_PROPERTY;
+        prop->writable = 1;
+        prop->enumerable = 1;
+        prop->configurable = 1;
+
+        njs_set_invalid(&prop->getter);
+        njs_set_invalid(&prop->setter);
+
+        njs_string_get(&prop->name, &name);
+        hashes[i] = njs_djb_hash(name.start, name.length);
+    }
+
+    for (i = 1; i < n; i++) {
+        for (j = 0; j < i; j++) {
+            if (hashes[i] == hashes[j]
+                && njs_values_strict_equal(&properties[i].name,
+                                           &properties[j].name))
+            {
+                njs_mp_free(vm->mem_pool, bp);
+                njs_mp_free(vm->mem_pool, properties);
+                njs_mp_free(vm->mem_pool, hashes);
+
+                return NJS_DECLINED;
+            }
+        }
+    }
+
+    bp->properties = properties;
+    bp->hashes = hashes;
+    bp->items = n;
 
-    /* Initialize object. */
-    return njs_generator(vm, generator, node->left);
+    *boilerplate = bp;
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_generate_object_slots(njs_vm_t *vm, njs_generator_t *generator,
+    njs_parser_node_t *object, njs_parser_node_t *stmt, njs_uint_t *slot)
+{
+    njs_int_t               ret;
+    njs_parser_node_t       *expr;
+    njs_vmcode_prop_slot_t  *prop_slot;
+
+    if (stmt == NULL) {
+        return NJS_OK;
+    }
+
+    /* The statements are chained in the reverse order. */
+
+    ret = njs_generate_object_slots(vm, generator, object, stmt->left, slot);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
+
+    expr = stmt->right->right;
+
+    if (expr->token >= NJS_TOKEN_FIRST_CONST
+        && expr->token <= NJS_TOKEN_LAST_CONST)
+    {
+        (*slot)++;
+        return NJS_OK;
+    }
+
+    ret = njs_generator(vm, generator, expr);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
+
+    njs_generate_code(generator, njs_vmcode_prop_slot_t, prop_slot,
+                      NJS_VMCODE_PROPERTY_SLOT, 2);
+    prop_slot->value = expr->index;
+    prop_slot->object = object->index;
+    prop_slot->slot = (*slot)++;
+
+    return njs_generate_node_index_release(vm, generator, expr);
 }
 
 
@@ -1921,6 +2106,8 @@ static njs_int_t
 njs_generate_array(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
 {
+    njs_int_t           ret;
+    njs_value_t         *items;
     njs_vmcode_array_t  *array;
 
     node->index = njs_generate_object_dest_index(vm, generator, node);
@@ -1928,14 +2115,115 @@ njs_generate_array(njs_vm_t *vm, njs_generator_t *generator,
         return NJS_ERROR;
     }
 
+    ret = njs_generate_array_items(vm, node, &items);
+    if (njs_slow_path(ret == NJS_ERROR)) {
+        return NJS_ERROR;
+    }
+
     njs_generate_code(generator, njs_vmcode_array_t, array,
                       NJS_VMCODE_ARRAY, 1);
     array->ctor = node->ctor;
     array->retval = node->index;
     array->length = node->u.length;
+    array->items = items;
 
-    /* Initialize array. */
-    return njs_generator(vm, generator, node->left);
+    if (items == NULL) {
+        /* Initialize array. */
+        return njs_generator(vm, generator, node->left);
+    }
+
+    return njs_generate_array_slots(vm, generator, node->left);
+}
+
+
+/*
+ * Constant elements of an array literal are copied from a prebuilt
+ * items template, only the rest is initialized element by element.
+ */
+
+static njs_int_t
+njs_generate_array_items(njs_vm_t *vm, njs_parser_node_t *node,
+    njs_value_t **items)
+{
+    uint32_t           index, length;
+    njs_bool_t         constant;
+    njs_value_t        *start;
+    njs_parser_node_t  *stmt, *value;
+
+    *items = NULL;
+
+    constant = 0;
+
+    for (stmt = node->left; stmt != NULL; stmt = stmt->left) {
+        if (stmt->right->right->token >= NJS_TOKEN_FIRST_CONST
+            && stmt->right->right->token <= NJS_TOKEN_LAST_CONST)
+        {
+            constant = 1;
+            break;
+        }
+    }
+
+    if (!constant) {
+        return NJS_DECLINED;
+    }
+
+    length = node->u.length;
+
+    start = njs_mp_align(vm->mem_pool, sizeof(njs_value_t),
+                         length * sizeof(njs_value_t));
+    if (njs_slow_path(start == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    for (index = 0; index < length; index++) {
+        njs_set_invalid(&start[index]);
+    }
+
+    for (stmt = node->left; stmt != NULL; stmt = stmt->left) {
+        value = stmt->right->right;
+
+        if (value->token >= NJS_TOKEN_FIRST_CONST
+            && value->token <= NJS_TOKEN_LAST_CONST)
+        {
+            index = njs_number(&stmt->right->left->right->u.value);
+            start[index] = value->u.value;
+        }
+    }
+
+    *items = start;
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_generate_array_slots(njs_vm_t *vm, njs_generator_t *generator,
+    njs_parser_node_t *stmt)
+{
+    njs_int_t  ret;
+
+    if (stmt == NULL) {
+        return NJS_OK;
+    }
+
+    ret = njs_generate_array_slots(vm, generator, stmt->left);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
+
+    if (stmt->right->right->token >= NJS_TOKEN_FIRST_CONST
+        && stmt->right->right->token <= NJS_TOKEN_LAST_CONST)
+    {
+        return NJS_OK;
+    }
+
+    ret = njs_generator(vm, generator, stmt->right);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
+
+    return njs_generate_node_index_release(vm, generator, stmt->right);
 }
 
 
@@ -2003,23 +2291,126 @@ njs_generate_regexp(njs_vm_t *vm, njs_generator_t *generator,
 }
 
 
+/*
+ * The parts of a template literal are passed to the TEMPLATE LITERAL
+ * instruction as trailing operands, empty strings are omitted.
+ */
+
 static njs_int_t
 njs_generate_template_literal(njs_vm_t *vm, njs_generator_t *generator,
     njs_parser_node_t *node)
 {
+    size_t                         size;
     njs_int_t                      ret;
+    njs_uint_t                     i, n, last;
+    njs_index_t                    index, *operands;
+    njs_parser_node_t              *stmt, *part, **start, **parts;
+    njs_vmcode_move_t              *move;
     njs_vmcode_template_literal_t  *code;
 
-    ret = njs_generator(vm, generator, node->left);
-    if (njs_slow_path(ret != NJS_OK)) {
-        return ret;
+    n = node->left->u.length;
+
+    start = njs_mp_alloc(vm->mem_pool, n * sizeof(njs_parser_node_t *));
+    if (njs_slow_path(start == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
     }
 
-    njs_generate_code(generator, njs_vmcode_template_literal_t, code,
-                      NJS_VMCODE_TEMPLATE_LITERAL, 1);
-    code->retval = node->left->index;
+    /* The array items are linked in the reverse order. */
+
+    i = n;
+
+    for (stmt = node->left->left; stmt != NULL; stmt = stmt->left) {
+        part = stmt->right->right;
+
+        if (part->token == NJS_TOKEN_STRING
+            && part->u.value.short_string.size == 0)
+        {
+            n--;
+            continue;
+        }
+
+        start[--i] = part;
+    }
+
+    parts = &start[i];
+
+    if (n == 1 && parts[0]->token == NJS_TOKEN_STRING) {
+        ret = njs_generator(vm, generator, parts[0]);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
+
+        node->index = parts[0]->index;
+
+        goto done;
+    }
+
+    last = 0;
+
+    for (i = 0; i < n; i++) {
+        if (njs_parser_has_side_effect(parts[i])) {
+            last = i;
+        }
+    }
+
+    for (i = 0; i < n; i++) {
+        part = parts[i];
+
+        ret = njs_generator(vm, generator, part);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
+
+        if (part->token == NJS_TOKEN_NAME && i < last) {
+            njs_generate_code(generator, njs_vmcode_move_t, move,
+                              NJS_VMCODE_MOVE, 2);
+            move->src = part->index;
+
+            index = njs_generate_node_temp_index_get(vm, generator, part);
+            if (njs_slow_path(index == NJS_INDEX_ERROR)) {
+                return NJS_ERROR;
+            }
+
+            move->dst = index;
+        }
+    }
+
+    size = sizeof(njs_vmcode_template_literal_t) + n * sizeof(njs_index_t);
+
+    code = (njs_vmcode_template_literal_t *) njs_generate_reserve(vm, generator,
+                                                                  size);
+    if (njs_slow_path(code == NULL)) {
+        return NJS_ERROR;
+    }
+
+    generator->code_end += size;
+
+    code->code.operation = NJS_VMCODE_TEMPLATE_LITERAL;
+    code->code.operands = NJS_VMCODE_1OPERAND;
+    code->nparts = n;
+
+    operands = njs_vmcode_template_literal_parts(code);
+
+    for (i = 0; i < n; i++) {
+        operands[i] = parts[i]->index;
+
+        ret = njs_generate_node_index_release(vm, generator, parts[i]);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
+    }
+
+    node->index = njs_generate_dest_index(vm, generator, node);
+    if (njs_slow_path(node->index == NJS_INDEX_ERROR)) {
+        return NJS_ERROR;
+    }
+
+    code->retval = node->index;
+
+done:
 
-    node->index = node->left->index;
+    njs_mp_free(vm->mem_pool, start);
 
     return NJS_OK;
 }
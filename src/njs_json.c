@@ -7,6 +7,38 @@
 
 #include <njs_main.h>
 
+#if (NJS_HAVE_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if (NJS_HAVE_AVX2)
+#include <immintrin.h>
+#endif
+
+#if (NJS_HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
+
+/*
+ * Property names are interned, so records with the same keys share
+ * the name strings and their hashes.
+ */
+
+#define NJS_JSON_KEYS          256
+
+
+typedef struct {
+    njs_value_t                name;
+    uint32_t                   hash;
+} njs_json_key_t;
+
+
+typedef struct {
+    uint64_t                   interned[NJS_JSON_KEYS / 64];
+    njs_json_key_t             keys[NJS_JSON_KEYS];
+} njs_json_keys_t;
+
 
 typedef struct {
     njs_vm_t                   *vm;
@@ -14,9 +46,55 @@ typedef struct {
     njs_uint_t                 depth;
     const u_char               *start;
     const u_char               *end;
+    njs_json_keys_t            *keys;
 } njs_json_parse_ctx_t;
 
 
+/*
+ * The structural index is built lazily by 64-byte blocks and consumed
+ * by the second stage in the document order, so only a window of the
+ * index is kept.
+ */
+
+#define NJS_JSON_INDEX_SIZE    1024
+
+/* The flag of the ending quote mark of a string with escapes. */
+#define NJS_JSON_INDEX_ESCAPE  0x80000000
+
+
+typedef struct {
+    uint64_t                   quote;
+    uint64_t                   backslash;
+    uint64_t                   structural;
+    uint64_t                   space;
+    uint64_t                   control;
+} njs_json_block_t;
+
+
+typedef struct {
+    njs_json_parse_ctx_t       *ctx;
+
+    /* The first unindexed byte. */
+    const u_char               *pos;
+
+    /* The first byte of the next block is escaped. */
+    uint64_t                   escaped;
+    /* All ones if the next block starts inside a string. */
+    uint64_t                   string;
+    /* The next block starts inside a literal. */
+    uint64_t                   literal;
+
+    /* The string continued in the next block has escapes. */
+    uint8_t                    escape;        /* 1 bit */
+    uint8_t                    invalid;       /* 1 bit */
+    uint8_t                    error;         /* 1 bit */
+
+    njs_uint_t                 head;
+    njs_uint_t                 tail;
+    uint32_t                   index[NJS_JSON_INDEX_SIZE];
+} njs_json_index_t;
+
+
 typedef struct {
     njs_value_t                value;
 
@@ -59,6 +137,71 @@ typedef struct {
 } njs_json_stringify_t;
 
 
+#define NJS_JSON_FAST_NODE_MIN  1024
+#define NJS_JSON_FAST_NODE_MAX  (64 * 1024)
+
+
+typedef struct {
+    njs_vm_t                   *vm;
+    njs_chb_t                  chain;
+    njs_uint_t                 depth;
+
+    /* The size of the chain nodes. */
+    size_t                     reserved;
+
+    /* The difference of the output size and length. */
+    size_t                     surplus;
+
+    /* A byte string is written. */
+    njs_bool_t                 bytes;
+} njs_json_stringify_fast_t;
+
+
+/*
+ * The streaming parser splits the input into values by tracking only
+ * the nesting and the strings.  A complete value is parsed where it
+ * lies, only a value split between chunks is copied to the buffer, so
+ * the memory used is bounded by the largest value.
+ */
+
+typedef enum {
+    /* Values separated by whitespace. */
+    NJS_JSON_STREAM_VALUE = 0,
+
+    /* Elements of the top-level array. */
+    NJS_JSON_STREAM_ARRAY,
+    NJS_JSON_STREAM_FIRST,
+    NJS_JSON_STREAM_ELEMENT,
+    NJS_JSON_STREAM_NEXT,
+    NJS_JSON_STREAM_END,
+
+    /* Inside an array, an object or a string. */
+    NJS_JSON_STREAM_NESTED,
+    /* Inside a number or a literal name. */
+    NJS_JSON_STREAM_LITERAL,
+
+    NJS_JSON_STREAM_CLOSED,
+} njs_json_stream_state_t;
+
+
+typedef struct {
+    njs_json_stream_state_t    state;
+
+    njs_uint_t                 depth;
+    uint8_t                    elements;      /* 1 bit */
+    uint8_t                    string;        /* 1 bit */
+    uint8_t                    escape;        /* 1 bit */
+
+    /* The beginning of the value continued in the next chunk. */
+    u_char                     *buf;
+    size_t                     size;
+    size_t                     capacity;
+
+    /* The property names are interned across the values. */
+    njs_json_keys_t            keys;
+} njs_json_stream_t;
+
+
 static const u_char *njs_json_parse_value(njs_json_parse_ctx_t *ctx,
     njs_value_t *value, const u_char *p);
 static const u_char *njs_json_parse_object(njs_json_parse_ctx_t *ctx,
@@ -72,6 +215,36 @@ static const u_char *njs_json_parse_number(njs_json_parse_ctx_t *ctx,
 njs_inline uint32_t njs_json_unicode(const u_char *p);
 static const u_char *njs_json_skip_space(const u_char *start,
     const u_char *end);
+static njs_int_t njs_json_object_add(njs_json_parse_ctx_t *ctx,
+    njs_object_t *object, njs_value_t *name, uint32_t hash,
+    njs_value_t *value);
+
+static njs_int_t njs_json_parse_text(njs_json_parse_ctx_t *ctx,
+    njs_value_t *value);
+static njs_int_t njs_json_index_parse(njs_json_parse_ctx_t *ctx,
+    njs_value_t *value);
+static const u_char *njs_json_index_parse_value(njs_json_index_t *idx,
+    njs_value_t *value);
+static const u_char *njs_json_index_parse_object(njs_json_index_t *idx,
+    njs_value_t *value, const u_char *p);
+static const u_char *njs_json_index_parse_array(njs_json_index_t *idx,
+    njs_value_t *value, const u_char *p);
+static const u_char *njs_json_index_parse_string(njs_json_index_t *idx,
+    njs_value_t *value, const u_char *p);
+static const u_char *njs_json_index_parse_key(njs_json_index_t *idx,
+    njs_value_t *name, uint32_t *hash, const u_char *p);
+static void njs_json_index_refill(njs_json_index_t *idx);
+static void njs_json_block_resolve(const u_char *p, njs_json_block_t *block);
+static void njs_json_block_scalar(const u_char *p, njs_json_block_t *block);
+#if (NJS_HAVE_SSE2)
+static void njs_json_block_sse2(const u_char *p, njs_json_block_t *block);
+#endif
+#if (NJS_HAVE_AVX2)
+static void njs_json_block_avx2(const u_char *p, njs_json_block_t *block);
+#endif
+#if (NJS_HAVE_NEON)
+static void njs_json_block_neon(const u_char *p, njs_json_block_t *block);
+#endif
 
 static njs_int_t njs_json_parse_iterator(njs_vm_t *vm, njs_json_parse_t *parse,
     njs_value_t *value);
@@ -82,6 +255,15 @@ static void njs_json_parse_exception(njs_json_parse_ctx_t *ctx,
 
 static njs_int_t njs_json_stringify_iterator(njs_vm_t *vm,
     njs_json_stringify_t *stringify, njs_value_t *value);
+static njs_int_t njs_json_stringify_fast(njs_vm_t *vm,
+    const njs_value_t *value);
+static njs_bool_t njs_json_to_json_defined(njs_object_t *object);
+static njs_int_t njs_json_fast_value(njs_json_stringify_fast_t *fast,
+    const njs_value_t *value);
+static njs_int_t njs_json_fast_object(njs_json_stringify_fast_t *fast,
+    njs_object_t *object);
+static njs_int_t njs_json_fast_array(njs_json_stringify_fast_t *fast,
+    njs_array_t *array);
 static njs_function_t *njs_object_to_json_function(njs_vm_t *vm,
     njs_value_t *value);
 static njs_int_t njs_json_stringify_to_json(njs_json_stringify_t* stringify,
@@ -102,6 +284,12 @@ static njs_object_t *njs_json_wrap_value(njs_vm_t *vm, njs_value_t *wrapper,
 
 static const njs_object_prop_t  njs_json_object_properties[];
 
+static const njs_value_t  njs_json_to_json_string = njs_string("toJSON");
+
+
+static void (*njs_json_block_handler)(const u_char *p,
+    njs_json_block_t *block) = njs_json_block_resolve;
+
 
 static njs_int_t
 njs_json_parse(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
@@ -112,6 +300,7 @@ njs_json_parse(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     const u_char          *p, *end;
     njs_json_parse_t      *parse, json_parse;
     const njs_value_t     *reviver;
+    njs_json_keys_t       keys;
     njs_string_prop_t     string;
     njs_json_parse_ctx_t  ctx;
 
@@ -134,24 +323,15 @@ njs_json_parse(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     ctx.vm = vm;
     ctx.pool = vm->mem_pool;
     ctx.depth = NJS_JSON_MAX_DEPTH;
-    ctx.start = string.start;
+    ctx.start = p;
     ctx.end = end;
+    ctx.keys = &keys;
 
-    p = njs_json_skip_space(p, end);
-    if (njs_slow_path(p == end)) {
-        njs_json_parse_exception(&ctx, "Unexpected end of input", p);
-        return NJS_ERROR;
-    }
-
-    p = njs_json_parse_value(&ctx, &value, p);
-    if (njs_slow_path(p == NULL)) {
-        return NJS_ERROR;
-    }
+    njs_memzero(keys.interned, sizeof(keys.interned));
 
-    p = njs_json_skip_space(p, end);
-    if (njs_slow_path(p != end)) {
-        njs_json_parse_exception(&ctx, "Unexpected token", p);
-        return NJS_ERROR;
+    ret = njs_json_parse_text(&ctx, &value);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
     }
 
     reviver = njs_arg(args, nargs, 2);
@@ -169,6 +349,45 @@ njs_json_parse(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 }
 
 
+static njs_int_t
+njs_json_parse_text(njs_json_parse_ctx_t *ctx, njs_value_t *value)
+{
+    njs_int_t     ret;
+    njs_uint_t    depth;
+    const u_char  *p;
+
+    p = njs_json_skip_space(ctx->start, ctx->end);
+    if (njs_slow_path(p == ctx->end)) {
+        njs_json_parse_exception(ctx, "Unexpected end of input", p);
+        return NJS_ERROR;
+    }
+
+    depth = ctx->depth;
+
+    ret = njs_json_index_parse(ctx, value);
+    if (njs_fast_path(ret != NJS_DECLINED)) {
+        return ret;
+    }
+
+    /* The fallback parser reports the syntax errors. */
+
+    ctx->depth = depth;
+
+    p = njs_json_parse_value(ctx, value, p);
+    if (njs_slow_path(p == NULL)) {
+        return NJS_ERROR;
+    }
+
+    p = njs_json_skip_space(p, ctx->end);
+    if (njs_slow_path(p != ctx->end)) {
+        njs_json_parse_exception(ctx, "Unexpected token", p);
+        return NJS_ERROR;
+    }
+
+    return NJS_OK;
+}
+
+
 njs_int_t
 njs_vm_json_parse(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs)
 {
@@ -187,7 +406,7 @@ njs_json_stringify(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     double                num;
     njs_int_t             i;
     njs_int_t             ret;
-    njs_value_t           *replacer, *space;
+    njs_value_t           *replacer, *space, *value;
     njs_json_stringify_t  *stringify, json_stringify;
 
     stringify = &json_stringify;
@@ -236,7 +455,18 @@ njs_json_stringify(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
         }
     }
 
-    return njs_json_stringify_iterator(vm, stringify, njs_arg(args, nargs, 1));
+    value = njs_arg(args, nargs, 1);
+
+    if (njs_is_undefined(&stringify->replacer)
+        && stringify->space.length == 0)
+    {
+        ret = njs_json_stringify_fast(vm, value);
+        if (ret != NJS_DECLINED) {
+            return ret;
+        }
+    }
+
+    return njs_json_stringify_iterator(vm, stringify, value);
 
 memory_error:
 
@@ -315,11 +545,11 @@ static const u_char *
 njs_json_parse_object(njs_json_parse_ctx_t *ctx, njs_value_t *value,
     const u_char *p)
 {
-    njs_int_t           ret;
-    njs_object_t        *object;
-    njs_value_t         prop_name, prop_value;
-    njs_object_prop_t   *prop;
-    njs_lvlhsh_query_t  lhq;
+    njs_int_t     ret;
+    njs_str_t     name;
+    njs_bool_t    empty;
+    njs_value_t   prop_name, prop_value;
+    njs_object_t  *object;
 
     if (njs_slow_path(--ctx->depth == 0)) {
         njs_json_parse_exception(ctx, "Nested too deep", p);
@@ -331,7 +561,7 @@ njs_json_parse_object(njs_json_parse_ctx_t *ctx, njs_value_t *value,
         goto memory_error;
     }
 
-    prop = NULL;
+    empty = 1;
 
     for ( ;; ) {
         p = njs_json_skip_space(p + 1, ctx->end);
@@ -341,7 +571,7 @@ njs_json_parse_object(njs_json_parse_ctx_t *ctx, njs_value_t *value,
 
         if (*p != '"') {
             if (njs_fast_path(*p == '}')) {
-                if (njs_slow_path(prop != NULL)) {
+                if (njs_slow_path(!empty)) {
                     njs_json_parse_exception(ctx, "Trailing comma", p - 1);
                     return NULL;
                 }
@@ -374,24 +604,17 @@ njs_json_parse_object(njs_json_parse_ctx_t *ctx, njs_value_t *value,
             return NULL;
         }
 
-        prop = njs_object_prop_alloc(ctx->vm, &prop_name, &prop_value, 1);
-        if (njs_slow_path(prop == NULL)) {
-            goto memory_error;
-        }
-
-        njs_string_get(&prop_name, &lhq.key);
-        lhq.key_hash = njs_djb_hash(lhq.key.start, lhq.key.length);
-        lhq.value = prop;
-        lhq.replace = 1;
-        lhq.pool = ctx->pool;
-        lhq.proto = &njs_object_hash_proto;
+        njs_string_get(&prop_name, &name);
 
-        ret = njs_lvlhsh_insert(&object->hash, &lhq);
+        ret = njs_json_object_add(ctx, object, &prop_name,
+                                  njs_djb_hash(name.start, name.length),
+                                  &prop_value);
         if (njs_slow_path(ret != NJS_OK)) {
-            njs_internal_error(ctx->vm, "lvlhsh insert/replace failed");
             return NULL;
         }
 
+        empty = 0;
+
         p = njs_json_skip_space(p, ctx->end);
         if (njs_slow_path(p == ctx->end)) {
             goto error_end;
@@ -514,16 +737,17 @@ error_end:
 }
 
 
+/*
+ * njs_json_string_end() validates a string and returns its ending quote
+ * mark.  The surplus is the difference of the string size in JSON and
+ * the maximum size of the decoded string.
+ */
+
 static const u_char *
-njs_json_parse_string(njs_json_parse_ctx_t *ctx, njs_value_t *value,
-    const u_char *p)
+njs_json_string_end(njs_json_parse_ctx_t *ctx, const u_char *p,
+    size_t *surplus)
 {
-    u_char        ch, *s, *dst;
-    size_t        size, surplus;
-    ssize_t       length;
-    uint32_t      utf, utf_low;
-    njs_int_t     ret;
-    const u_char  *start, *last;
+    u_char  ch;
 
     enum {
         sw_usual = 0,
@@ -534,13 +758,10 @@ njs_json_parse_string(njs_json_parse_ctx_t *ctx, njs_value_t *value,
         sw_encoded4,
     } state;
 
-    start = p + 1;
-
-    dst = NULL;
     state = 0;
-    surplus = 0;
+    *surplus = 0;
 
-    for (p = start; p < ctx->end; p++) {
+    for (p++; p < ctx->end; p++) {
         ch = *p;
 
         switch (state) {
@@ -548,7 +769,7 @@ njs_json_parse_string(njs_json_parse_ctx_t *ctx, njs_value_t *value,
         case sw_usual:
 
             if (ch == '"') {
-                break;
+                return p;
             }
 
             if (ch == '\\') {
@@ -575,7 +796,7 @@ njs_json_parse_string(njs_json_parse_ctx_t *ctx, njs_value_t *value,
             case 't':
             case 'b':
             case 'f':
-                surplus++;
+                (*surplus)++;
                 state = sw_usual;
                 continue;
 
@@ -587,7 +808,7 @@ njs_json_parse_string(njs_json_parse_ctx_t *ctx, njs_value_t *value,
                  * Surrogate pair: 12 bytes "\uXXXX\uXXXX" in JSON
                  * and 3 or 4 bytes in UTF-8.
                  */
-                surplus += 3;
+                *surplus += 3;
                 state = sw_encoded1;
                 continue;
             }
@@ -613,17 +834,33 @@ njs_json_parse_string(njs_json_parse_ctx_t *ctx, njs_value_t *value,
 
             return NULL;
         }
-
-        break;
     }
 
-    if (njs_slow_path(p == ctx->end)) {
-        njs_json_parse_exception(ctx, "Unexpected end of input", p);
+    njs_json_parse_exception(ctx, "Unexpected end of input", p);
+
+    return NULL;
+}
+
+
+static const u_char *
+njs_json_parse_string(njs_json_parse_ctx_t *ctx, njs_value_t *value,
+    const u_char *p)
+{
+    u_char        ch, *s, *dst;
+    size_t        size, surplus;
+    ssize_t       length;
+    uint32_t      utf, utf_low;
+    njs_int_t     ret;
+    const u_char  *start, *last;
+
+    /* Points to the ending quote mark. */
+    last = njs_json_string_end(ctx, p, &surplus);
+    if (njs_slow_path(last == NULL)) {
         return NULL;
     }
 
-    /* Points to the ending quote mark. */
-    last = p;
+    start = p + 1;
+    dst = NULL;
 
     size = last - start - surplus;
 
@@ -814,873 +1051,3132 @@ njs_json_skip_space(const u_char *start, const u_char *end)
 }
 
 
-static njs_json_state_t *
-njs_json_push_parse_state(njs_vm_t *vm, njs_json_parse_t *parse,
-    njs_value_t *value)
+static njs_int_t
+njs_json_object_add(njs_json_parse_ctx_t *ctx, njs_object_t *object,
+    njs_value_t *name, uint32_t hash, njs_value_t *value)
 {
-    njs_json_state_t  *state;
+    njs_int_t           ret;
+    njs_object_prop_t   *prop;
+    njs_lvlhsh_query_t  lhq;
 
-    if (njs_slow_path(parse->depth >= NJS_JSON_MAX_DEPTH)) {
-        njs_type_error(vm, "Nested too deep or a cyclic structure");
-        return NULL;
+    prop = njs_object_prop_alloc(ctx->vm, name, value, 1);
+    if (njs_slow_path(prop == NULL)) {
+        njs_memory_error(ctx->vm);
+        return NJS_ERROR;
     }
 
-    state = &parse->states[parse->depth++];
-    state->value = *value;
-    state->index = 0;
-
-    if (njs_is_array(value)) {
-        state->type = NJS_JSON_ARRAY;
+    njs_string_get(name, &lhq.key);
+    lhq.key_hash = hash;
+    lhq.value = prop;
+    lhq.replace = 1;
+    lhq.pool = ctx->pool;
+    lhq.proto = &njs_object_hash_proto;
 
-    } else {
-        state->type = NJS_JSON_OBJECT;
-        state->prop = NULL;
-        state->keys = njs_value_own_enumerate(vm, value, NJS_ENUM_KEYS,
-                                              NJS_ENUM_STRING, 0);
-        if (state->keys == NULL) {
-            return NULL;
-        }
+    ret = njs_lvlhsh_insert(&object->hash, &lhq);
+    if (njs_slow_path(ret != NJS_OK)) {
+        njs_internal_error(ctx->vm, "lvlhsh insert/replace failed");
+        return NJS_ERROR;
     }
 
-    return state;
+    return NJS_OK;
 }
 
 
-njs_inline njs_json_state_t *
-njs_json_pop_parse_state(njs_json_parse_t *parse)
+/*
+ * The two-stage parser.  The first stage classifies the document
+ * by 64-byte blocks and records the offsets of the tokens: quotes,
+ * structural characters outside of strings and the first bytes of
+ * literals.  So the bytes between the tokens are either whitespaces,
+ * or the rest of a literal, or a string contents.  The second stage
+ * builds the values walking the index.
+ *
+ * The second stage accepts only valid documents, on anything else
+ * NJS_DECLINED is returned and the document is parsed again by the byte
+ * parser which reports the error.  NJS_ERROR is returned if an exception
+ * is already set.
+ */
+
+njs_inline const u_char *
+njs_json_index_peek(njs_json_index_t *idx)
 {
-    if (parse->depth > 1) {
-        parse->depth--;
-        return &parse->states[parse->depth - 1];
+    if (idx->head == idx->tail) {
+        njs_json_index_refill(idx);
+
+        if (idx->head == idx->tail) {
+            return idx->ctx->end;
+        }
     }
 
-    return NULL;
+    return idx->ctx->start + (idx->index[idx->head] & ~NJS_JSON_INDEX_ESCAPE);
 }
 
 
-#define njs_json_is_non_empty(_value)                                         \
-    ((njs_is_object(_value) && !njs_object_hash_is_empty(_value))             \
-     || (njs_is_array(_value) && njs_array_len(_value) != 0))
+njs_inline const u_char *
+njs_json_index_next(njs_json_index_t *idx)
+{
+    const u_char  *t;
+
+    t = njs_json_index_peek(idx);
+
+    if (njs_slow_path(t == idx->ctx->end)) {
+        return NULL;
+    }
+
+    idx->head++;
+
+    return t;
+}
 
 
 static njs_int_t
-njs_json_parse_iterator(njs_vm_t *vm, njs_json_parse_t *parse,
-    njs_value_t *object)
+njs_json_index_parse(njs_json_parse_ctx_t *ctx, njs_value_t *value)
 {
-    njs_int_t           ret;
-    njs_value_t         *key, *value, wrapper;
-    njs_object_t        *obj;
-    njs_json_state_t    *state;
-    njs_object_prop_t   *prop;
-    njs_lvlhsh_query_t  lhq;
+    const u_char      *p;
+    njs_json_index_t  idx;
 
-    obj = njs_json_wrap_value(vm, &wrapper, object);
-    if (njs_slow_path(obj == NULL)) {
-        goto memory_error;
+    if (njs_slow_path((size_t) (ctx->end - ctx->start)
+                      >= NJS_JSON_INDEX_ESCAPE))
+    {
+        return NJS_DECLINED;
     }
 
-    state = njs_json_push_parse_state(vm, parse, &wrapper);
-    if (njs_slow_path(state == NULL)) {
-        goto memory_error;
+    idx.ctx = ctx;
+    idx.pos = ctx->start;
+    idx.escaped = 0;
+    idx.string = 0;
+    idx.literal = 0;
+    idx.escape = 0;
+    idx.invalid = 0;
+    idx.error = 0;
+    idx.head = 0;
+    idx.tail = 0;
+
+    p = njs_json_index_parse_value(&idx, value);
+    if (njs_slow_path(p == NULL)) {
+        return idx.error ? NJS_ERROR : NJS_DECLINED;
     }
 
-    lhq.proto = &njs_object_hash_proto;
+    if (njs_slow_path(njs_json_index_peek(&idx) != ctx->end
+                      || idx.invalid))
+    {
+        return NJS_DECLINED;
+    }
 
-    for ( ;; ) {
+    return NJS_OK;
+}
 
-        switch (state->type) {
-        case NJS_JSON_OBJECT:
-            if (state->index < state->keys->length) {
-                key = &state->keys->start[state->index];
-                njs_string_get(key, &lhq.key);
-                lhq.key_hash = njs_djb_hash(lhq.key.start, lhq.key.length);
 
-                ret = njs_lvlhsh_find(njs_object_hash(&state->value), &lhq);
-                if (njs_slow_path(ret == NJS_DECLINED)) {
-                    state->index++;
-                    break;
-                }
+static const u_char *
+njs_json_index_parse_value(njs_json_index_t *idx, njs_value_t *value)
+{
+    const u_char  *p, *t;
 
-                prop = lhq.value;
+    t = njs_json_index_next(idx);
+    if (njs_slow_path(t == NULL)) {
+        return NULL;
+    }
 
-                if (prop->type == NJS_WHITEOUT) {
-                    state->index++;
-                    break;
-                }
+    switch (*t) {
+    case '{':
+        return njs_json_index_parse_object(idx, value, t);
 
-                state->prop = prop;
+    case '[':
+        return njs_json_index_parse_array(idx, value, t);
 
-                if (njs_json_is_non_empty(&prop->value)) {
-                    state = njs_json_push_parse_state(vm, parse, &prop->value);
-                    if (state == NULL) {
-                        goto memory_error;
-                    }
+    case '"':
+        return njs_json_index_parse_string(idx, value, t);
 
-                    break;
-                }
+    case '}':
+    case ']':
+    case ':':
+    case ',':
+        return NULL;
+    }
 
-            } else {
-                state = njs_json_pop_parse_state(parse);
-                if (state == NULL) {
-                    vm->retval = parse->retval;
-                    return NJS_OK;
-                }
+    p = njs_json_parse_value(idx->ctx, value, t);
+    if (njs_slow_path(p == NULL)) {
+        idx->error = 1;
+        return NULL;
+    }
+
+    /* The literal is followed by a whitespace or by the next token. */
+
+    if (p != idx->ctx->end
+        && *p != ' ' && *p != '\n' && *p != '\t' && *p != '\r'
+        && p != njs_json_index_peek(idx))
+    {
+        return NULL;
+    }
+
+    return p;
+}
+
+
+static const u_char *
+njs_json_index_parse_object(njs_json_index_t *idx, njs_value_t *value,
+    const u_char *p)
+{
+    uint32_t      hash;
+    njs_int_t     ret;
+    njs_value_t   prop_name, prop_value;
+    njs_object_t  *object;
+
+    if (njs_slow_path(--idx->ctx->depth == 0)) {
+        return NULL;
+    }
+
+    object = njs_object_alloc(idx->ctx->vm);
+    if (njs_slow_path(object == NULL)) {
+        idx->error = 1;
+        return NULL;
+    }
+
+    p = njs_json_index_next(idx);
+    if (njs_slow_path(p == NULL)) {
+        return NULL;
+    }
+
+    if (*p != '}') {
+        for ( ;; ) {
+            if (njs_slow_path(*p != '"')) {
+                return NULL;
             }
 
-            ret = njs_json_parse_iterator_call(vm, parse, state);
-            if (njs_slow_path(ret != NJS_OK)) {
-                return ret;
+            p = njs_json_index_parse_key(idx, &prop_name, &hash, p);
+            if (njs_slow_path(p == NULL)) {
+                return NULL;
             }
 
-            break;
+            p = njs_json_index_next(idx);
+            if (njs_slow_path(p == NULL || *p != ':')) {
+                return NULL;
+            }
 
-        case NJS_JSON_ARRAY:
-            if (state->index < njs_array_len(&state->value)) {
-                value = &njs_array_start(&state->value)[state->index];
+            p = njs_json_index_parse_value(idx, &prop_value);
+            if (njs_slow_path(p == NULL)) {
+                return NULL;
+            }
 
-                if (njs_json_is_non_empty(value)) {
-                    state = njs_json_push_parse_state(vm, parse, value);
-                    if (state == NULL) {
-                        goto memory_error;
-                    }
+            ret = njs_json_object_add(idx->ctx, object, &prop_name, hash,
+                                      &prop_value);
+            if (njs_slow_path(ret != NJS_OK)) {
+                idx->error = 1;
+                return NULL;
+            }
+
+            p = njs_json_index_next(idx);
+            if (njs_slow_path(p == NULL)) {
+                return NULL;
+            }
 
+            if (*p != ',') {
+                if (njs_fast_path(*p == '}')) {
                     break;
                 }
 
-            } else {
-                state = njs_json_pop_parse_state(parse);
+                return NULL;
             }
 
-            ret = njs_json_parse_iterator_call(vm, parse, state);
-            if (njs_slow_path(ret != NJS_OK)) {
-                return ret;
+            p = njs_json_index_next(idx);
+            if (njs_slow_path(p == NULL)) {
+                return NULL;
             }
-
-            break;
         }
     }
 
-memory_error:
+    njs_set_object(value, object);
 
-    njs_memory_error(vm);
+    idx->ctx->depth++;
 
-    return NJS_ERROR;
+    return p + 1;
 }
 
 
-static njs_int_t
-njs_json_parse_iterator_call(njs_vm_t *vm, njs_json_parse_t *parse,
-    njs_json_state_t *state)
+static const u_char *
+njs_json_index_parse_array(njs_json_index_t *idx, njs_value_t *value,
+    const u_char *p)
 {
     njs_int_t    ret;
-    njs_value_t  arguments[3], *value;
+    njs_array_t  *array;
+    njs_value_t  element;
 
-    arguments[0] = state->value;
+    if (njs_slow_path(--idx->ctx->depth == 0)) {
+        return NULL;
+    }
 
-    switch (state->type) {
-    case NJS_JSON_OBJECT:
-        arguments[1] = state->keys->start[state->index++];
-        arguments[2] = state->prop->value;
+    array = njs_array_alloc(idx->ctx->vm, 0, 0);
+    if (njs_slow_path(array == NULL)) {
+        idx->error = 1;
+        return NULL;
+    }
 
-        ret = njs_function_apply(vm, parse->function, arguments, 3,
-                                 &parse->retval);
-        if (njs_slow_path(ret != NJS_OK)) {
-            return ret;
-        }
+    p = njs_json_index_peek(idx);
 
-        if (njs_is_undefined(&parse->retval)) {
-            state->prop->type = NJS_WHITEOUT;
+    if (p != idx->ctx->end && *p == ']') {
+        idx->head++;
+        goto done;
+    }
 
-        } else {
-            state->prop->value = parse->retval;
+    for ( ;; ) {
+        p = njs_json_index_parse_value(idx, &element);
+        if (njs_slow_path(p == NULL)) {
+            return NULL;
         }
 
-        break;
-
-    case NJS_JSON_ARRAY:
-        njs_uint32_to_string(&arguments[1], state->index);
-        value = &njs_array_start(&state->value)[state->index++];
-        arguments[2] = *value;
-
-        ret = njs_function_apply(vm, parse->function, arguments, 3,
-                                 &parse->retval);
+        ret = njs_array_add(idx->ctx->vm, array, &element);
         if (njs_slow_path(ret != NJS_OK)) {
-            return ret;
+            idx->error = 1;
+            return NULL;
         }
 
-        *value = parse->retval;
+        p = njs_json_index_next(idx);
+        if (njs_slow_path(p == NULL)) {
+            return NULL;
+        }
 
-        break;
+        if (*p != ',') {
+            if (njs_fast_path(*p == ']')) {
+                break;
+            }
+
+            return NULL;
+        }
     }
 
-    return NJS_OK;
+done:
+
+    njs_set_array(value, array);
+
+    idx->ctx->depth++;
+
+    return p + 1;
 }
 
 
-static void
-njs_json_parse_exception(njs_json_parse_ctx_t *ctx, const char *msg,
-    const u_char *pos)
+static const u_char *
+njs_json_index_parse_string(njs_json_index_t *idx, njs_value_t *value,
+    const u_char *p)
 {
-    ssize_t  length;
+    size_t        size;
+    ssize_t       length;
+    njs_int_t     ret;
+    const u_char  *last;
 
-    length = njs_utf8_length(ctx->start, pos - ctx->start);
+    /* The next token is the ending quote mark. */
+
+    last = njs_json_index_peek(idx);
+    if (njs_slow_path(last == idx->ctx->end)) {
+        return NULL;
+    }
+
+    if (idx->index[idx->head++] & NJS_JSON_INDEX_ESCAPE) {
+        p = njs_json_parse_string(idx->ctx, value, p);
+        if (njs_slow_path(p == NULL)) {
+            idx->error = 1;
+            return NULL;
+        }
+
+        return last + 1;
+    }
+
+    p++;
+    size = last - p;
+
+    length = njs_utf8_length(p, size);
     if (njs_slow_path(length < 0)) {
         length = 0;
     }
 
-    njs_syntax_error(ctx->vm, "%s at position %z", msg, length);
+    ret = njs_string_new(idx->ctx->vm, value, p, size, length);
+    if (njs_slow_path(ret != NJS_OK)) {
+        idx->error = 1;
+        return NULL;
+    }
+
+    return last + 1;
 }
 
 
-static njs_json_state_t *
-njs_json_push_stringify_state(njs_vm_t *vm, njs_json_stringify_t *stringify,
-    const njs_value_t *value)
+static const u_char *
+njs_json_index_parse_key(njs_json_index_t *idx, njs_value_t *name,
+    uint32_t *hash, const u_char *p)
 {
-    njs_json_state_t  *state;
-
-    if (njs_slow_path(stringify->depth >= NJS_JSON_MAX_DEPTH)) {
-        njs_type_error(vm, "Nested too deep or a cyclic structure");
+    size_t           size;
+    ssize_t          length;
+    uint32_t         h;
+    njs_int_t        ret;
+    njs_str_t        str;
+    njs_uint_t       n;
+    const u_char     *last;
+    njs_json_key_t   *key;
+    njs_json_keys_t  *keys;
+
+    last = njs_json_index_peek(idx);
+    if (njs_slow_path(last == idx->ctx->end)) {
         return NULL;
     }
 
-    state = &stringify->states[stringify->depth++];
-    state->value = *value;
-    state->index = 0;
-    state->written = 0;
+    if (idx->index[idx->head] & NJS_JSON_INDEX_ESCAPE) {
+        p = njs_json_index_parse_string(idx, name, p);
+        if (njs_slow_path(p == NULL)) {
+            return NULL;
+        }
 
-    if (njs_is_array(value)) {
-        state->type = NJS_JSON_ARRAY;
+        njs_string_get(name, &str);
+        *hash = njs_djb_hash(str.start, str.length);
 
-    } else {
-        state->type = NJS_JSON_OBJECT;
+        return p;
+    }
 
-        if (njs_is_array(&stringify->replacer)) {
-            state->keys = njs_array(&stringify->replacer);
+    idx->head++;
 
-        } else {
-            state->keys = njs_value_own_enumerate(vm, value, NJS_ENUM_KEYS,
-                                                  stringify->keys_type, 0);
+    p++;
+    size = last - p;
 
-            if (njs_slow_path(state->keys == NULL)) {
-                return NULL;
+    h = njs_djb_hash(p, size);
+    *hash = h;
+
+    keys = idx->ctx->keys;
+
+    n = h & (NJS_JSON_KEYS - 1);
+    key = &keys->keys[n];
+
+    if (keys->interned[n / 64] & ((uint64_t) 1 << (n % 64))) {
+        if (key->hash == h) {
+            njs_string_get(&key->name, &str);
+
+            if (njs_fast_path(str.length == size
+                              && memcmp(str.start, p, size) == 0))
+            {
+                *name = key->name;
+                return last + 1;
             }
         }
+
+    } else {
+        keys->interned[n / 64] |= (uint64_t) 1 << (n % 64);
     }
 
-    return state;
+    length = njs_utf8_length(p, size);
+    if (njs_slow_path(length < 0)) {
+        length = 0;
+    }
+
+    ret = njs_string_new(idx->ctx->vm, name, p, size, length);
+    if (njs_slow_path(ret != NJS_OK)) {
+        idx->error = 1;
+        return NULL;
+    }
+
+    key->name = *name;
+    key->hash = h;
+
+    return last + 1;
 }
 
 
-njs_inline njs_json_state_t *
-njs_json_pop_stringify_state(njs_json_stringify_t *stringify)
+njs_inline uint64_t
+njs_json_prefix_xor(uint64_t x)
 {
-    njs_json_state_t  *state;
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+
+    return x;
+}
 
-    if (stringify->depth > 1) {
-        stringify->depth--;
-        state = &stringify->states[stringify->depth - 1];
-        state->written = 1;
-        return state;
-    }
 
-    return NULL;
-}
+static void
+njs_json_index_refill(njs_json_index_t *idx)
+{
+    u_char            buf[64];
+    size_t            n;
+    uint32_t          offset, entry;
+    uint64_t          bit, backslash, escaped, quote, string, literal,
+                      tokens, from;
+    njs_bool_t        escape;
+    const u_char      *p, *end;
+    njs_json_block_t  block;
 
+    idx->head = 0;
+    idx->tail = 0;
 
-#define njs_json_is_object(value)                                             \
-    (((value)->type == NJS_OBJECT)                                            \
-     || ((value)->type == NJS_OBJECT_SYMBOL)                                  \
-     || ((value)->type == NJS_EXTERNAL)                                       \
-     || ((value)->type == NJS_ARRAY)                                          \
-     || ((value)->type >= NJS_REGEXP))
+    p = idx->pos;
+    end = idx->ctx->end;
 
+    while (p < end && idx->tail <= NJS_JSON_INDEX_SIZE - 64) {
+        offset = p - idx->ctx->start;
+        n = end - p;
 
-#define njs_json_stringify_indent(times)                                      \
-    if (stringify->space.length != 0) {                                       \
-        njs_chb_append(&chain,"\n", 1);                                       \
-        for (i = 0; i < (njs_int_t) (times) - 1; i++) {                       \
-            njs_chb_append_str(&chain, &stringify->space);                    \
-        }                                                                     \
-    }
+        if (n >= 64) {
+            njs_json_block_handler(p, &block);
+            p += 64;
 
-static njs_int_t
-njs_json_stringify_iterator(njs_vm_t *vm, njs_json_stringify_t *stringify,
-    njs_value_t *object)
-{
-    u_char            *p;
-    size_t            size;
-    njs_chb_t         chain;
-    ssize_t           length;
-    njs_int_t         i;
-    njs_int_t         ret;
-    njs_value_t       *key, *value, wrapper;
-    njs_object_t      *obj;
-    njs_json_state_t  *state;
+        } else {
+            memcpy(buf, p, n);
+            njs_memset(buf + n, ' ', 64 - n);
 
-    obj = njs_json_wrap_value(vm, &wrapper, object);
-    if (njs_slow_path(obj == NULL)) {
-        goto memory_error;
-    }
+            njs_json_block_handler(buf, &block);
+            p = end;
+        }
 
-    state = njs_json_push_stringify_state(vm, stringify, &wrapper);
-    if (njs_slow_path(state == NULL)) {
-        goto memory_error;
-    }
+        /*
+         * A backslash escapes the next byte unless it is escaped itself,
+         * the escape of the last byte is carried over to the next block.
+         */
 
-    njs_chb_init(&chain, vm->mem_pool);
+        escaped = idx->escaped;
+        backslash = block.backslash & ~escaped;
+        idx->escaped = 0;
 
-    for ( ;; ) {
-        switch (state->type) {
-        case NJS_JSON_OBJECT:
-            if (state->index == 0) {
-                njs_chb_append_literal(&chain,"{");
-                njs_json_stringify_indent(stringify->depth);
-            }
+        while (backslash != 0) {
+            bit = backslash & -backslash;
 
-            if (state->index >= state->keys->length) {
-                njs_json_stringify_indent(stringify->depth - 1);
-                njs_chb_append_literal(&chain,"}");
+            if (bit == ((uint64_t) 1 << 63)) {
+                idx->escaped = 1;
+            }
 
-                state = njs_json_pop_stringify_state(stringify);
-                if (state == NULL) {
-                    goto done;
-                }
+            escaped |= bit << 1;
+            backslash &= ~(bit | (bit << 1));
+        }
 
-                break;
-            }
+        quote = block.quote & ~escaped;
 
-            value = &stringify->retval;
-            key = &state->keys->start[state->index++];
-            ret = njs_value_property(vm, &state->value, key, value);
-            if (njs_slow_path(ret == NJS_ERROR)) {
-                return ret;
-            }
+        /* The bits from an opening quote to a closing one exclusive. */
 
-            ret = njs_json_stringify_to_json(stringify, state, key, value);
-            if (njs_slow_path(ret != NJS_OK)) {
-                return ret;
-            }
+        string = njs_json_prefix_xor(quote) ^ idx->string;
+        idx->string = (uint64_t) ((int64_t) string >> 63);
 
-            ret = njs_json_stringify_replacer(stringify, state, key, value);
-            if (njs_slow_path(ret != NJS_OK)) {
-                return ret;
-            }
+        if (njs_slow_path((block.control & string) != 0)) {
+            /* The byte parser reports the forbidden character. */
+            idx->invalid = 1;
+            idx->head = 0;
+            idx->tail = 0;
+            idx->pos = end;
+            return;
+        }
 
-            if (njs_is_undefined(value)
-                || njs_is_symbol(value)
-                || njs_is_function(value)
-                || !njs_is_valid(value))
-            {
-                break;
-            }
+        literal = ~(block.space | block.structural | quote | string);
 
-            if (state->written) {
-                njs_chb_append_literal(&chain,",");
-                njs_json_stringify_indent(stringify->depth);
-            }
+        tokens = (block.structural & ~string)
+                 | quote
+                 | (literal & ~((literal << 1) | idx->literal));
 
-            state->written = 1;
-            njs_json_append_string(&chain, key, '\"');
-            njs_chb_append_literal(&chain,":");
-            if (stringify->space.length != 0) {
-                njs_chb_append_literal(&chain," ");
-            }
+        idx->literal = literal >> 63;
 
-            if (njs_json_is_object(value)) {
-                state = njs_json_push_stringify_state(vm, stringify, value);
-                if (njs_slow_path(state == NULL)) {
-                    return NJS_ERROR;
-                }
+        backslash = block.backslash & string;
 
-                break;
+        if (njs_fast_path(backslash == 0 && !idx->escape)) {
+            while (tokens != 0) {
+                entry = offset + njs_trailing_zeros64(tokens);
+                idx->index[idx->tail++] = entry;
+                tokens &= tokens - 1;
             }
 
-            njs_json_append_value(&chain, value);
+            continue;
+        }
 
-            break;
+        /* The ending quote marks of strings with escapes are flagged. */
 
-        case NJS_JSON_ARRAY:
-            if (state->index == 0) {
-                njs_chb_append_literal(&chain,"[");
-                njs_json_stringify_indent(stringify->depth);
-            }
+        from = ~(uint64_t) 0;
+        escape = idx->escape;
 
-            if (state->index >= njs_array_len(&state->value)) {
-                njs_json_stringify_indent(stringify->depth - 1);
-                njs_chb_append_literal(&chain,"]");
+        while (tokens != 0) {
+            bit = tokens & -tokens;
+            entry = offset + njs_trailing_zeros64(tokens);
 
-                state = njs_json_pop_stringify_state(stringify);
-                if (state == NULL) {
-                    goto done;
-                }
+            if (bit & quote) {
+                if (bit & string) {
+                    from = ~((bit << 1) - 1);
+                    escape = 0;
 
-                break;
+                } else if (escape || (backslash & from & (bit - 1)) != 0) {
+                    entry |= NJS_JSON_INDEX_ESCAPE;
+                }
             }
 
-            if (state->written) {
-                njs_chb_append_literal(&chain,",");
-                njs_json_stringify_indent(stringify->depth);
-            }
+            idx->index[idx->tail++] = entry;
+            tokens &= tokens - 1;
+        }
 
-            stringify->retval = njs_array_start(&state->value)[state->index++];
-            value = &stringify->retval;
+        idx->escape = idx->string != 0
+                      && (escape || (backslash & from) != 0);
+    }
 
-            ret = njs_json_stringify_to_json(stringify, state, NULL, value);
-            if (njs_slow_path(ret != NJS_OK)) {
-                return ret;
-            }
+    idx->pos = p;
+}
 
-            ret = njs_json_stringify_replacer(stringify, state, NULL, value);
-            if (njs_slow_path(ret != NJS_OK)) {
-                return ret;
-            }
 
-            if (njs_json_is_object(value)) {
-                state = njs_json_push_stringify_state(vm, stringify, value);
-                if (state == NULL) {
-                    return NJS_ERROR;
-                }
+static void
+njs_json_block_resolve(const u_char *p, njs_json_block_t *block)
+{
+    njs_json_block_handler = njs_json_block_scalar;
 
-                break;
-            }
+#if (NJS_HAVE_SSE2)
+    njs_json_block_handler = njs_json_block_sse2;
+#endif
 
-            state->written = 1;
-            njs_json_append_value(&chain, value);
+#if (NJS_HAVE_AVX2)
+    __builtin_cpu_init();
 
-            break;
-        }
+    if (__builtin_cpu_supports("avx2")) {
+        njs_json_block_handler = njs_json_block_avx2;
     }
+#endif
 
-done:
-
-    /*
-     * The value to stringify is wrapped as '{"": value}'.
-     * Stripping the wrapper's data.
-     */
+#if (NJS_HAVE_NEON)
+    njs_json_block_handler = njs_json_block_neon;
+#endif
 
-    njs_chb_drain(&chain, njs_length("{\"\":"));
-    njs_chb_drop(&chain, njs_length("}"));
+    njs_json_block_handler(p, block);
+}
 
-    if (stringify->space.length != 0) {
-        njs_chb_drain(&chain, njs_length("\n "));
-        njs_chb_drop(&chain, njs_length("\n"));
-    }
 
-    size = njs_chb_size(&chain);
-    if (njs_slow_path(size == 0)) {
-        njs_set_undefined(&vm->retval);
-        goto release;
-    }
+static void
+njs_json_block_scalar(const u_char *p, njs_json_block_t *block)
+{
+    u_char      c;
+    uint64_t    bit;
+    njs_uint_t  i;
 
-    length = njs_chb_utf8_length(&chain);
-    if (njs_slow_path(length < 0)) {
-        length = 0;
-    }
+    njs_memzero(block, sizeof(njs_json_block_t));
 
-    p = njs_string_alloc(vm, &vm->retval, size, length);
-    if (njs_slow_path(p == NULL)) {
-        goto memory_error;
-    }
+    for (i = 0; i < 64; i++) {
+        c = p[i];
+        bit = (uint64_t) 1 << i;
 
-    njs_chb_join_to(&chain, p);
+        switch (c) {
+        case '"':
+            block->quote |= bit;
+            break;
 
-release:
+        case '\\':
+            block->backslash |= bit;
+            break;
 
-    njs_chb_destroy(&chain);
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+            block->structural |= bit;
+            break;
 
-    return NJS_OK;
+        case ' ':
+            block->space |= bit;
+            break;
 
-memory_error:
+        case '\t':
+        case '\n':
+        case '\r':
+            block->space |= bit;
 
-    njs_memory_error(vm);
+            /* Fall through. */
 
-    return NJS_ERROR;
+        default:
+            if (c < ' ') {
+                block->control |= bit;
+            }
+        }
+    }
 }
 
 
-static njs_function_t *
-njs_object_to_json_function(njs_vm_t *vm, njs_value_t *value)
-{
-    njs_int_t           ret;
-    njs_value_t         retval;
-    njs_lvlhsh_query_t  lhq;
-
-    static const njs_value_t  to_json_string = njs_string("toJSON");
+/*
+ * The vector classifiers match the brackets and braces with one
+ * comparison each: "[" and "]" differ from "{" and "}" only by 0x20.
+ */
 
-    njs_object_property_init(&lhq, &to_json_string, NJS_TO_JSON_HASH);
+#if (NJS_HAVE_SSE2)
 
-    ret = njs_object_property(vm, value, &lhq, &retval);
+static void
+njs_json_block_sse2(const u_char *p, njs_json_block_t *block)
+{
+    uint64_t    quote, backslash, structural, space, control;
+    __m128i     v, b;
+    njs_uint_t  i;
 
-    if (njs_slow_path(ret == NJS_ERROR)) {
-        return NULL;
+    quote = 0;
+    backslash = 0;
+    structural = 0;
+    space = 0;
+    control = 0;
+
+    for (i = 0; i < 64; i += 16) {
+        v = _mm_loadu_si128((const __m128i *) (p + i));
+        b = _mm_or_si128(v, _mm_set1_epi8(0x20));
+
+        quote |= (uint64_t) _mm_movemask_epi8(
+                                 _mm_cmpeq_epi8(v, _mm_set1_epi8('"'))) << i;
+
+        backslash |= (uint64_t) _mm_movemask_epi8(
+                                 _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))) << i;
+
+        structural |= (uint64_t) _mm_movemask_epi8(
+                  _mm_or_si128(
+                      _mm_or_si128(_mm_cmpeq_epi8(b, _mm_set1_epi8('{')),
+                                   _mm_cmpeq_epi8(b, _mm_set1_epi8('}'))),
+                      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')),
+                                   _mm_cmpeq_epi8(v, _mm_set1_epi8(','))))) << i;
+
+        space |= (uint64_t) _mm_movemask_epi8(
+                  _mm_or_si128(
+                      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                   _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                                   _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))))) << i;
+
+        control |= (uint64_t) _mm_movemask_epi8(
+                  _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1f)), v)) << i;
     }
 
-    return njs_is_function(&retval) ? njs_function(&retval) : NULL;
+    block->quote = quote;
+    block->backslash = backslash;
+    block->structural = structural;
+    block->space = space;
+    block->control = control;
 }
 
+#endif
 
-static njs_int_t
-njs_json_stringify_to_json(njs_json_stringify_t* stringify,
-    njs_json_state_t *state, njs_value_t *key, njs_value_t *value)
+
+#if (NJS_HAVE_AVX2)
+
+__attribute__((target("avx2")))
+static void
+njs_json_block_avx2(const u_char *p, njs_json_block_t *block)
 {
-    njs_value_t     arguments[2];
-    njs_function_t  *to_json;
+    uint64_t    quote, backslash, structural, space, control;
+    __m256i     v, b;
+    njs_uint_t  i;
 
-    if (!njs_is_object(value)) {
-        return NJS_OK;
+    quote = 0;
+    backslash = 0;
+    structural = 0;
+    space = 0;
+    control = 0;
+
+    for (i = 0; i < 64; i += 32) {
+        v = _mm256_loadu_si256((const __m256i *) (p + i));
+        b = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+
+        quote |= (uint64_t) (uint32_t) _mm256_movemask_epi8(
+                           _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'))) << i;
+
+        backslash |= (uint64_t) (uint32_t) _mm256_movemask_epi8(
+                           _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))) << i;
+
+        structural |= (uint64_t) (uint32_t) _mm256_movemask_epi8(
+            _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(b, _mm256_set1_epi8('{')),
+                                _mm256_cmpeq_epi8(b, _mm256_set1_epi8('}'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')))))
+            << i;
+
+        space |= (uint64_t) (uint32_t) _mm256_movemask_epi8(
+            _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')))))
+            << i;
+
+        control |= (uint64_t) (uint32_t) _mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1f)), v))
+            << i;
     }
 
-    to_json = njs_object_to_json_function(stringify->vm, value);
+    block->quote = quote;
+    block->backslash = backslash;
+    block->structural = structural;
+    block->space = space;
+    block->control = control;
 
-    if (to_json == NULL) {
-        return NJS_OK;
-    }
+    _mm256_zeroupper();
+}
 
-    arguments[0] = *value;
+#endif
 
-    switch (state->type) {
-    case NJS_JSON_OBJECT:
-        if (key != NULL) {
-            arguments[1] = *key;
 
-        } else {
-            njs_string_short_set(&arguments[1], 0, 0);
-        }
+#if (NJS_HAVE_NEON)
 
-        break;
+njs_inline uint64_t
+njs_json_neon_mask(const uint8x16_t *m)
+{
+    uint8x16_t  bits, sum0, sum1;
 
-    case NJS_JSON_ARRAY:
-        njs_uint32_to_string(&arguments[1], state->index - 1);
+    static const uint8_t  weights[16] = {
+        1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+    };
 
-        break;
-    }
+    /* Each byte of the four masks is narrowed to a bit. */
 
-    return njs_function_apply(stringify->vm, to_json, arguments, 2,
-                              &stringify->retval);
+    bits = vld1q_u8(weights);
+
+    sum0 = vpaddq_u8(vandq_u8(m[0], bits), vandq_u8(m[1], bits));
+    sum1 = vpaddq_u8(vandq_u8(m[2], bits), vandq_u8(m[3], bits));
+    sum0 = vpaddq_u8(sum0, sum1);
+    sum0 = vpaddq_u8(sum0, sum0);
+
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
 }
 
 
-static njs_int_t
-njs_json_stringify_replacer(njs_json_stringify_t* stringify,
-    njs_json_state_t *state, njs_value_t *key, njs_value_t *value)
+static void
+njs_json_block_neon(const u_char *p, njs_json_block_t *block)
 {
-    njs_value_t  arguments[3];
-
-    if (!njs_is_function(&stringify->replacer)) {
-        return NJS_OK;
-    }
+    uint8x16_t  v, b, quote[4], backslash[4], structural[4], space[4],
+                control[4];
+    njs_uint_t  i;
 
-    arguments[0] = state->value;
+    for (i = 0; i < 4; i++) {
+        v = vld1q_u8(p + i * 16);
+        b = vorrq_u8(v, vdupq_n_u8(0x20));
 
-    switch (state->type) {
-    case NJS_JSON_OBJECT:
-        arguments[1] = *key;
-        arguments[2] = *value;
+        quote[i] = vceqq_u8(v, vdupq_n_u8('"'));
+        backslash[i] = vceqq_u8(v, vdupq_n_u8('\\'));
 
-        break;
+        structural[i] = vorrq_u8(vorrq_u8(vceqq_u8(b, vdupq_n_u8('{')),
+                                          vceqq_u8(b, vdupq_n_u8('}'))),
+                                 vorrq_u8(vceqq_u8(v, vdupq_n_u8(':')),
+                                          vceqq_u8(v, vdupq_n_u8(','))));
 
-    case NJS_JSON_ARRAY:
-        njs_uint32_to_string(&arguments[1], state->index - 1);
-        arguments[2] = *value;
+        space[i] = vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')),
+                                     vceqq_u8(v, vdupq_n_u8('\t'))),
+                            vorrq_u8(vceqq_u8(v, vdupq_n_u8('\n')),
+                                     vceqq_u8(v, vdupq_n_u8('\r'))));
 
-        break;
+        control[i] = vcltq_u8(v, vdupq_n_u8(' '));
     }
 
-    return njs_function_apply(stringify->vm, njs_function(&stringify->replacer),
-                              arguments, 3, &stringify->retval);
+    block->quote = njs_json_neon_mask(quote);
+    block->backslash = njs_json_neon_mask(backslash);
+    block->structural = njs_json_neon_mask(structural);
+    block->space = njs_json_neon_mask(space);
+    block->control = njs_json_neon_mask(control);
 }
 
+#endif
 
-static njs_int_t
-njs_json_stringify_array(njs_vm_t *vm, njs_json_stringify_t  *stringify)
-{
-    njs_int_t    ret;
-    uint32_t     i, n, k, properties_length, array_length;
-    njs_value_t  *value, num_value;
-    njs_array_t  *properties, *array;
 
-    properties_length = 1;
-    array = njs_array(&stringify->replacer);
-    array_length = array->length;
+static njs_json_state_t *
+njs_json_push_parse_state(njs_vm_t *vm, njs_json_parse_t *parse,
+    njs_value_t *value)
+{
+    njs_json_state_t  *state;
+
+    if (njs_slow_path(parse->depth >= NJS_JSON_MAX_DEPTH)) {
+        njs_type_error(vm, "Nested too deep or a cyclic structure");
+        return NULL;
+    }
+
+    state = &parse->states[parse->depth++];
+    state->value = *value;
+    state->index = 0;
+
+    if (njs_is_array(value)) {
+        state->type = NJS_JSON_ARRAY;
+
+    } else {
+        state->type = NJS_JSON_OBJECT;
+        state->prop = NULL;
+        state->keys = njs_value_own_enumerate(vm, value, NJS_ENUM_KEYS,
+                                              NJS_ENUM_STRING, 0);
+        if (state->keys == NULL) {
+            return NULL;
+        }
+    }
+
+    return state;
+}
+
+
+njs_inline njs_json_state_t *
+njs_json_pop_parse_state(njs_json_parse_t *parse)
+{
+    if (parse->depth > 1) {
+        parse->depth--;
+        return &parse->states[parse->depth - 1];
+    }
+
+    return NULL;
+}
+
+
+#define njs_json_is_non_empty(_value)                                         \
+    ((njs_is_object(_value) && !njs_object_hash_is_empty(_value))             \
+     || (njs_is_array(_value) && njs_array_len(_value) != 0))
+
+
+static njs_int_t
+njs_json_parse_iterator(njs_vm_t *vm, njs_json_parse_t *parse,
+    njs_value_t *object)
+{
+    njs_int_t           ret;
+    njs_value_t         *key, *value, wrapper;
+    njs_object_t        *obj;
+    njs_json_state_t    *state;
+    njs_object_prop_t   *prop;
+    njs_lvlhsh_query_t  lhq;
+
+    obj = njs_json_wrap_value(vm, &wrapper, object);
+    if (njs_slow_path(obj == NULL)) {
+        goto memory_error;
+    }
+
+    state = njs_json_push_parse_state(vm, parse, &wrapper);
+    if (njs_slow_path(state == NULL)) {
+        goto memory_error;
+    }
+
+    lhq.proto = &njs_object_hash_proto;
+
+    for ( ;; ) {
+
+        switch (state->type) {
+        case NJS_JSON_OBJECT:
+            if (state->index < state->keys->length) {
+                key = &state->keys->start[state->index];
+                njs_string_get(key, &lhq.key);
+                lhq.key_hash = njs_djb_hash(lhq.key.start, lhq.key.length);
+
+                ret = njs_lvlhsh_find(njs_object_hash(&state->value), &lhq);
+                if (njs_slow_path(ret == NJS_DECLINED)) {
+                    state->index++;
+                    break;
+                }
+
+                prop = lhq.value;
+
+                if (prop->type == NJS_WHITEOUT) {
+                    state->index++;
+                    break;
+                }
+
+                state->prop = prop;
+
+                if (njs_json_is_non_empty(&prop->value)) {
+                    state = njs_json_push_parse_state(vm, parse, &prop->value);
+                    if (state == NULL) {
+                        goto memory_error;
+                    }
+
+                    break;
+                }
+
+            } else {
+                state = njs_json_pop_parse_state(parse);
+                if (state == NULL) {
+                    vm->retval = parse->retval;
+                    return NJS_OK;
+                }
+            }
+
+            ret = njs_json_parse_iterator_call(vm, parse, state);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return ret;
+            }
+
+            break;
+
+        case NJS_JSON_ARRAY:
+            if (state->index < njs_array_len(&state->value)) {
+                value = &njs_array_start(&state->value)[state->index];
+
+                if (njs_json_is_non_empty(value)) {
+                    state = njs_json_push_parse_state(vm, parse, value);
+                    if (state == NULL) {
+                        goto memory_error;
+                    }
+
+                    break;
+                }
+
+            } else {
+                state = njs_json_pop_parse_state(parse);
+            }
+
+            ret = njs_json_parse_iterator_call(vm, parse, state);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return ret;
+            }
+
+            break;
+        }
+    }
+
+memory_error:
+
+    njs_memory_error(vm);
+
+    return NJS_ERROR;
+}
+
+
+static njs_int_t
+njs_json_parse_iterator_call(njs_vm_t *vm, njs_json_parse_t *parse,
+    njs_json_state_t *state)
+{
+    njs_int_t    ret;
+    njs_value_t  arguments[3], *value;
+
+    arguments[0] = state->value;
+
+    switch (state->type) {
+    case NJS_JSON_OBJECT:
+        arguments[1] = state->keys->start[state->index++];
+        arguments[2] = state->prop->value;
+
+        ret = njs_function_apply(vm, parse->function, arguments, 3,
+                                 &parse->retval);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
+
+        if (njs_is_undefined(&parse->retval)) {
+            state->prop->type = NJS_WHITEOUT;
+            njs_object_enum_cache_invalidate(vm, njs_object(&state->value));
+
+        } else {
+            state->prop->value = parse->retval;
+        }
+
+        break;
+
+    case NJS_JSON_ARRAY:
+        njs_uint32_to_string(&arguments[1], state->index);
+        value = &njs_array_start(&state->value)[state->index++];
+        arguments[2] = *value;
+
+        ret = njs_function_apply(vm, parse->function, arguments, 3,
+                                 &parse->retval);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
+
+        *value = parse->retval;
+
+        break;
+    }
+
+    return NJS_OK;
+}
+
+
+static void
+njs_json_parse_exception(njs_json_parse_ctx_t *ctx, const char *msg,
+    const u_char *pos)
+{
+    ssize_t  length;
+
+    length = njs_utf8_length(ctx->start, pos - ctx->start);
+    if (njs_slow_path(length < 0)) {
+        length = 0;
+    }
+
+    njs_syntax_error(ctx->vm, "%s at position %z", msg, length);
+}
+
+
+static njs_json_state_t *
+njs_json_push_stringify_state(njs_vm_t *vm, njs_json_stringify_t *stringify,
+    const njs_value_t *value)
+{
+    njs_json_state_t  *state;
+
+    if (njs_slow_path(stringify->depth >= NJS_JSON_MAX_DEPTH)) {
+        njs_type_error(vm, "Nested too deep or a cyclic structure");
+        return NULL;
+    }
+
+    state = &stringify->states[stringify->depth++];
+    state->value = *value;
+    state->index = 0;
+    state->written = 0;
+
+    if (njs_is_array(value)) {
+        state->type = NJS_JSON_ARRAY;
+
+    } else {
+        state->type = NJS_JSON_OBJECT;
+
+        if (njs_is_array(&stringify->replacer)) {
+            state->keys = njs_array(&stringify->replacer);
+
+        } else {
+            state->keys = njs_value_own_enumerate(vm, value, NJS_ENUM_KEYS,
+                                                  stringify->keys_type, 0);
+
+            if (njs_slow_path(state->keys == NULL)) {
+                return NULL;
+            }
+        }
+    }
+
+    return state;
+}
+
+
+njs_inline njs_json_state_t *
+njs_json_pop_stringify_state(njs_json_stringify_t *stringify)
+{
+    njs_json_state_t  *state;
+
+    if (stringify->depth > 1) {
+        stringify->depth--;
+        state = &stringify->states[stringify->depth - 1];
+        state->written = 1;
+        return state;
+    }
+
+    return NULL;
+}
+
+
+#define njs_json_is_object(value)                                             \
+    (((value)->type == NJS_OBJECT)                                            \
+     || ((value)->type == NJS_OBJECT_SYMBOL)                                  \
+     || ((value)->type == NJS_EXTERNAL)                                       \
+     || ((value)->type == NJS_ARRAY)                                          \
+     || ((value)->type >= NJS_REGEXP))
+
+
+#define njs_json_stringify_indent(times)                                      \
+    if (stringify->space.length != 0) {                                       \
+        njs_chb_append(&chain,"\n", 1);                                       \
+        for (i = 0; i < (njs_int_t) (times) - 1; i++) {                       \
+            njs_chb_append_str(&chain, &stringify->space);                    \
+        }                                                                     \
+    }
+
+static njs_int_t
+njs_json_stringify_iterator(njs_vm_t *vm, njs_json_stringify_t *stringify,
+    njs_value_t *object)
+{
+    u_char            *p;
+    size_t            size;
+    njs_chb_t         chain;
+    ssize_t           length;
+    njs_int_t         i;
+    njs_int_t         ret;
+    njs_value_t       *key, *value, wrapper;
+    njs_object_t      *obj;
+    njs_json_state_t  *state;
+
+    obj = njs_json_wrap_value(vm, &wrapper, object);
+    if (njs_slow_path(obj == NULL)) {
+        goto memory_error;
+    }
+
+    state = njs_json_push_stringify_state(vm, stringify, &wrapper);
+    if (njs_slow_path(state == NULL)) {
+        goto memory_error;
+    }
+
+    njs_chb_init(&chain, vm->mem_pool);
+
+    for ( ;; ) {
+        switch (state->type) {
+        case NJS_JSON_OBJECT:
+            if (state->index == 0) {
+                njs_chb_append_literal(&chain,"{");
+                njs_json_stringify_indent(stringify->depth);
+            }
+
+            if (state->index >= state->keys->length) {
+                njs_json_stringify_indent(stringify->depth - 1);
+                njs_chb_append_literal(&chain,"}");
+
+                state = njs_json_pop_stringify_state(stringify);
+                if (state == NULL) {
+                    goto done;
+                }
+
+                break;
+            }
+
+            value = &stringify->retval;
+            key = &state->keys->start[state->index++];
+            ret = njs_value_property(vm, &state->value, key, value);
+            if (njs_slow_path(ret == NJS_ERROR)) {
+                return ret;
+            }
+
+            ret = njs_json_stringify_to_json(stringify, state, key, value);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return ret;
+            }
+
+            ret = njs_json_stringify_replacer(stringify, state, key, value);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return ret;
+            }
+
+            if (njs_is_undefined(value)
+                || njs_is_symbol(value)
+                || njs_is_function(value)
+                || !njs_is_valid(value))
+            {
+                break;
+            }
+
+            if (state->written) {
+                njs_chb_append_literal(&chain,",");
+                njs_json_stringify_indent(stringify->depth);
+            }
+
+            state->written = 1;
+            njs_json_append_string(&chain, key, '\"');
+            njs_chb_append_literal(&chain,":");
+            if (stringify->space.length != 0) {
+                njs_chb_append_literal(&chain," ");
+            }
+
+            if (njs_json_is_object(value)) {
+                state = njs_json_push_stringify_state(vm, stringify, value);
+                if (njs_slow_path(state == NULL)) {
+                    return NJS_ERROR;
+                }
+
+                break;
+            }
+
+            njs_json_append_value(&chain, value);
+
+            break;
+
+        case NJS_JSON_ARRAY:
+            if (state->index == 0) {
+                njs_chb_append_literal(&chain,"[");
+                njs_json_stringify_indent(stringify->depth);
+            }
+
+            if (state->index >= njs_array_len(&state->value)) {
+                njs_json_stringify_indent(stringify->depth - 1);
+                njs_chb_append_literal(&chain,"]");
+
+                state = njs_json_pop_stringify_state(stringify);
+                if (state == NULL) {
+                    goto done;
+                }
+
+                break;
+            }
+
+            if (state->written) {
+                njs_chb_append_literal(&chain,",");
+                njs_json_stringify_indent(stringify->depth);
+            }
+
+            stringify->retval = njs_array_start(&state->value)[state->index++];
+            value = &stringify->retval;
+
+            ret = njs_json_stringify_to_json(stringify, state, NULL, value);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return ret;
+            }
+
+            ret = njs_json_stringify_replacer(stringify, state, NULL, value);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return ret;
+            }
+
+            if (njs_json_is_object(value)) {
+                state = njs_json_push_stringify_state(vm, stringify, value);
+                if (state == NULL) {
+                    return NJS_ERROR;
+                }
+
+                break;
+            }
+
+            state->written = 1;
+            njs_json_append_value(&chain, value);
+
+            break;
+        }
+    }
+
+done:
+
+    /*
+     * The value to stringify is wrapped as '{"": value}'.
+     * Stripping the wrapper's data.
+     */
+
+    njs_chb_drain(&chain, njs_length("{\"\":"));
+    njs_chb_drop(&chain, njs_length("}"));
+
+    if (stringify->space.length != 0) {
+        njs_chb_drain(&chain, njs_length("\n "));
+        njs_chb_drop(&chain, njs_length("\n"));
+    }
+
+    size = njs_chb_size(&chain);
+    if (njs_slow_path(size == 0)) {
+        njs_set_undefined(&vm->retval);
+        goto release;
+    }
+
+    length = njs_chb_utf8_length(&chain);
+    if (njs_slow_path(length < 0)) {
+        length = 0;
+    }
+
+    p = njs_string_alloc(vm, &vm->retval, size, length);
+    if (njs_slow_path(p == NULL)) {
+        goto memory_error;
+    }
+
+    njs_chb_join_to(&chain, p);
+
+release:
+
+    njs_chb_destroy(&chain);
+
+    return NJS_OK;
+
+memory_error:
+
+    njs_memory_error(vm);
+
+    return NJS_ERROR;
+}
+
+
+/*
+ * The fast path of JSON.stringify() without a replacer and indentation.
+ * It serializes primitive values, plain objects and arrays while no
+ * toJSON() method can be reached, so the result does not depend on
+ * the order of property reads.  On anything else NJS_DECLINED is returned
+ * before any side effect, and the value is stringified by the generic
+ * iterator.
+ *
+ * The chain nodes are sized by the output written so far, so a large
+ * output occupies a logarithmic number of nodes.
+ */
+
+static njs_int_t
+njs_json_stringify_fast(njs_vm_t *vm, const njs_value_t *value)
+{
+    u_char                     *p;
+    size_t                     size;
+    ssize_t                    length;
+    njs_int_t                  ret;
+    njs_object_t               *object, *array;
+    njs_json_stringify_fast_t  fast;
+
+    object = &vm->prototypes[NJS_OBJ_TYPE_OBJECT].object;
+    array = &vm->prototypes[NJS_OBJ_TYPE_ARRAY].object;
+
+    if (object->__proto__ != NULL
+        || array->__proto__ != object
+        || njs_json_to_json_defined(object)
+        || njs_json_to_json_defined(array))
+    {
+        return NJS_DECLINED;
+    }
+
+    if (njs_is_undefined(value) || njs_is_symbol(value)) {
+        njs_set_undefined(&vm->retval);
+        return NJS_OK;
+    }
+
+    fast.vm = vm;
+    fast.depth = 0;
+    fast.reserved = 0;
+    fast.surplus = 0;
+    fast.bytes = 0;
+
+    njs_chb_init(&fast.chain, vm->mem_pool);
+
+    ret = njs_json_fast_value(&fast, value);
+    if (njs_slow_path(ret != NJS_OK)) {
+        goto release;
+    }
+
+    if (njs_slow_path(fast.chain.error)) {
+        njs_memory_error(vm);
+        ret = NJS_ERROR;
+        goto release;
+    }
+
+    size = njs_chb_size(&fast.chain);
+
+    if (fast.bytes) {
+        length = njs_chb_utf8_length(&fast.chain);
+        if (njs_slow_path(length < 0)) {
+            length = 0;
+        }
+
+    } else {
+        length = size - fast.surplus;
+    }
+
+    p = njs_string_alloc(vm, &vm->retval, size, length);
+    if (njs_slow_path(p == NULL)) {
+        ret = NJS_ERROR;
+        goto release;
+    }
+
+    njs_chb_join_to(&fast.chain, p);
+
+release:
+
+    njs_chb_destroy(&fast.chain);
+
+    return ret;
+}
+
+
+static njs_bool_t
+njs_json_to_json_defined(njs_object_t *object)
+{
+    njs_lvlhsh_query_t  lhq;
+
+    njs_object_property_init(&lhq, &njs_json_to_json_string, NJS_TO_JSON_HASH);
+
+    return (njs_lvlhsh_find(&object->hash, &lhq) == NJS_OK
+            || njs_lvlhsh_find(&object->shared_hash, &lhq) == NJS_OK);
+}
+
+
+njs_inline void
+njs_json_fast_reserve(njs_json_stringify_fast_t *fast, size_t size)
+{
+    size_t          reserve;
+    njs_chb_node_t  *n;
+
+    n = fast->chain.last;
+
+    if (n != NULL && njs_chb_node_room(n) >= size) {
+        return;
+    }
+
+    reserve = njs_max(fast->reserved, NJS_JSON_FAST_NODE_MIN);
+    reserve = njs_min(reserve, NJS_JSON_FAST_NODE_MAX);
+    reserve = njs_max(reserve, size);
+
+    if (njs_chb_reserve(&fast->chain, reserve) != NULL) {
+        fast->reserved += reserve;
+    }
+}
+
+
+static njs_int_t
+njs_json_fast_value(njs_json_stringify_fast_t *fast, const njs_value_t *value)
+{
+    njs_string_prop_t  string;
+
+    switch (value->type) {
+    case NJS_STRING:
+        (void) njs_string_prop(&string, value);
+
+        if (string.length != 0 || string.size == 0) {
+            fast->surplus += string.size - string.length;
+
+        } else {
+            fast->bytes = 1;
+        }
+
+        njs_json_fast_reserve(fast, string.size + 2);
+        njs_json_append_string(&fast->chain, value, '\"');
+
+        return NJS_OK;
+
+    case NJS_NUMBER:
+        njs_json_fast_reserve(fast, 64);
+        njs_json_append_number(&fast->chain, value);
+
+        return NJS_OK;
+
+    case NJS_BOOLEAN:
+    case NJS_NULL:
+    case NJS_UNDEFINED:
+    case NJS_SYMBOL:
+    case NJS_INVALID:
+        njs_json_fast_reserve(fast, njs_length("false"));
+        njs_json_append_value(&fast->chain, value);
+
+        return NJS_OK;
+
+    case NJS_OBJECT:
+        return njs_json_fast_object(fast, njs_object(value));
+
+    case NJS_ARRAY:
+        return njs_json_fast_array(fast, njs_array(value));
+
+    default:
+        return NJS_DECLINED;
+    }
+}
+
+
+static njs_int_t
+njs_json_fast_object(njs_json_stringify_fast_t *fast, njs_object_t *object)
+{
+    njs_int_t          ret;
+    njs_bool_t         written;
+    njs_lvlhsh_each_t  lhe;
+    njs_object_prop_t  *prop;
+
+    if (object->__proto__ != &fast->vm->prototypes[NJS_OBJ_TYPE_OBJECT].object
+        || !njs_lvlhsh_is_empty(&object->shared_hash)
+        || fast->depth == NJS_JSON_MAX_DEPTH - 1)
+    {
+        return NJS_DECLINED;
+    }
+
+    fast->depth++;
+
+    njs_json_fast_reserve(fast, 1);
+    njs_chb_append_literal(&fast->chain, "{");
+
+    written = 0;
+
+    njs_lvlhsh_each_init(&lhe, &njs_object_hash_proto);
+
+    for ( ;; ) {
+        prop = njs_lvlhsh_each(&object->hash, &lhe);
+
+        if (prop == NULL) {
+            break;
+        }
+
+        if (!njs_is_string(&prop->name)) {
+            continue;
+        }
+
+        if (prop->type != NJS_PROPERTY) {
+            if (prop->type == NJS_WHITEOUT) {
+                continue;
+            }
+
+            return NJS_DECLINED;
+        }
+
+        if (njs_slow_path(!njs_is_valid(&prop->value)
+                          || (lhe.key_hash == NJS_TO_JSON_HASH
+                              && njs_string_eq(&prop->name,
+                                               &njs_json_to_json_string))))
+        {
+            return NJS_DECLINED;
+        }
+
+        if (!prop->enumerable
+            || njs_is_undefined(&prop->value)
+            || njs_is_symbol(&prop->value))
+        {
+            continue;
+        }
+
+        if (written) {
+            njs_json_fast_reserve(fast, 1);
+            njs_chb_append_literal(&fast->chain, ",");
+        }
+
+        written = 1;
+
+        ret = njs_json_fast_value(fast, &prop->name);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
+
+        njs_json_fast_reserve(fast, 1);
+        njs_chb_append_literal(&fast->chain, ":");
+
+        ret = njs_json_fast_value(fast, &prop->value);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
+    }
+
+    njs_json_fast_reserve(fast, 1);
+    njs_chb_append_literal(&fast->chain, "}");
+
+    fast->depth--;
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_json_fast_array(njs_json_stringify_fast_t *fast, njs_array_t *array)
+{
+    uint32_t   i;
+    njs_int_t  ret;
+
+    if (array->object.__proto__
+        != &fast->vm->prototypes[NJS_OBJ_TYPE_ARRAY].object
+        || !njs_lvlhsh_is_empty(&array->object.hash)
+        || fast->depth == NJS_JSON_MAX_DEPTH - 1)
+    {
+        return NJS_DECLINED;
+    }
+
+    fast->depth++;
+
+    njs_json_fast_reserve(fast, 1);
+    njs_chb_append_literal(&fast->chain, "[");
+
+    for (i = 0; i < array->length; i++) {
+        if (i != 0) {
+            njs_json_fast_reserve(fast, 1);
+            njs_chb_append_literal(&fast->chain, ",");
+        }
+
+        ret = njs_json_fast_value(fast, &array->start[i]);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
+    }
+
+    njs_json_fast_reserve(fast, 1);
+    njs_chb_append_literal(&fast->chain, "]");
+
+    fast->depth--;
+
+    return NJS_OK;
+}
+
+
+static njs_function_t *
+njs_object_to_json_function(njs_vm_t *vm, njs_value_t *value)
+{
+    njs_int_t           ret;
+    njs_value_t         retval;
+    njs_lvlhsh_query_t  lhq;
+
+    njs_object_property_init(&lhq, &njs_json_to_json_string,
+                             NJS_TO_JSON_HASH);
+
+    ret = njs_object_property(vm, value, &lhq, &retval);
+
+    if (njs_slow_path(ret == NJS_ERROR)) {
+        return NULL;
+    }
+
+    return njs_is_function(&retval) ? njs_function(&retval) : NULL;
+}
+
+
+static njs_int_t
+njs_json_stringify_to_json(njs_json_stringify_t* stringify,
+    njs_json_state_t *state, njs_value_t *key, njs_value_t *value)
+{
+    njs_value_t     arguments[2];
+    njs_function_t  *to_json;
+
+    if (!njs_is_object(value)) {
+        return NJS_OK;
+    }
+
+    to_json = njs_object_to_json_function(stringify->vm, value);
+
+    if (to_json == NULL) {
+        return NJS_OK;
+    }
+
+    arguments[0] = *value;
+
+    switch (state->type) {
+    case NJS_JSON_OBJECT:
+        if (key != NULL) {
+            arguments[1] = *key;
+
+        } else {
+            njs_string_short_set(&arguments[1], 0, 0);
+        }
+
+        break;
+
+    case NJS_JSON_ARRAY:
+        njs_uint32_to_string(&arguments[1], state->index - 1);
+
+        break;
+    }
+
+    return njs_function_apply(stringify->vm, to_json, arguments, 2,
+                              &stringify->retval);
+}
+
+
+static njs_int_t
+njs_json_stringify_replacer(njs_json_stringify_t* stringify,
+    njs_json_state_t *state, njs_value_t *key, njs_value_t *value)
+{
+    njs_value_t  arguments[3];
+
+    if (!njs_is_function(&stringify->replacer)) {
+        return NJS_OK;
+    }
+
+    arguments[0] = state->value;
+
+    switch (state->type) {
+    case NJS_JSON_OBJECT:
+        arguments[1] = *key;
+        arguments[2] = *value;
+
+        break;
+
+    case NJS_JSON_ARRAY:
+        njs_uint32_to_string(&arguments[1], state->index - 1);
+        arguments[2] = *value;
+
+        break;
+    }
+
+    return njs_function_apply(stringify->vm, njs_function(&stringify->replacer),
+                              arguments, 3, &stringify->retval);
+}
+
+
+static njs_int_t
+njs_json_stringify_array(njs_vm_t *vm, njs_json_stringify_t  *stringify)
+{
+    njs_int_t    ret;
+    uint32_t     i, n, k, properties_length, array_length;
+    njs_value_t  *value, num_value;
+    njs_array_t  *properties, *array;
+
+    properties_length = 1;
+    array = njs_array(&stringify->replacer);
+    array_length = array->length;
+
+    for (i = 0; i < array_length; i++) {
+        if (njs_is_valid(&array->start[i])) {
+            properties_length++;
+        }
+    }
+
+    properties = njs_array_alloc(vm, properties_length, NJS_ARRAY_SPARE);
+    if (njs_slow_path(properties == NULL)) {
+        return NJS_ERROR;
+    }
+
+    n = 0;
+    properties->start[n++] = njs_string_empty;
+
+    for (i = 0; i < array_length; i++) {
+        value = &array->start[i];
+
+        if (!njs_is_valid(&array->start[i])) {
+            continue;
+        }
+
+        switch (value->type) {
+        case NJS_OBJECT_NUMBER:
+            value = njs_object_value(value);
+            /* Fall through. */
+
+        case NJS_NUMBER:
+            ret = njs_number_to_string(vm, &num_value, value);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return NJS_ERROR;
+            }
+
+            value = &num_value;
+            break;
+
+        case NJS_OBJECT_STRING:
+            value = njs_object_value(value);
+            break;
+
+        case NJS_STRING:
+            break;
+
+        default:
+            continue;
+        }
+
+        for (k = 0; k < n; k ++) {
+            if (njs_values_strict_equal(value, &properties->start[k]) == 1) {
+                break;
+            }
+        }
+
+        if (k == n) {
+            properties->start[n++] = *value;
+        }
+    }
+
+    properties->length = n;
+    stringify->replacer.data.u.array = properties;
+
+    return NJS_OK;
+}
+
+
+static void
+njs_json_append_value(njs_chb_t *chain, const njs_value_t *value)
+{
+    switch (value->type) {
+    case NJS_OBJECT_STRING:
+        value = njs_object_value(value);
+        /* Fall through. */
+
+    case NJS_STRING:
+        njs_json_append_string(chain, value, '\"');
+        break;
+
+    case NJS_OBJECT_NUMBER:
+        value = njs_object_value(value);
+        /* Fall through. */
+
+    case NJS_NUMBER:
+        njs_json_append_number(chain, value);
+        break;
+
+    case NJS_OBJECT_BOOLEAN:
+        value = njs_object_value(value);
+        /* Fall through. */
+
+    case NJS_BOOLEAN:
+        if (njs_is_true(value)) {
+            njs_chb_append_literal(chain, "true");
+
+        } else {
+            njs_chb_append_literal(chain, "false");
+        }
+
+        break;
+
+    case NJS_UNDEFINED:
+    case NJS_NULL:
+    case NJS_SYMBOL:
+    case NJS_INVALID:
+    case NJS_FUNCTION:
+    default:
+        njs_chb_append_literal(chain, "null");
+    }
+}
+
+
+/*
+ * njs_json_escape_find() returns the first byte in the p - end range
+ * which is escaped in a JSON string: a control character, a quotation
+ * mark or a backslash.
+ */
+
+njs_inline const u_char *
+njs_json_escape_find(const u_char *p, const u_char *end)
+{
+#if (NJS_HAVE_SSE2)
+    int         mask;
+    __m128i     v;
+#elif (NJS_HAVE_NEON)
+    uint64_t    mask;
+    uint8x16_t  v, m;
+#endif
+
+#if (NJS_HAVE_SSE2)
+
+    while (end - p >= 16) {
+        v = _mm_loadu_si128((const __m128i *) p);
+
+        mask = _mm_movemask_epi8(
+                  _mm_or_si128(
+                      _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1f)), v),
+                      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                                   _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')))));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+
+        p += 16;
+    }
+
+#elif (NJS_HAVE_NEON)
+
+    while (end - p >= 16) {
+        v = vld1q_u8(p);
+
+        m = vorrq_u8(vcltq_u8(v, vdupq_n_u8(' ')),
+                     vorrq_u8(vceqq_u8(v, vdupq_n_u8('"')),
+                              vceqq_u8(v, vdupq_n_u8('\\'))));
+
+        /* Each byte of the mask is narrowed to a nibble. */
+
+        mask = vget_lane_u64(vreinterpret_u64_u8(
+                             vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+        if (mask != 0) {
+            return p + (__builtin_ctzll(mask) >> 2);
+        }
+
+        p += 16;
+    }
+
+#endif
+
+    while (p < end && *p >= ' ' && *p != '"' && *p != '\\') {
+        p++;
+    }
+
+    return p;
+}
+
+
+static void
+njs_json_append_string(njs_chb_t *chain, const njs_value_t *value, char quote)
+{
+    u_char             c, *dst, *dst_end;
+    size_t             size;
+    const u_char       *p, *q, *end;
+    njs_string_prop_t  str;
+
+    static char   hex2char[16] = { '0', '1', '2', '3', '4', '5', '6', '7',
+                                   '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+
+    (void) njs_string_prop(&str, value);
+
+    p = str.start;
+    end = p + str.size;
+
+    dst = njs_chb_reserve(chain, str.size + 2);
+    if (njs_slow_path(dst == NULL)) {
+        return;
+    }
+
+    dst_end = dst + str.size + 2;
+
+    *dst++ = quote;
+
+    /*
+     * The runs without escaped bytes are copied as is, the destination
+     * has room for the rest of the source and the ending quotation mark.
+     */
+
+    for ( ;; ) {
+        q = njs_json_escape_find(p, end);
+
+        dst = njs_cpymem(dst, p, q - p);
+        p = q;
+
+        if (p == end) {
+            break;
+        }
+
+        /*
+         * Control characters less than space are encoded using 6 bytes
+         * "\uXXXX".
+         */
+
+        if ((size_t) (dst_end - dst) < (size_t) (end - p) + 6) {
+            njs_chb_written(chain, dst - chain->last->pos);
+
+            size = (end - p) + 64;
+
+            dst = njs_chb_reserve(chain, size);
+            if (njs_slow_path(dst == NULL)) {
+                return;
+            }
+
+            dst_end = dst + size;
+        }
+
+        c = *p++;
+
+        if (c == '\"' && quote != '\"') {
+            *dst++ = c;
+            continue;
+        }
+
+        *dst++ = '\\';
+
+        switch (c) {
+        case '\\':
+            *dst++ = '\\';
+            break;
+        case '"':
+            *dst++ = '\"';
+            break;
+        case '\r':
+            *dst++ = 'r';
+            break;
+        case '\n':
+            *dst++ = 'n';
+            break;
+        case '\t':
+            *dst++ = 't';
+            break;
+        case '\b':
+            *dst++ = 'b';
+            break;
+        case '\f':
+            *dst++ = 'f';
+            break;
+        default:
+            *dst++ = 'u';
+            *dst++ = '0';
+            *dst++ = '0';
+            *dst++ = hex2char[(c & 0xf0) >> 4];
+            *dst++ = hex2char[c & 0x0f];
+        }
+    }
+
+    *dst++ = quote;
+
+    njs_chb_written(chain, dst - chain->last->pos);
+}
+
+
+static void
+njs_json_append_number(njs_chb_t *chain, const njs_value_t *value)
+{
+    u_char    *p, *last, buf[NJS_INT64_T_LEN];
+    size_t    size;
+    double    num;
+    uint64_t  u64;
+
+    num = njs_number(value);
+
+    if (fabs(num) < 9007199254740992.0 && num == (double) (int64_t) num) {
+
+        /* Integers are formatted without the shortest representation. */
+
+        u64 = (uint64_t) fabs(num);
+
+        last = buf + sizeof(buf);
+        p = last;
+
+        do {
+            *(--p) = (u_char) (u64 % 10 + '0');
+            u64 /= 10;
+        } while (u64 != 0);
+
+        if (num < 0) {
+            *(--p) = '-';
+        }
+
+        njs_chb_append(chain, p, last - p);
+
+    } else if (isnan(num) || isinf(num)) {
+        njs_chb_append_literal(chain, "null");
+
+    } else {
+        p = njs_chb_reserve(chain, 64);
+        if (njs_slow_path(p == NULL)) {
+            return;
+        }
+
+        size = njs_dtoa(num, (char *) p);
+
+        njs_chb_written(chain, size);
+    }
+}
+
+
+/*
+ * Wraps a value as '{"": <value>}'.
+ */
+static njs_object_t *
+njs_json_wrap_value(njs_vm_t *vm, njs_value_t *wrapper,
+    const njs_value_t *value)
+{
+    njs_int_t           ret;
+    njs_object_prop_t   *prop;
+    njs_lvlhsh_query_t  lhq;
+
+    wrapper->data.u.object = njs_object_alloc(vm);
+    if (njs_slow_path(njs_object(wrapper) == NULL)) {
+        return NULL;
+    }
+
+    wrapper->type = NJS_OBJECT;
+    wrapper->data.truth = 1;
+
+    lhq.replace = 0;
+    lhq.proto = &njs_object_hash_proto;
+    lhq.pool = vm->mem_pool;
+    lhq.key = njs_str_value("");
+    lhq.key_hash = NJS_DJB_HASH_INIT;
+
+    prop = njs_object_prop_alloc(vm, &njs_string_empty, value, 1);
+    if (njs_slow_path(prop == NULL)) {
+        return NULL;
+    }
+
+    lhq.value = prop;
+
+    ret = njs_lvlhsh_insert(njs_object_hash(wrapper), &lhq);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return NULL;
+    }
+
+    return wrapper->data.u.object;
+}
+
+
+static njs_int_t
+njs_json_create_parser(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
+    njs_index_t unused)
+{
+    njs_int_t           ret;
+    njs_value_t         *options, value;
+    njs_json_stream_t   *js;
+    njs_object_value_t  *ov;
+
+    static const njs_value_t  string_elements = njs_string("elements");
+
+    js = njs_mp_zalloc(vm->mem_pool, sizeof(njs_json_stream_t));
+    if (njs_slow_path(js == NULL)) {
+        goto memory_error;
+    }
+
+    options = njs_arg(args, nargs, 1);
+
+    if (njs_is_object(options)) {
+        ret = njs_value_property(vm, options, njs_value_arg(&string_elements),
+                                 &value);
+        if (njs_slow_path(ret == NJS_ERROR)) {
+            return ret;
+        }
+
+        js->elements = njs_is_true(&value);
+
+    } else if (njs_slow_path(!njs_is_undefined(options))) {
+        njs_type_error(vm, "options must be an object");
+        return NJS_ERROR;
+    }
+
+    js->state = js->elements ? NJS_JSON_STREAM_ARRAY : NJS_JSON_STREAM_VALUE;
+
+    ov = njs_mp_alloc(vm->mem_pool, sizeof(njs_object_value_t));
+    if (njs_slow_path(ov == NULL)) {
+        goto memory_error;
+    }
+
+    njs_lvlhsh_init(&ov->object.hash);
+    njs_lvlhsh_init(&ov->object.shared_hash);
+    ov->object.type = NJS_OBJECT_VALUE;
+    ov->object.shared = 0;
+    ov->object.extensible = 1;
+    ov->object.__proto__ = &vm->prototypes[NJS_OBJ_TYPE_JSON_PARSER].object;
+
+    njs_set_data(&ov->value, js);
+    ov->value.data.magic16 = NJS_OBJ_TYPE_JSON_PARSER;
+
+    njs_set_object_value(&vm->retval, ov);
+
+    return NJS_OK;
+
+memory_error:
+
+    njs_memory_error(vm);
+
+    return NJS_ERROR;
+}
+
+
+njs_int_t
+njs_vm_json_parser_create(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs)
+{
+    njs_function_t  *create;
+
+    create = njs_function(&njs_json_object_properties[3].value);
+
+    return njs_vm_call(vm, create, args, nargs);
+}
+
+
+static njs_json_stream_t *
+njs_json_stream(const njs_value_t *value)
+{
+    const njs_value_t  *data;
+
+    if (njs_is_object_value(value)) {
+        data = njs_object_value(value);
+
+        if (njs_is_data(data) && data->data.magic16 == NJS_OBJ_TYPE_JSON_PARSER)
+        {
+            return data->data.u.data;
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+ * njs_json_stream_scan() returns the end of the value being scanned
+ * or NULL if the value continues in the next chunk.
+ */
+
+static const u_char *
+njs_json_stream_scan(njs_json_stream_t *js, const u_char *p,
+    const u_char *end)
+{
+    u_char  c;
+
+    if (js->state == NJS_JSON_STREAM_LITERAL) {
+        while (p < end) {
+            switch (*p) {
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+            case ',':
+            case ':':
+            case '[':
+            case ']':
+            case '{':
+            case '}':
+            case '"':
+                return p;
+
+            default:
+                p++;
+            }
+        }
+
+        return NULL;
+    }
+
+    if (js->escape) {
+        if (p == end) {
+            return NULL;
+        }
+
+        js->escape = 0;
+        p++;
+    }
+
+    while (p < end) {
+        if (js->string) {
+            p = njs_json_escape_find(p, end);
+            if (p == end) {
+                return NULL;
+            }
+
+            c = *p++;
+
+            if (c == '"') {
+                js->string = 0;
+
+                if (js->depth == 0) {
+                    return p;
+                }
+
+            } else if (c == '\\') {
+                if (p == end) {
+                    js->escape = 1;
+                    return NULL;
+                }
+
+                p++;
+            }
+
+            continue;
+        }
+
+        switch (*p++) {
+        case '"':
+            js->string = 1;
+            break;
+
+        case '[':
+        case '{':
+            js->depth++;
+            break;
+
+        case ']':
+        case '}':
+            if (--js->depth == 0) {
+                return p;
+            }
+
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+
+static njs_int_t
+njs_json_stream_save(njs_vm_t *vm, njs_json_stream_t *js, const u_char *start,
+    const u_char *end)
+{
+    u_char  *buf;
+    size_t  size, capacity;
+
+    size = end - start;
+
+    if (js->capacity - js->size < size) {
+        capacity = njs_max(js->capacity * 2, js->size + size);
+        capacity = njs_max(capacity, 1024);
+
+        buf = njs_mp_alloc(vm->mem_pool, capacity);
+        if (njs_slow_path(buf == NULL)) {
+            njs_memory_error(vm);
+            return NJS_ERROR;
+        }
+
+        if (js->buf != NULL) {
+            memcpy(buf, js->buf, js->size);
+            njs_mp_free(vm->mem_pool, js->buf);
+        }
+
+        js->buf = buf;
+        js->capacity = capacity;
+    }
+
+    memcpy(js->buf + js->size, start, size);
+    js->size += size;
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_json_stream_value(njs_vm_t *vm, njs_json_stream_t *js,
+    const u_char *start, const u_char *end, njs_array_t *values)
+{
+    njs_int_t             ret;
+    njs_value_t           value;
+    njs_json_parse_ctx_t  ctx;
+
+    if (js->size != 0) {
+        ret = njs_json_stream_save(vm, js, start, end);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
+
+        start = js->buf;
+        end = start + js->size;
+
+        js->size = 0;
+    }
+
+    ctx.vm = vm;
+    ctx.pool = vm->mem_pool;
+    ctx.depth = js->elements ? NJS_JSON_MAX_DEPTH - 1 : NJS_JSON_MAX_DEPTH;
+    ctx.start = start;
+    ctx.end = end;
+    ctx.keys = &js->keys;
+
+    ret = njs_json_parse_text(&ctx, &value);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
+
+    js->state = js->elements ? NJS_JSON_STREAM_NEXT : NJS_JSON_STREAM_VALUE;
+
+    return njs_array_add(vm, values, &value);
+}
+
+
+static njs_int_t
+njs_json_stream_write(njs_vm_t *vm, njs_json_stream_t *js, const u_char *p,
+    const u_char *end, njs_bool_t last)
+{
+    njs_int_t     ret;
+    njs_array_t   *values;
+    const u_char  *start, *next;
+
+    if (njs_slow_path(js->state == NJS_JSON_STREAM_CLOSED)) {
+        njs_error(vm, "JSON parser is closed");
+        return NJS_ERROR;
+    }
+
+    values = njs_array_alloc(vm, 0, NJS_ARRAY_SPARE);
+    if (njs_slow_path(values == NULL)) {
+        return NJS_ERROR;
+    }
+
+    /* A value continued from the previous chunk. */
+    start = p;
+
+    while (p < end) {
+
+        if (js->state >= NJS_JSON_STREAM_NESTED) {
+            next = njs_json_stream_scan(js, p, end);
+
+            if (next == NULL) {
+                ret = njs_json_stream_save(vm, js, start, end);
+                if (njs_slow_path(ret != NJS_OK)) {
+                    goto failed;
+                }
+
+                break;
+            }
+
+            ret = njs_json_stream_value(vm, js, start, next, values);
+            if (njs_slow_path(ret != NJS_OK)) {
+                goto failed;
+            }
+
+            p = next;
+            continue;
+        }
+
+        p = njs_json_skip_space(p, end);
+        if (p == end) {
+            break;
+        }
+
+        switch (js->state) {
+
+        case NJS_JSON_STREAM_ARRAY:
+            if (njs_slow_path(*p != '[')) {
+                goto unexpected;
+            }
+
+            js->state = NJS_JSON_STREAM_FIRST;
+            p++;
+            continue;
+
+        case NJS_JSON_STREAM_FIRST:
+            if (*p == ']') {
+                js->state = NJS_JSON_STREAM_END;
+                p++;
+                continue;
+            }
+
+            break;
+
+        case NJS_JSON_STREAM_ELEMENT:
+            if (njs_slow_path(*p == ']')) {
+                njs_syntax_error(vm, "Trailing comma");
+                goto failed;
+            }
+
+            break;
+
+        case NJS_JSON_STREAM_NEXT:
+            if (*p == ',') {
+                js->state = NJS_JSON_STREAM_ELEMENT;
+                p++;
+                continue;
+            }
+
+            if (*p == ']') {
+                js->state = NJS_JSON_STREAM_END;
+                p++;
+                continue;
+            }
 
-    for (i = 0; i < array_length; i++) {
-        if (njs_is_valid(&array->start[i])) {
-            properties_length++;
+            goto unexpected;
+
+        case NJS_JSON_STREAM_END:
+            goto unexpected;
+
+        default:
+            break;
+        }
+
+        start = p;
+
+        switch (*p) {
+        case '[':
+        case '{':
+        case '"':
+            js->depth = 0;
+            js->state = NJS_JSON_STREAM_NESTED;
+            break;
+
+        case ']':
+        case '}':
+        case ',':
+        case ':':
+            goto unexpected;
+
+        default:
+            js->state = NJS_JSON_STREAM_LITERAL;
+            break;
         }
     }
 
-    properties = njs_array_alloc(vm, properties_length, NJS_ARRAY_SPARE);
-    if (njs_slow_path(properties == NULL)) {
+    if (last) {
+        if (js->state == NJS_JSON_STREAM_LITERAL) {
+            ret = njs_json_stream_value(vm, js, end, end, values);
+            if (njs_slow_path(ret != NJS_OK)) {
+                goto failed;
+            }
+        }
+
+        if (njs_slow_path(js->state != NJS_JSON_STREAM_VALUE
+                          && js->state != NJS_JSON_STREAM_END))
+        {
+            njs_syntax_error(vm, "Unexpected end of input");
+            goto failed;
+        }
+
+        js->state = NJS_JSON_STREAM_CLOSED;
+    }
+
+    njs_set_array(&vm->retval, values);
+
+    return NJS_OK;
+
+unexpected:
+
+    njs_syntax_error(vm, "Unexpected token");
+
+failed:
+
+    js->state = NJS_JSON_STREAM_CLOSED;
+
+    return NJS_ERROR;
+}
+
+
+static njs_int_t
+njs_json_parser_write(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
+    njs_index_t last)
+{
+    njs_str_t           data;
+    njs_value_t         *chunk;
+    njs_json_stream_t   *js;
+    njs_array_buffer_t  *buffer;
+
+    js = njs_json_stream(&args[0]);
+    if (njs_slow_path(js == NULL)) {
+        njs_type_error(vm, "\"this\" is not a JSONParser");
+        return NJS_ERROR;
+    }
+
+    chunk = njs_arg(args, nargs, 1);
+
+    if (njs_is_string(chunk)) {
+        njs_string_get(chunk, &data);
+
+    } else if (njs_is_array_buffer(chunk)) {
+        buffer = njs_array_buffer(chunk);
+
+        data.start = buffer->u.u8;
+        data.length = buffer->size;
+
+    } else if (last && njs_is_undefined(chunk)) {
+        data.start = NULL;
+        data.length = 0;
+
+    } else {
+        njs_type_error(vm, "chunk must be a string or an ArrayBuffer");
+        return NJS_ERROR;
+    }
+
+    return njs_json_stream_write(vm, js, data.start, data.start + data.length,
+                                 last);
+}
+
+
+njs_int_t
+njs_vm_json_parse_chunk(njs_vm_t *vm, njs_value_t *parser, const u_char *start,
+    size_t size, njs_bool_t last)
+{
+    njs_json_stream_t  *js;
+
+    js = njs_json_stream(parser);
+    if (njs_slow_path(js == NULL)) {
+        njs_type_error(vm, "parser is not a JSONParser");
+        return NJS_ERROR;
+    }
+
+    return njs_json_stream_write(vm, js, start, start + size, last);
+}
+
+
+static const njs_object_prop_t  njs_json_parser_prototype_properties[] =
+{
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_wellknown_symbol(NJS_SYMBOL_TO_STRING_TAG),
+        .value = njs_string("JSONParser"),
+        .configurable = 1,
+    },
+
+    {
+        .type = NJS_PROPERTY_HANDLER,
+        .name = njs_string("constructor"),
+        .value = njs_prop_handler(njs_object_prototype_create_constructor),
+        .writable = 1,
+        .configurable = 1,
+    },
+
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("write"),
+        .value = njs_native_function2(njs_json_parser_write, 1, 0),
+        .writable = 1,
+        .configurable = 1,
+    },
+
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("end"),
+        .value = njs_native_function2(njs_json_parser_write, 0, 1),
+        .writable = 1,
+        .configurable = 1,
+    },
+};
+
+
+const njs_object_init_t  njs_json_parser_prototype_init = {
+    njs_json_parser_prototype_properties,
+    njs_nitems(njs_json_parser_prototype_properties),
+};
+
+
+static const njs_object_prop_t  njs_json_parser_constructor_properties[] =
+{
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("name"),
+        .value = njs_string("JSONParser"),
+        .configurable = 1,
+    },
+
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("length"),
+        .value = njs_value(NJS_NUMBER, 0, 0.0),
+        .configurable = 1,
+    },
+
+    {
+        .type = NJS_PROPERTY_HANDLER,
+        .name = njs_string("prototype"),
+        .value = njs_prop_handler(njs_object_prototype_create),
+    },
+};
+
+
+const njs_object_init_t  njs_json_parser_constructor_init = {
+    njs_json_parser_constructor_properties,
+    njs_nitems(njs_json_parser_constructor_properties),
+};
+
+
+const njs_object_type_init_t  njs_json_parser_type_init = {
+    .constructor = njs_native_ctor(njs_json_create_parser, 0, 0),
+    .constructor_props = &njs_json_parser_constructor_init,
+    .prototype_props = &njs_json_parser_prototype_init,
+    .prototype_value = { .object_value = { .value = njs_value(NJS_DATA, 0, 0.0),
+                                           .object = { .type = NJS_OBJECT } } },
+};
+
+
+/*
+ * A JSON view validates a document once and records the end of every
+ * array and object in the document order, so a member is found by
+ * skipping its preceding siblings as a whole and only the member
+ * requested is decoded.
+ */
+
+typedef struct {
+    /* The offset past the closing bracket. */
+    uint32_t                   end;
+    /* The first array or object past the closing bracket. */
+    uint32_t                   next;
+} njs_json_node_t;
+
+
+typedef struct {
+    njs_value_t                text;
+    const u_char               *start;
+    const u_char               *end;
+
+    /* The offset of the top-level value. */
+    uint32_t                   root;
+
+    njs_json_node_t            *nodes;
+    uint32_t                   count;
+    uint32_t                   capacity;
+
+    njs_json_keys_t            keys;
+} njs_json_view_t;
+
+
+static const u_char *
+njs_json_view_index(njs_json_parse_ctx_t *ctx, njs_json_view_t *view,
+    const u_char *p)
+{
+    u_char           close;
+    size_t           surplus;
+    uint32_t         n, capacity;
+    njs_bool_t       empty;
+    njs_value_t      value;
+    njs_json_node_t  *nodes;
+
+    if (*p != '{' && *p != '[') {
+        if (*p == '"') {
+            p = njs_json_string_end(ctx, p, &surplus);
+            return (p != NULL) ? p + 1 : NULL;
+        }
+
+        return njs_json_parse_value(ctx, &value, p);
+    }
+
+    if (njs_slow_path(--ctx->depth == 0)) {
+        njs_json_parse_exception(ctx, "Nested too deep", p);
+        return NULL;
+    }
+
+    if (view->count == view->capacity) {
+        capacity = njs_max(view->capacity * 2, 64);
+
+        nodes = njs_mp_alloc(ctx->pool, capacity * sizeof(njs_json_node_t));
+        if (njs_slow_path(nodes == NULL)) {
+            njs_memory_error(ctx->vm);
+            return NULL;
+        }
+
+        if (view->nodes != NULL) {
+            memcpy(nodes, view->nodes, view->count * sizeof(njs_json_node_t));
+            njs_mp_free(ctx->pool, view->nodes);
+        }
+
+        view->nodes = nodes;
+        view->capacity = capacity;
+    }
+
+    n = view->count++;
+
+    close = (*p == '{') ? '}' : ']';
+    empty = 1;
+
+    for ( ;; ) {
+        p = njs_json_skip_space(p + 1, ctx->end);
+        if (njs_slow_path(p == ctx->end)) {
+            goto error_end;
+        }
+
+        if (*p == close) {
+            if (njs_slow_path(!empty)) {
+                njs_json_parse_exception(ctx, "Trailing comma", p - 1);
+                return NULL;
+            }
+
+            break;
+        }
+
+        if (close == '}') {
+            if (njs_slow_path(*p != '"')) {
+                goto error_token;
+            }
+
+            p = njs_json_string_end(ctx, p, &surplus);
+            if (njs_slow_path(p == NULL)) {
+                return NULL;
+            }
+
+            p = njs_json_skip_space(p + 1, ctx->end);
+            if (njs_slow_path(p == ctx->end || *p != ':')) {
+                goto error_token;
+            }
+
+            p = njs_json_skip_space(p + 1, ctx->end);
+            if (njs_slow_path(p == ctx->end)) {
+                goto error_end;
+            }
+        }
+
+        p = njs_json_view_index(ctx, view, p);
+        if (njs_slow_path(p == NULL)) {
+            return NULL;
+        }
+
+        empty = 0;
+
+        p = njs_json_skip_space(p, ctx->end);
+        if (njs_slow_path(p == ctx->end)) {
+            goto error_end;
+        }
+
+        if (*p != ',') {
+            if (njs_fast_path(*p == close)) {
+                break;
+            }
+
+            goto error_token;
+        }
+    }
+
+    view->nodes[n].end = p + 1 - ctx->start;
+    view->nodes[n].next = view->count;
+
+    ctx->depth++;
+
+    return p + 1;
+
+error_token:
+
+    njs_json_parse_exception(ctx, "Unexpected token", p);
+
+    return NULL;
+
+error_end:
+
+    njs_json_parse_exception(ctx, "Unexpected end of input", p);
+
+    return NULL;
+}
+
+
+njs_int_t
+njs_json_view_create(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
+    njs_index_t unused)
+{
+    njs_int_t             ret;
+    njs_value_t           *text, lvalue;
+    const u_char          *p;
+    njs_json_view_t       *view;
+    njs_string_prop_t     string;
+    njs_object_value_t    *ov;
+    njs_json_parse_ctx_t  ctx;
+
+    text = njs_lvalue_arg(&lvalue, args, nargs, 1);
+
+    if (njs_slow_path(!njs_is_string(text))) {
+        ret = njs_value_to_string(vm, text, text);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
+    }
+
+    view = njs_mp_zalloc(vm->mem_pool, sizeof(njs_json_view_t));
+    if (njs_slow_path(view == NULL)) {
+        goto memory_error;
+    }
+
+    /* Short strings are kept in the value itself. */
+
+    view->text = *text;
+
+    (void) njs_string_prop(&string, &view->text);
+
+    if (njs_slow_path(string.size > UINT32_MAX)) {
+        njs_range_error(vm, "text is too long");
+        return NJS_ERROR;
+    }
+
+    view->start = string.start;
+    view->end = string.start + string.size;
+
+    ctx.vm = vm;
+    ctx.pool = vm->mem_pool;
+    ctx.depth = NJS_JSON_MAX_DEPTH;
+    ctx.start = view->start;
+    ctx.end = view->end;
+    ctx.keys = &view->keys;
+
+    p = njs_json_skip_space(ctx.start, ctx.end);
+    if (njs_slow_path(p == ctx.end)) {
+        njs_json_parse_exception(&ctx, "Unexpected end of input", p);
+        return NJS_ERROR;
+    }
+
+    view->root = p - ctx.start;
+
+    p = njs_json_view_index(&ctx, view, p);
+    if (njs_slow_path(p == NULL)) {
+        return NJS_ERROR;
+    }
+
+    p = njs_json_skip_space(p, ctx.end);
+    if (njs_slow_path(p != ctx.end)) {
+        njs_json_parse_exception(&ctx, "Unexpected token", p);
         return NJS_ERROR;
     }
 
-    n = 0;
-    properties->start[n++] = njs_string_empty;
+    ov = njs_mp_alloc(vm->mem_pool, sizeof(njs_object_value_t));
+    if (njs_slow_path(ov == NULL)) {
+        goto memory_error;
+    }
 
-    for (i = 0; i < array_length; i++) {
-        value = &array->start[i];
+    njs_lvlhsh_init(&ov->object.hash);
+    njs_lvlhsh_init(&ov->object.shared_hash);
+    ov->object.type = NJS_OBJECT_VALUE;
+    ov->object.shared = 0;
+    ov->object.extensible = 1;
+    ov->object.__proto__ = &vm->prototypes[NJS_OBJ_TYPE_JSON_VIEW].object;
 
-        if (!njs_is_valid(&array->start[i])) {
-            continue;
-        }
+    njs_set_data(&ov->value, view);
+    ov->value.data.magic16 = NJS_OBJ_TYPE_JSON_VIEW;
 
-        switch (value->type) {
-        case NJS_OBJECT_NUMBER:
-            value = njs_object_value(value);
-            /* Fall through. */
+    njs_set_object_value(&vm->retval, ov);
 
-        case NJS_NUMBER:
-            ret = njs_number_to_string(vm, &num_value, value);
-            if (njs_slow_path(ret != NJS_OK)) {
-                return NJS_ERROR;
-            }
+    return NJS_OK;
 
-            value = &num_value;
-            break;
+memory_error:
 
-        case NJS_OBJECT_STRING:
-            value = njs_object_value(value);
-            break;
+    njs_memory_error(vm);
 
-        case NJS_STRING:
-            break;
+    return NJS_ERROR;
+}
 
-        default:
-            continue;
-        }
 
-        for (k = 0; k < n; k ++) {
-            if (njs_values_strict_equal(value, &properties->start[k]) == 1) {
-                break;
-            }
-        }
+static njs_json_view_t *
+njs_json_view(const njs_value_t *value)
+{
+    const njs_value_t  *data;
 
-        if (k == n) {
-            properties->start[n++] = *value;
+    if (njs_is_object_value(value)) {
+        data = njs_object_value(value);
+
+        if (njs_is_data(data) && data->data.magic16 == NJS_OBJ_TYPE_JSON_VIEW) {
+            return data->data.u.data;
         }
     }
 
-    properties->length = n;
-    stringify->replacer.data.u.array = properties;
-
-    return NJS_OK;
+    return NULL;
 }
 
 
-static void
-njs_json_append_value(njs_chb_t *chain, const njs_value_t *value)
-{
-    switch (value->type) {
-    case NJS_OBJECT_STRING:
-        value = njs_object_value(value);
-        /* Fall through. */
-
-    case NJS_STRING:
-        njs_json_append_string(chain, value, '\"');
-        break;
+/*
+ * njs_json_view_skip() returns the end of a validated value, the node
+ * is advanced past the arrays and objects skipped.
+ */
 
-    case NJS_OBJECT_NUMBER:
-        value = njs_object_value(value);
-        /* Fall through. */
+static const u_char *
+njs_json_view_skip(njs_json_view_t *view, const u_char *p, uint32_t *node)
+{
+    switch (*p) {
+    case '{':
+    case '[':
+        p = view->start + view->nodes[*node].end;
+        *node = view->nodes[*node].next;
 
-    case NJS_NUMBER:
-        njs_json_append_number(chain, value);
-        break;
+        return p;
 
-    case NJS_OBJECT_BOOLEAN:
-        value = njs_object_value(value);
-        /* Fall through. */
+    case '"':
+        for (p++; *p != '"'; p++) {
+            if (*p == '\\') {
+                p++;
+            }
+        }
 
-    case NJS_BOOLEAN:
-        if (njs_is_true(value)) {
-            njs_chb_append_literal(chain, "true");
+        return p + 1;
+    }
 
-        } else {
-            njs_chb_append_literal(chain, "false");
+    while (p < view->end) {
+        switch (*p) {
+        case ',':
+        case ']':
+        case '}':
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+            return p;
         }
 
-        break;
-
-    case NJS_UNDEFINED:
-    case NJS_NULL:
-    case NJS_SYMBOL:
-    case NJS_INVALID:
-    case NJS_FUNCTION:
-    default:
-        njs_chb_append_literal(chain, "null");
+        p++;
     }
+
+    return p;
 }
 
 
-static void
-njs_json_append_string(njs_chb_t *chain, const njs_value_t *value, char quote)
+static njs_int_t
+njs_json_view_get(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
+    njs_index_t unused)
 {
-    u_char             c, *dst, *dst_end;
-    size_t             length;
-    const u_char       *p, *end;
-    njs_string_prop_t  str;
+    njs_int_t             ret;
+    njs_str_t             name, str;
+    uint32_t              index, i, node, found_node;
+    njs_uint_t            n;
+    njs_value_t           key, decoded;
+    const u_char          *p, *q, *end, *found;
+    njs_json_view_t       *view;
+    njs_json_parse_ctx_t  ctx;
 
-    static char   hex2char[16] = { '0', '1', '2', '3', '4', '5', '6', '7',
-                                   '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+    view = njs_json_view(&args[0]);
+    if (njs_slow_path(view == NULL)) {
+        njs_type_error(vm, "\"this\" is not a JSONView");
+        return NJS_ERROR;
+    }
 
-    (void) njs_string_prop(&str, value);
+    ctx.vm = vm;
+    ctx.pool = vm->mem_pool;
+    ctx.depth = NJS_JSON_MAX_DEPTH;
+    ctx.start = view->start;
+    ctx.end = view->end;
+    ctx.keys = &view->keys;
 
-    p = str.start;
-    end = p + str.size;
-    length = str.length;
+    end = view->end;
 
-    dst = njs_chb_reserve(chain, length + 2);
-    if (njs_slow_path(dst == NULL)) {
-        return;
-    }
+    p = view->start + view->root;
+    node = 0;
 
-    dst_end = dst + length + 2;
+    for (n = 1; n < nargs; n++) {
+        ret = njs_value_to_key(vm, &key, &args[n]);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
 
-    *dst++ = quote;
+        if (*p == '[') {
+            index = njs_key_to_index(&key);
+            if (index == NJS_ARRAY_INVALID_INDEX) {
+                goto undefined;
+            }
 
-    while (p < end) {
+            node++;
 
-        if (*p < ' '
-            || *p == '\\'
-            || (*p == '\"' && quote == '\"'))
-        {
-            c = (u_char) *p++;
-            *dst++ = '\\';
+            p = njs_json_skip_space(p + 1, end);
+            if (*p == ']') {
+                goto undefined;
+            }
 
-            switch (c) {
-            case '\\':
-                *dst++ = '\\';
-                break;
-            case '"':
-                *dst++ = '\"';
-                break;
-            case '\r':
-                *dst++ = 'r';
-                break;
-            case '\n':
-                *dst++ = 'n';
-                break;
-            case '\t':
-                *dst++ = 't';
-                break;
-            case '\b':
-                *dst++ = 'b';
-                break;
-            case '\f':
-                *dst++ = 'f';
-                break;
-            default:
-                *dst++ = 'u';
-                *dst++ = '0';
-                *dst++ = '0';
-                *dst++ = hex2char[(c & 0xf0) >> 4];
-                *dst++ = hex2char[c & 0x0f];
+            for (i = 0; i != index; i++) {
+                p = njs_json_view_skip(view, p, &node);
+
+                p = njs_json_skip_space(p, end);
+                if (*p == ']') {
+                    goto undefined;
+                }
+
+                p = njs_json_skip_space(p + 1, end);
             }
+
+            continue;
         }
 
-        /*
-         * Control characters less than space are encoded using 6 bytes
-         * "\uXXXX".  Checking there is at least 6 bytes of destination storage
-         * space.
-         */
+        if (*p != '{' || !njs_is_string(&key)) {
+            goto undefined;
+        }
 
-        while (p < end && (dst_end - dst) > 6) {
-            if (*p < ' ' || (*p == '\"' && quote == '\"') || *p == '\\') {
-                break;
+        njs_string_get(&key, &name);
+
+        node++;
+        found = NULL;
+        found_node = 0;
+
+        p = njs_json_skip_space(p + 1, end);
+
+        while (*p != '}') {
+            q = njs_json_view_skip(view, p, &node);
+
+            str.start = (u_char *) p + 1;
+            str.length = q - p - 2;
+
+            if (memchr(str.start, '\\', str.length) != NULL) {
+                if (njs_json_parse_string(&ctx, &decoded, p) == NULL) {
+                    return NJS_ERROR;
+                }
+
+                njs_string_get(&decoded, &str);
             }
 
-            if (length != 0) {
-                /* UTF-8 or ASCII string. */
-                dst = njs_utf8_copy(dst, &p, end);
+            p = njs_json_skip_space(q, end);
+            p = njs_json_skip_space(p + 1, end);
 
-            } else {
-                /* Byte string. */
-                *dst++ = *p++;
+            /* The last one of the duplicate names wins. */
+
+            if (njs_strstr_eq(&str, &name)) {
+                found = p;
+                found_node = node;
             }
-        }
 
-        if (dst_end - dst <= 6) {
-            njs_chb_written(chain, dst - chain->last->pos);
+            p = njs_json_view_skip(view, p, &node);
 
-            dst = njs_chb_reserve(chain, 64);
-            if (njs_slow_path(dst == NULL)) {
-                return;
+            p = njs_json_skip_space(p, end);
+            if (*p == ',') {
+                p = njs_json_skip_space(p + 1, end);
             }
+        }
 
-            dst_end = dst + 64;
+        if (found == NULL) {
+            goto undefined;
         }
+
+        p = found;
+        node = found_node;
     }
 
-    njs_chb_written(chain, dst - chain->last->pos);
+    ctx.start = p;
+    ctx.end = njs_json_view_skip(view, p, &node);
+
+    return njs_json_parse_text(&ctx, &vm->retval);
 
-    njs_chb_append(chain, &quote, 1);
+undefined:
+
+    njs_set_undefined(&vm->retval);
+
+    return NJS_OK;
 }
 
 
-static void
-njs_json_append_number(njs_chb_t *chain, const njs_value_t *value)
+static const njs_object_prop_t  njs_json_view_prototype_properties[] =
 {
-    u_char  *p;
-    size_t  size;
-    double  num;
-
-    num = njs_number(value);
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_wellknown_symbol(NJS_SYMBOL_TO_STRING_TAG),
+        .value = njs_string("JSONView"),
+        .configurable = 1,
+    },
 
-    if (isnan(num) || isinf(num)) {
-        njs_chb_append_literal(chain, "null");
+    {
+        .type = NJS_PROPERTY_HANDLER,
+        .name = njs_string("constructor"),
+        .value = njs_prop_handler(njs_object_prototype_create_constructor),
+        .writable = 1,
+        .configurable = 1,
+    },
 
-    } else {
-        p = njs_chb_reserve(chain, 64);
-        if (njs_slow_path(p == NULL)) {
-            return;
-        }
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("get"),
+        .value = njs_native_function(njs_json_view_get, 0),
+        .writable = 1,
+        .configurable = 1,
+    },
+};
 
-        size = njs_dtoa(num, (char *) p);
 
-        njs_chb_written(chain, size);
-    }
-}
+const njs_object_init_t  njs_json_view_prototype_init = {
+    njs_json_view_prototype_properties,
+    njs_nitems(njs_json_view_prototype_properties),
+};
 
 
-/*
- * Wraps a value as '{"": <value>}'.
- */
-static njs_object_t *
-njs_json_wrap_value(njs_vm_t *vm, njs_value_t *wrapper,
-    const njs_value_t *value)
+static const njs_object_prop_t  njs_json_view_constructor_properties[] =
 {
-    njs_int_t           ret;
-    njs_object_prop_t   *prop;
-    njs_lvlhsh_query_t  lhq;
-
-    wrapper->data.u.object = njs_object_alloc(vm);
-    if (njs_slow_path(njs_object(wrapper) == NULL)) {
-        return NULL;
-    }
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("name"),
+        .value = njs_string("JSONView"),
+        .configurable = 1,
+    },
 
-    wrapper->type = NJS_OBJECT;
-    wrapper->data.truth = 1;
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("length"),
+        .value = njs_value(NJS_NUMBER, 0, 1.0),
+        .configurable = 1,
+    },
 
-    lhq.replace = 0;
-    lhq.proto = &njs_object_hash_proto;
-    lhq.pool = vm->mem_pool;
-    lhq.key = njs_str_value("");
-    lhq.key_hash = NJS_DJB_HASH_INIT;
+    {
+        .type = NJS_PROPERTY_HANDLER,
+        .name = njs_string("prototype"),
+        .value = njs_prop_handler(njs_object_prototype_create),
+    },
+};
 
-    prop = njs_object_prop_alloc(vm, &njs_string_empty, value, 1);
-    if (njs_slow_path(prop == NULL)) {
-        return NULL;
-    }
 
-    lhq.value = prop;
+const njs_object_init_t  njs_json_view_constructor_init = {
+    njs_json_view_constructor_properties,
+    njs_nitems(njs_json_view_constructor_properties),
+};
 
-    ret = njs_lvlhsh_insert(njs_object_hash(wrapper), &lhq);
-    if (njs_slow_path(ret != NJS_OK)) {
-        return NULL;
-    }
 
-    return wrapper->data.u.object;
-}
+const njs_object_type_init_t  njs_json_view_type_init = {
+    .constructor = njs_native_ctor(njs_json_view_create, 1, 0),
+    .constructor_props = &njs_json_view_constructor_init,
+    .prototype_props = &njs_json_view_prototype_init,
+    .prototype_value = { .object_value = { .value = njs_value(NJS_DATA, 0, 0.0),
+                                           .object = { .type = NJS_OBJECT } } },
+};
 
 
 static const njs_object_prop_t  njs_json_object_properties[] =
@@ -1707,6 +4203,14 @@ static const njs_object_prop_t  njs_json_object_properties[] =
         .writable = 1,
         .configurable = 1,
     },
+
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("createParser"),
+        .value = njs_native_function(njs_json_create_parser, 1),
+        .writable = 1,
+        .configurable = 1,
+    },
 };
 
 
@@ -8,7 +8,13 @@
 #define _NJS_JSON_H_INCLUDED_
 
 
+njs_int_t njs_json_view_create(njs_vm_t *vm, njs_value_t *args,
+    njs_uint_t nargs, njs_index_t unused);
+
+
 extern const njs_object_init_t  njs_json_object_init;
+extern const njs_object_type_init_t  njs_json_parser_type_init;
+extern const njs_object_type_init_t  njs_json_view_type_init;
 
 
 #endif /* _NJS_JSON_H_INCLUDED_ */
@@ -74,6 +74,7 @@
 
 #include <njs_fs.h>
 #include <njs_crypto.h>
+#include <njs_string_builder.h>
 
 #include <njs_event.h>
 #include <njs_extern.h>
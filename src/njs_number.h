@@ -142,15 +142,28 @@ njs_char_to_hex(u_char c)
     return c;
 }
 
+/*
+ * A decimal uint32_t always fits in a short string, so the conversion
+ * needs neither njs_dtoa() nor a memory allocation.
+ */
+
 njs_inline void
 njs_uint32_to_string(njs_value_t *value, uint32_t u32)
 {
-    u_char  *dst, *p;
+    u_char  *p, *end;
+    u_char  buf[NJS_INT32_T_LEN];
+
+    end = buf + NJS_INT32_T_LEN;
+    p = end;
+
+    do {
+        *(--p) = (u_char) (u32 % 10 + '0');
+        u32 /= 10;
+    } while (u32 != 0);
 
-    dst = njs_string_short_start(value);
-    p = njs_sprintf(dst, dst + NJS_STRING_SHORT, "%uD", u32);
+    memcpy(njs_string_short_start(value), p, end - p);
 
-    njs_string_short_set(value, p - dst, p - dst);
+    njs_string_short_set(value, end - p, end - p);
 }
 
 
@@ -11,6 +11,11 @@
 static njs_int_t njs_object_hash_test(njs_lvlhsh_query_t *lhq, void *data);
 static njs_object_prop_t *njs_object_exist_in_proto(const njs_object_t *begin,
     const njs_object_t *end, njs_lvlhsh_query_t *lhq);
+static njs_array_t *njs_object_own_keys_cached(njs_vm_t *vm,
+    const njs_object_t *object);
+static njs_array_t *njs_object_own_enumerate_items(njs_vm_t *vm,
+    const njs_object_t *object, njs_object_enum_t kind,
+    njs_object_enum_type_t type, njs_bool_t all);
 static uint32_t njs_object_enumerate_array_length(const njs_object_t *object);
 static uint32_t njs_object_enumerate_string_length(const njs_object_t *object);
 static uint32_t njs_object_enumerate_object_length(const njs_object_t *object,
@@ -58,6 +63,61 @@ njs_object_alloc(njs_vm_t *vm)
 }
 
 
+njs_object_t *
+njs_object_boilerplate_clone(njs_vm_t *vm,
+    const njs_object_boilerplate_t *boilerplate)
+{
+    size_t              size;
+    njs_int_t           ret;
+    njs_uint_t          i, n;
+    njs_object_t        *object;
+    njs_object_prop_t   *prop;
+    njs_lvlhsh_query_t  lhq;
+
+    n = boilerplate->items;
+
+    size = njs_align_size(sizeof(njs_object_t), sizeof(njs_value_t))
+           + n * sizeof(njs_object_prop_t);
+
+    object = njs_mp_align(vm->mem_pool, sizeof(njs_value_t), size);
+    if (njs_slow_path(object == NULL)) {
+        njs_memory_error(vm);
+        return NULL;
+    }
+
+    njs_lvlhsh_init(&object->hash);
+    njs_lvlhsh_init(&object->shared_hash);
+    object->__proto__ = &vm->prototypes[NJS_OBJ_TYPE_OBJECT].object;
+    object->type = NJS_OBJECT;
+    object->shared = 0;
+    object->extensible = 1;
+    object->error_data = 0;
+
+    prop = njs_object_boilerplate_props(object);
+
+    /* GC: retain. */
+    memcpy(prop, boilerplate->properties, n * sizeof(njs_object_prop_t));
+
+    lhq.replace = 0;
+    lhq.proto = &njs_object_hash_proto;
+    lhq.pool = vm->mem_pool;
+
+    for (i = 0; i < n; i++) {
+        njs_string_get(&prop[i].name, &lhq.key);
+        lhq.key_hash = boilerplate->hashes[i];
+        lhq.value = &prop[i];
+
+        ret = njs_lvlhsh_insert(&object->hash, &lhq);
+        if (njs_slow_path(ret != NJS_OK)) {
+            njs_internal_error(vm, "lvlhsh insert failed");
+            return NULL;
+        }
+    }
+
+    return object;
+}
+
+
 njs_object_t *
 njs_object_value_copy(njs_vm_t *vm, njs_value_t *value)
 {
@@ -421,6 +481,16 @@ next:
 }
 
 
+njs_inline njs_bool_t
+njs_object_enum_cacheable(const njs_object_t *object, njs_object_enum_t kind,
+    njs_object_enum_type_t type, njs_bool_t all)
+{
+    return (kind == NJS_ENUM_KEYS && type == NJS_ENUM_STRING && !all
+            && object->type == NJS_OBJECT
+            && njs_lvlhsh_is_empty(&object->shared_hash));
+}
+
+
 njs_inline uint32_t
 njs_object_enumerate_length(const njs_object_t *object,
     njs_object_enum_type_t type, njs_bool_t all)
@@ -558,13 +628,46 @@ object:
 }
 
 
+/*
+ * The array returned for keys of a plain object may be shared with
+ * the enumeration cache and must not be modified.
+ */
+
 njs_array_t *
 njs_object_enumerate(njs_vm_t *vm, const njs_object_t *object,
     njs_object_enum_t kind, njs_object_enum_type_t type, njs_bool_t all)
 {
-    uint32_t     length;
-    njs_int_t    ret;
-    njs_array_t  *items;
+    uint32_t            length;
+    njs_int_t           ret;
+    njs_array_t         *items;
+    const njs_object_t  *proto;
+
+    if (njs_object_enum_cacheable(object, kind, type, all)) {
+
+        for (proto = object->__proto__; proto != NULL; proto = proto->__proto__)
+        {
+            if (njs_object_enum_cacheable(proto, kind, type, all)) {
+                items = njs_object_own_keys_cached(vm, proto);
+                if (njs_slow_path(items == NULL)) {
+                    return NULL;
+                }
+
+                length = items->length;
+
+            } else {
+                length = njs_object_own_enumerate_length(proto, proto, type,
+                                                         all);
+            }
+
+            if (length != 0) {
+                goto enumerate;
+            }
+        }
+
+        return njs_object_own_keys_cached(vm, object);
+    }
+
+enumerate:
 
     length = njs_object_enumerate_length(object, type, all);
 
@@ -587,6 +690,65 @@ njs_object_enumerate(njs_vm_t *vm, const njs_object_t *object,
 njs_array_t *
 njs_object_own_enumerate(njs_vm_t *vm, const njs_object_t *object,
     njs_object_enum_t kind, njs_object_enum_type_t type, njs_bool_t all)
+{
+    njs_array_t  *keys, *items;
+
+    if (njs_object_enum_cacheable(object, kind, type, all)) {
+        keys = njs_object_own_keys_cached(vm, object);
+        if (njs_slow_path(keys == NULL)) {
+            return NULL;
+        }
+
+        items = njs_array_alloc(vm, keys->length, NJS_ARRAY_SPARE);
+        if (njs_slow_path(items == NULL)) {
+            return NULL;
+        }
+
+        memcpy(items->start, keys->start, keys->length * sizeof(njs_value_t));
+
+        return items;
+    }
+
+    return njs_object_own_enumerate_items(vm, object, kind, type, all);
+}
+
+
+/*
+ * Own enumerable string keys of plain objects are kept in a small
+ * direct-mapped per-VM cache.  An entry is dropped by
+ * njs_object_enum_cache_invalidate() whenever a property of the object
+ * is added, deleted or redefined.  Objects with a shared hash are not
+ * cached because their properties are copied to the private hash lazily.
+ */
+
+static njs_array_t *
+njs_object_own_keys_cached(njs_vm_t *vm, const njs_object_t *object)
+{
+    njs_array_t       *keys;
+    njs_enum_cache_t  *cache;
+
+    cache = njs_object_enum_cache(vm, object);
+
+    if (cache->object == object) {
+        return cache->keys;
+    }
+
+    keys = njs_object_own_enumerate_items(vm, object, NJS_ENUM_KEYS,
+                                          NJS_ENUM_STRING, 0);
+    if (njs_slow_path(keys == NULL)) {
+        return NULL;
+    }
+
+    cache->object = object;
+    cache->keys = keys;
+
+    return keys;
+}
+
+
+static njs_array_t *
+njs_object_own_enumerate_items(njs_vm_t *vm, const njs_object_t *object,
+    njs_object_enum_t kind, njs_object_enum_type_t type, njs_bool_t all)
 {
     uint32_t     length;
     njs_int_t    ret;
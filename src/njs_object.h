@@ -21,6 +21,25 @@ struct njs_object_init_s {
 };
 
 
+/*
+ * A boilerplate is a property table of an object literal with constant
+ * keys prepared by the generator.  The properties are cloned right after
+ * the object in a single allocation, values which are not constant are
+ * patched in later by NJS_VMCODE_PROPERTY_SLOT.
+ */
+
+struct njs_object_boilerplate_s {
+    njs_object_prop_t           *properties;
+    uint32_t                    *hashes;
+    njs_uint_t                  items;
+};
+
+
+#define njs_object_boilerplate_props(object)                                  \
+    ((njs_object_prop_t *) ((u_char *) (object)                               \
+               + njs_align_size(sizeof(njs_object_t), sizeof(njs_value_t))))
+
+
 typedef struct njs_traverse_s  njs_traverse_t;
 
 struct njs_traverse_s {
@@ -40,6 +59,8 @@ typedef njs_int_t (*njs_object_traverse_cb_t)(njs_vm_t *vm,
 
 
 njs_object_t *njs_object_alloc(njs_vm_t *vm);
+njs_object_t *njs_object_boilerplate_clone(njs_vm_t *vm,
+    const njs_object_boilerplate_t *boilerplate);
 njs_object_t *njs_object_value_copy(njs_vm_t *vm, njs_value_t *value);
 njs_object_t *njs_object_value_alloc(njs_vm_t *vm, const njs_value_t *value,
     njs_uint_t type);
@@ -103,6 +124,24 @@ njs_is_generic_descriptor(njs_object_prop_t *prop)
 }
 
 
+#define njs_object_enum_cache(vm, object)                                    \
+    (&(vm)->enum_cache[((uintptr_t) (object) >> 4)                           \
+                       & (NJS_ENUM_CACHE_SIZE - 1)])
+
+
+njs_inline void
+njs_object_enum_cache_invalidate(njs_vm_t *vm, const njs_object_t *object)
+{
+    njs_enum_cache_t  *cache;
+
+    cache = njs_object_enum_cache(vm, object);
+
+    if (cache->object == object) {
+        cache->object = NULL;
+    }
+}
+
+
 njs_inline void
 njs_object_property_key_set(njs_lvlhsh_query_t *lhq, const njs_value_t *key,
     uint32_t hash)
@@ -143,6 +182,8 @@ njs_inline njs_int_t
 njs_primitive_value_to_key(njs_vm_t *vm, njs_value_t *dst,
     const njs_value_t *src)
 {
+    double             num;
+    uint32_t           u32;
     const njs_value_t  *value;
 
     switch (src->type) {
@@ -160,6 +201,15 @@ njs_primitive_value_to_key(njs_vm_t *vm, njs_value_t *dst,
         break;
 
     case NJS_NUMBER:
+        num = njs_number(src);
+        u32 = (uint32_t) num;
+
+        if (njs_fast_path(u32 == num)) {
+            /* Integer keys, -0 included, have the canonical decimal form. */
+            njs_uint32_to_string(dst, u32);
+            return NJS_OK;
+        }
+
         return njs_number_to_string(vm, dst, src);
 
     case NJS_SYMBOL:
@@ -430,6 +430,24 @@
         'S'), 't'), 'r'), 'i'), 'n'), 'g')
 
 
+#define NJS_STRING_BUILDER_HASH                                               \
+    njs_djb_hash_add(                                                         \
+    njs_djb_hash_add(                                                         \
+    njs_djb_hash_add(                                                         \
+    njs_djb_hash_add(                                                         \
+    njs_djb_hash_add(                                                         \
+    njs_djb_hash_add(                                                         \
+    njs_djb_hash_add(                                                         \
+    njs_djb_hash_add(                                                         \
+    njs_djb_hash_add(                                                         \
+    njs_djb_hash_add(                                                         \
+    njs_djb_hash_add(                                                         \
+    njs_djb_hash_add(                                                         \
+    njs_djb_hash_add(NJS_DJB_HASH_INIT,                                       \
+        'S'), 't'), 'r'), 'i'), 'n'), 'g'),                                   \
+        'B'), 'u'), 'i'), 'l'), 'd'), 'e'), 'r')
+
+
 #define NJS_SYMBOL_HASH                                                       \
     njs_djb_hash_add(                                                         \
     njs_djb_hash_add(                                                         \
@@ -123,6 +123,8 @@ njs_object_prop_define(njs_vm_t *vm, njs_value_t *object,
         return ret;
     }
 
+    njs_object_enum_cache_invalidate(vm, njs_object(object));
+
     prop = njs_object_prop_alloc(vm, name, &njs_value_invalid,
                                  NJS_ATTRIBUTE_UNSET);
     if (njs_slow_path(prop == NULL)) {
@@ -12,11 +12,31 @@ static void *njs_pcre_malloc(size_t size);
 static void njs_pcre_free(void *p);
 static void *njs_pcre_default_malloc(size_t size, void *memory_data);
 static void njs_pcre_default_free(void *p, void *memory_data);
+#ifdef PCRE_CONFIG_JIT
+static void njs_pcre_jit_stack_assign(njs_regex_t *regex);
+#endif
 
 
 static njs_regex_context_t  *regex_context;
 
 
+#ifdef PCRE_CONFIG_JIT
+
+/*
+ * The JIT stack is shared by all the regexps of the process.  It is
+ * allocated on the first JIT compilation and grows on demand up to
+ * the maximum size.  If the allocation fails, the JIT code uses
+ * the default 32K stack on the machine stack.
+ */
+
+#define NJS_PCRE_JIT_STACK_MIN  (32 * 1024)
+#define NJS_PCRE_JIT_STACK_MAX  (1024 * 1024)
+
+static pcre_jit_stack       *njs_pcre_jit_stack;
+
+#endif
+
+
 njs_regex_context_t *
 njs_regex_context_create(njs_pcre_malloc_t private_malloc,
     njs_pcre_free_t private_free, void *memory_data)
@@ -91,7 +111,12 @@ njs_regex_compile(njs_regex_t *regex, u_char *source, size_t len,
         goto done;
     }
 
+#ifdef PCRE_CONFIG_JIT
+    /* The option is ignored if JIT support is not available. */
+    regex->extra = pcre_study(regex->code, PCRE_STUDY_JIT_COMPILE, &errstr);
+#else
     regex->extra = pcre_study(regex->code, 0, &errstr);
+#endif
 
     if (njs_slow_path(errstr != NULL)) {
         njs_alert(ctx->trace, NJS_LEVEL_ERROR,
@@ -168,10 +193,74 @@ done:
     pcre_free = saved_free;
     regex_context = NULL;
 
+#ifdef PCRE_CONFIG_JIT
+    if (ret == NJS_OK && regex->extra != NULL) {
+        njs_pcre_jit_stack_assign(regex);
+    }
+#endif
+
     return ret;
 }
 
 
+#ifdef PCRE_CONFIG_JIT
+
+static void
+njs_pcre_jit_stack_assign(njs_regex_t *regex)
+{
+    int  err, jit;
+
+    err = pcre_fullinfo(regex->code, regex->extra, PCRE_INFO_JIT, &jit);
+
+    if (err < 0 || jit == 0) {
+        return;
+    }
+
+    if (njs_pcre_jit_stack == NULL) {
+        /* The stack is allocated with the default pcre_malloc(). */
+
+        njs_pcre_jit_stack = pcre_jit_stack_alloc(NJS_PCRE_JIT_STACK_MIN,
+                                                  NJS_PCRE_JIT_STACK_MAX);
+        if (njs_slow_path(njs_pcre_jit_stack == NULL)) {
+            return;
+        }
+    }
+
+    pcre_assign_jit_stack(regex->extra, NULL, njs_pcre_jit_stack);
+}
+
+#endif
+
+
+void
+njs_regex_free(njs_regex_t *regex, njs_regex_context_t *ctx)
+{
+    void  (*saved_free)(void *p);
+
+    saved_free = pcre_free;
+    pcre_free = njs_pcre_free;
+    regex_context = ctx;
+
+    if (regex->extra != NULL) {
+#ifdef PCRE_CONFIG_JIT
+        pcre_free_study(regex->extra);
+#else
+        pcre_free(regex->extra);
+#endif
+    }
+
+    if (regex->code != NULL) {
+        pcre_free(regex->code);
+    }
+
+    regex->code = NULL;
+    regex->extra = NULL;
+
+    pcre_free = saved_free;
+    regex_context = NULL;
+}
+
+
 njs_bool_t
 njs_regex_is_valid(njs_regex_t *regex)
 {
@@ -280,13 +369,21 @@ njs_pcre_default_free(void *p, void *memory_data)
 
 
 njs_int_t
-njs_regex_match(njs_regex_t *regex, const u_char *subject, size_t len,
-    njs_regex_match_data_t *match_data, njs_regex_context_t *ctx)
+njs_regex_match(njs_regex_t *regex, const u_char *subject, size_t off,
+    size_t len, njs_regex_match_data_t *match_data, njs_regex_context_t *ctx)
 {
-    int  ret;
+    int  ret, options;
+
+    /*
+     * The subject has already been validated by a preceding call
+     * with zero offset, the UTF-8 check would be quadratic otherwise.
+     */
+
+    options = (off != 0) ? PCRE_NO_UTF8_CHECK : 0;
 
     ret = pcre_exec(regex->code, regex->extra, (const char *) subject, len,
-                    0, 0, match_data->captures, match_data->ncaptures);
+                    off, options, match_data->captures,
+                    match_data->ncaptures);
 
     /* PCRE_ERROR_NOMATCH is -1. */
 
@@ -29,6 +29,7 @@ NJS_EXPORT njs_regex_context_t *
     njs_pcre_free_t private_free, void *memory_data);
 NJS_EXPORT njs_int_t njs_regex_compile(njs_regex_t *regex, u_char *source,
     size_t len, njs_uint_t options, njs_regex_context_t *ctx);
+NJS_EXPORT void njs_regex_free(njs_regex_t *regex, njs_regex_context_t *ctx);
 NJS_EXPORT njs_bool_t njs_regex_is_valid(njs_regex_t *regex);
 NJS_EXPORT njs_uint_t njs_regex_ncaptures(njs_regex_t *regex);
 NJS_EXPORT njs_uint_t njs_regex_backrefs(njs_regex_t *regex);
@@ -39,7 +40,8 @@ NJS_EXPORT njs_regex_match_data_t *njs_regex_match_data(njs_regex_t *regex,
 NJS_EXPORT void njs_regex_match_data_free(njs_regex_match_data_t *match_data,
     njs_regex_context_t *ctx);
 NJS_EXPORT njs_int_t njs_regex_match(njs_regex_t *regex, const u_char *subject,
-    size_t len, njs_regex_match_data_t *match_data, njs_regex_context_t *ctx);
+    size_t off, size_t len, njs_regex_match_data_t *match_data,
+    njs_regex_context_t *ctx);
 NJS_EXPORT int *njs_regex_captures(njs_regex_match_data_t *match_data);
 
 
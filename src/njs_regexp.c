@@ -15,6 +15,61 @@ struct njs_regexp_group_s {
 };
 
 
+/*
+ * Patterns created from strings at run time are kept in the cache shared
+ * by a VM and its clones, so they are compiled once instead of once per
+ * clone.  The cache memory is allocated from the pool of the VM which
+ * created the shared part.  A pattern evicted from the cache is freed only
+ * when the last VM referencing it is destroyed.
+ *
+ * The compiled code of a pattern may include JIT code which is not
+ * allocated from a memory pool, so the patterns are freed explicitly
+ * when the VM owning them is destroyed.
+ */
+
+#define NJS_REGEXP_CACHE_SIZE  256
+
+
+typedef struct {
+    njs_queue_link_t      link;
+
+    njs_regexp_pattern_t  *pattern;
+    njs_str_t             text;
+
+    /* The VM that referenced the entry recently. */
+    njs_vm_t              *vm;
+    njs_uint_t            refs;
+
+    uint8_t               flags;
+    uint8_t               evicted;      /* 1 bit */
+} njs_regexp_cache_entry_t;
+
+
+struct njs_regexp_cache_s {
+    njs_mp_t              *pool;
+    njs_regex_context_t   *regex_context;
+
+    /* A hash for each combination of flags. */
+    njs_lvlhsh_t          hash[(NJS_REGEXP_GLOBAL | NJS_REGEXP_IGNORE_CASE
+                                | NJS_REGEXP_MULTILINE) + 1];
+
+    /* The least recently used entry is the last one. */
+    njs_queue_t           lru;
+
+    njs_uint_t            size;
+    njs_uint_t            max;
+
+    uint64_t              hits;
+    uint64_t              misses;
+};
+
+
+struct njs_regexp_cache_ref_s {
+    njs_regexp_cache_entry_t  *entry;
+    njs_regexp_cache_ref_t    *next;
+};
+
+
 static void *njs_regexp_malloc(size_t size, void *memory_data);
 static void njs_regexp_free(void *p, void *memory_data);
 static njs_regexp_flags_t njs_regexp_flags(u_char **start, u_char *end,
@@ -22,19 +77,46 @@ static njs_regexp_flags_t njs_regexp_flags(u_char **start, u_char *end,
 static njs_int_t njs_regexp_prototype_source(njs_vm_t *vm,
     njs_object_prop_t *prop, njs_value_t *value, njs_value_t *setval,
     njs_value_t *retval);
+static njs_regexp_pattern_t *njs_regexp_pattern_alloc(njs_vm_t *vm,
+    njs_mp_t *mp, njs_regex_context_t *ctx, u_char *start, size_t length,
+    njs_regexp_flags_t flags, njs_bool_t prewarm);
+static void njs_regexp_pattern_free(njs_regexp_pattern_t *pattern,
+    njs_mp_t *mp, njs_regex_context_t *ctx);
 static int njs_regexp_pattern_compile(njs_vm_t *vm, njs_regex_t *regex,
-    u_char *source, int options);
+    u_char *source, int options, njs_regex_context_t *ctx);
+static void njs_regexp_pattern_compile_lazy(njs_vm_t *vm,
+    njs_regexp_pattern_t *pattern, njs_uint_t type);
+static njs_int_t njs_regexp_literals(njs_vm_t *vm, njs_mp_t *mp,
+    njs_regexp_pattern_t *pattern, const u_char *start, const u_char *end);
+static njs_int_t njs_regexp_literals_match(njs_regexp_literals_t *literals,
+    const u_char *subject, size_t off, size_t len,
+    njs_regex_match_data_t *match_data);
+static njs_int_t njs_regexp_cache_test(njs_lvlhsh_query_t *lhq, void *data);
+static void njs_regexp_cache_evict(njs_regexp_cache_t *cache);
+static void njs_regexp_cache_release(njs_vm_t *vm);
 static u_char *njs_regexp_compile_trace_handler(njs_trace_t *trace,
     njs_trace_data_t *td, u_char *start);
 static u_char *njs_regexp_match_trace_handler(njs_trace_t *trace,
     njs_trace_data_t *td, u_char *start);
+static njs_regex_match_data_t *njs_regexp_match_data(njs_vm_t *vm,
+    njs_regex_t *regex);
 static njs_int_t njs_regexp_exec_result(njs_vm_t *vm, njs_regexp_t *regexp,
-    njs_utf8_t utf8, u_char *string, njs_regex_match_data_t *match_data,
-    uint32_t last_index);
+    njs_utf8_t utf8, njs_string_prop_t *string,
+    njs_regex_match_data_t *match_data);
 static njs_int_t njs_regexp_string_create(njs_vm_t *vm, njs_value_t *value,
     u_char *start, uint32_t size, int32_t length);
 
 
+static const njs_lvlhsh_proto_t  njs_regexp_cache_proto
+    njs_aligned(64) =
+{
+    NJS_LVLHSH_DEFAULT,
+    njs_regexp_cache_test,
+    njs_lvlhsh_alloc,
+    njs_lvlhsh_free,
+};
+
+
 njs_int_t
 njs_regexp_init(njs_vm_t *vm)
 {
@@ -53,6 +135,9 @@ njs_regexp_init(njs_vm_t *vm)
 
     vm->regex_context->trace = &vm->trace;
 
+    vm->match_data = NULL;
+    vm->match_data_ncaptures = 0;
+
     return NJS_OK;
 }
 
@@ -182,7 +267,7 @@ njs_regexp_create(njs_vm_t *vm, njs_value_t *value, u_char *start,
     njs_regexp_pattern_t  *pattern;
 
     if (length != 0) {
-        pattern = njs_regexp_pattern_create(vm, start, length, flags);
+        pattern = njs_regexp_pattern_cached(vm, start, length, flags);
         if (njs_slow_path(pattern == NULL)) {
             return NJS_ERROR;
         }
@@ -475,6 +560,25 @@ invalid:
 njs_regexp_pattern_t *
 njs_regexp_pattern_create(njs_vm_t *vm, u_char *start, size_t length,
     njs_regexp_flags_t flags)
+{
+    njs_regexp_pattern_t  *pattern;
+
+    pattern = njs_regexp_pattern_alloc(vm, vm->mem_pool, vm->regex_context,
+                                       start, length, flags,
+                                       vm->options.regexp_prewarm);
+
+    if (njs_fast_path(pattern != NULL)) {
+        pattern->next = vm->regexp_patterns;
+        vm->regexp_patterns = pattern;
+    }
+
+    return pattern;
+}
+
+
+static njs_regexp_pattern_t *
+njs_regexp_pattern_alloc(njs_vm_t *vm, njs_mp_t *mp, njs_regex_context_t *ctx,
+    u_char *start, size_t length, njs_regexp_flags_t flags, njs_bool_t prewarm)
 {
     int                   options, ret;
     u_char                *p, *end;
@@ -498,8 +602,8 @@ njs_regexp_pattern_create(njs_vm_t *vm, u_char *start, size_t length,
         return NULL;
     }
 
-    pattern = njs_mp_zalloc(vm->mem_pool, sizeof(njs_regexp_pattern_t) + 1
-                                          + text.length + size + 1);
+    pattern = njs_mp_zalloc(mp, sizeof(njs_regexp_pattern_t) + 1
+                                + text.length + size + 1);
     if (njs_slow_path(pattern == NULL)) {
         njs_memory_error(vm);
         return NULL;
@@ -542,41 +646,58 @@ njs_regexp_pattern_create(njs_vm_t *vm, u_char *start, size_t length,
 
     *p++ = '\0';
 
-    ret = njs_regexp_pattern_compile(vm, &pattern->regex[0],
-                                     &pattern->source[1], options);
-
-    if (njs_fast_path(ret >= 0)) {
-        pattern->ncaptures = ret;
+    pattern->options = options;
+    pattern->regex_context = ctx;
 
-    } else if (ret < 0 && ret != NJS_DECLINED) {
-        goto fail;
-    }
+    /*
+     * Most of the strings are UTF-8 strings, so the UTF-8 variant
+     * is compiled first and the byte string variant is compiled
+     * on first use.  The byte string variant is compiled at once
+     * if the pattern is not a valid UTF-8 one or if it is required
+     * to compile both variants in advance.
+     */
 
     ret = njs_regexp_pattern_compile(vm, &pattern->regex[1],
-                                     &pattern->source[1], options | PCRE_UTF8);
+                                     &pattern->source[1], options | PCRE_UTF8,
+                                     ctx);
     if (njs_fast_path(ret >= 0)) {
-
-        if (njs_slow_path(njs_regex_is_valid(&pattern->regex[0])
-                          && (u_int) ret != pattern->ncaptures))
-        {
-            njs_internal_error(vm, "regexp pattern compile failed");
-            goto fail;
-        }
-
         pattern->ncaptures = ret;
 
     } else if (ret != NJS_DECLINED) {
         goto fail;
     }
 
-    if (njs_regex_is_valid(&pattern->regex[0])) {
-        regex = &pattern->regex[0];
-
-    } else if (njs_regex_is_valid(&pattern->regex[1])) {
+    if (!prewarm && njs_regex_is_valid(&pattern->regex[1])) {
+        pattern->lazy = (1 << NJS_REGEXP_BYTE);
         regex = &pattern->regex[1];
 
     } else {
-        goto fail;
+        ret = njs_regexp_pattern_compile(vm, &pattern->regex[0],
+                                         &pattern->source[1], options, ctx);
+        if (njs_fast_path(ret >= 0)) {
+
+            if (njs_slow_path(njs_regex_is_valid(&pattern->regex[1])
+                              && (u_int) ret != pattern->ncaptures))
+            {
+                njs_internal_error(vm, "regexp pattern compile failed");
+                goto fail;
+            }
+
+            pattern->ncaptures = ret;
+
+        } else if (ret != NJS_DECLINED) {
+            goto fail;
+        }
+
+        if (njs_regex_is_valid(&pattern->regex[1])) {
+            regex = &pattern->regex[1];
+
+        } else if (njs_regex_is_valid(&pattern->regex[0])) {
+            regex = &pattern->regex[0];
+
+        } else {
+            goto fail;
+        }
     }
 
     *end = '/';
@@ -586,10 +707,10 @@ njs_regexp_pattern_create(njs_vm_t *vm, u_char *start, size_t length,
     if (pattern->ngroups != 0) {
         size = sizeof(njs_regexp_group_t) * pattern->ngroups;
 
-        pattern->groups = njs_mp_alloc(vm->mem_pool, size);
+        pattern->groups = njs_mp_alloc(mp, size);
         if (njs_slow_path(pattern->groups == NULL)) {
             njs_memory_error(vm);
-            return NULL;
+            goto fail;
         }
 
         n = 0;
@@ -605,20 +726,460 @@ njs_regexp_pattern_create(njs_vm_t *vm, u_char *start, size_t length,
         } while (n != pattern->ngroups);
     }
 
+    ret = njs_regexp_literals(vm, mp, pattern, &pattern->source[1], end);
+    if (njs_slow_path(ret != NJS_OK)) {
+        goto fail;
+    }
+
     njs_set_undefined(&vm->retval);
 
     return pattern;
 
 fail:
 
-    njs_mp_free(vm->mem_pool, pattern);
+    njs_regexp_pattern_free(pattern, mp, ctx);
+
+    return NULL;
+}
+
+
+static void
+njs_regexp_pattern_free(njs_regexp_pattern_t *pattern, njs_mp_t *mp,
+    njs_regex_context_t *ctx)
+{
+    njs_regex_free(&pattern->regex[0], ctx);
+    njs_regex_free(&pattern->regex[1], ctx);
+
+    if (pattern->groups != NULL) {
+        njs_mp_free(mp, pattern->groups);
+    }
+
+    if (pattern->literals != NULL) {
+        njs_mp_free(mp, pattern->literals);
+    }
+
+    njs_mp_free(mp, pattern);
+}
+
+
+/*
+ * The literal characters are all the characters except the metacharacters
+ * and the characters escaped with a backslash which are not letters
+ * or digits.  Letters and digits are escape sequences like "\d" or "\n".
+ */
+
+njs_inline njs_bool_t
+njs_regexp_is_meta(u_char c)
+{
+    switch (c) {
+    case '\\':
+    case '^':
+    case '$':
+    case '.':
+    case '|':
+    case '?':
+    case '*':
+    case '+':
+    case '(':
+    case ')':
+    case '[':
+    case ']':
+    case '{':
+    case '}':
+        return 1;
+
+    default:
+        return 0;
+    }
+}
+
+
+njs_inline njs_bool_t
+njs_regexp_is_escaped_literal(u_char c)
+{
+    return (c >= 0x21 && c <= 0x7e
+            && !(c >= '0' && c <= '9')
+            && !((c | 0x20) >= 'a' && (c | 0x20) <= 'z'));
+}
+
+
+static njs_int_t
+njs_regexp_literals(njs_vm_t *vm, njs_mp_t *mp, njs_regexp_pattern_t *pattern,
+    const u_char *start, const u_char *end)
+{
+    u_char                 *dst;
+    size_t                 size, length;
+    njs_str_t              *literal;
+    njs_uint_t             n;
+    const u_char           *p;
+    njs_regexp_match_t     type;
+    njs_regexp_literals_t  *literals;
+
+    if (pattern->ignore_case || start == end) {
+        return NJS_OK;
+    }
+
+    type = NJS_REGEXP_MATCH_LITERAL;
+
+    if (*start == '^') {
+        if (pattern->multiline) {
+            return NJS_OK;
+        }
+
+        type = NJS_REGEXP_MATCH_PREFIX;
+        start++;
+    }
+
+    /* The first pass checks the pattern and counts the literals. */
+
+    n = 1;
+    size = 0;
+    length = 0;
+
+    for (p = start; p < end; p++) {
+
+        if (*p == '|') {
+            if (length == 0 || type == NJS_REGEXP_MATCH_PREFIX) {
+                return NJS_OK;
+            }
+
+            n++;
+            length = 0;
+            continue;
+        }
+
+        if (*p == '\\') {
+            if (p + 1 == end || !njs_regexp_is_escaped_literal(p[1])) {
+                return NJS_OK;
+            }
+
+            p++;
+
+        } else if (njs_regexp_is_meta(*p)) {
+            return NJS_OK;
+        }
+
+        length++;
+        size++;
+    }
+
+    if (length == 0) {
+        return NJS_OK;
+    }
+
+    if (n > 1) {
+        type = NJS_REGEXP_MATCH_ALTERNATION;
+    }
+
+    literals = njs_mp_zalloc(mp, sizeof(njs_regexp_literals_t)
+                                 + n * sizeof(njs_str_t) + size);
+    if (njs_slow_path(literals == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    literals->type = type;
+    literals->n = n;
+    literals->literal = (njs_str_t *) ((u_char *) literals
+                                       + sizeof(njs_regexp_literals_t));
+
+    literal = literals->literal;
+    dst = (u_char *) &literal[n];
+    literal->start = dst;
+
+    for (p = start; p < end; p++) {
+
+        if (*p == '|') {
+            literal->length = dst - literal->start;
+            literal++;
+            literal->start = dst;
+            continue;
+        }
+
+        if (*p == '\\') {
+            p++;
+        }
+
+        *dst++ = *p;
+    }
+
+    literal->length = dst - literal->start;
+
+    pattern->literals = literals;
+
+    return NJS_OK;
+}
+
+
+njs_regexp_cache_t *
+njs_regexp_cache_create(njs_vm_t *vm)
+{
+    njs_uint_t          i;
+    njs_regexp_cache_t  *cache;
+
+    cache = njs_mp_zalloc(vm->mem_pool, sizeof(njs_regexp_cache_t));
+    if (njs_slow_path(cache == NULL)) {
+        return NULL;
+    }
+
+    cache->pool = vm->mem_pool;
+
+    cache->regex_context = njs_regex_context_create(njs_regexp_malloc,
+                                                    njs_regexp_free,
+                                                    vm->mem_pool);
+    if (njs_slow_path(cache->regex_context == NULL)) {
+        return NULL;
+    }
+
+    for (i = 0; i < njs_nitems(cache->hash); i++) {
+        njs_lvlhsh_init(&cache->hash[i]);
+    }
+
+    njs_queue_init(&cache->lru);
+
+    cache->max = vm->options.regexp_cache_size;
+
+    if (cache->max == 0) {
+        cache->max = NJS_REGEXP_CACHE_SIZE;
+    }
+
+    return cache;
+}
+
+
+njs_regexp_pattern_t *
+njs_regexp_pattern_cached(njs_vm_t *vm, u_char *start, size_t length,
+    njs_regexp_flags_t flags)
+{
+    njs_int_t                 ret;
+    njs_regexp_cache_t        *cache;
+    njs_lvlhsh_query_t        lhq;
+    njs_regexp_pattern_t      *pattern;
+    njs_regexp_cache_ref_t    *ref;
+    njs_regexp_cache_entry_t  *entry;
+
+    cache = vm->shared->regexp_cache;
+
+    lhq.key.start = start;
+    lhq.key.length = length;
+    lhq.key_hash = njs_djb_hash(start, length);
+    lhq.proto = &njs_regexp_cache_proto;
+
+    ret = njs_lvlhsh_find(&cache->hash[flags], &lhq);
+
+    if (ret == NJS_OK) {
+        cache->hits++;
+
+        entry = lhq.value;
+
+        njs_queue_remove(&entry->link);
+
+    } else {
+        cache->misses++;
+
+        /* Compilation errors are reported by the VM compiling the pattern. */
+        cache->regex_context->trace = &vm->trace;
+
+        pattern = njs_regexp_pattern_alloc(vm, cache->pool,
+                                           cache->regex_context, start, length,
+                                           flags, 0);
+        if (njs_slow_path(pattern == NULL)) {
+            return NULL;
+        }
+
+        entry = njs_mp_zalloc(cache->pool,
+                              sizeof(njs_regexp_cache_entry_t) + length);
+        if (njs_slow_path(entry == NULL)) {
+            njs_regexp_pattern_free(pattern, cache->pool, cache->regex_context);
+            goto memory_error;
+        }
+
+        entry->pattern = pattern;
+        entry->flags = flags;
+        entry->text.start = (u_char *) entry + sizeof(njs_regexp_cache_entry_t);
+        entry->text.length = length;
+        memcpy(entry->text.start, start, length);
+
+        lhq.key = entry->text;
+        lhq.value = entry;
+        lhq.replace = 0;
+        lhq.pool = cache->pool;
+
+        ret = njs_lvlhsh_insert(&cache->hash[flags], &lhq);
+        if (njs_slow_path(ret != NJS_OK)) {
+            njs_regexp_pattern_free(pattern, cache->pool, cache->regex_context);
+            njs_mp_free(cache->pool, entry);
+            goto memory_error;
+        }
+
+        if (cache->size == cache->max) {
+            njs_regexp_cache_evict(cache);
+
+        } else {
+            cache->size++;
+        }
+    }
+
+    njs_queue_insert_head(&cache->lru, &entry->link);
+
+    if (entry->vm != vm) {
+        ref = njs_mp_alloc(vm->mem_pool, sizeof(njs_regexp_cache_ref_t));
+        if (njs_slow_path(ref == NULL)) {
+            goto memory_error;
+        }
+
+        ref->entry = entry;
+        ref->next = vm->regexp_cache_refs;
+        vm->regexp_cache_refs = ref;
+
+        entry->vm = vm;
+        entry->refs++;
+    }
+
+    return entry->pattern;
+
+memory_error:
+
+    njs_memory_error(vm);
+
     return NULL;
 }
 
 
+static njs_int_t
+njs_regexp_cache_test(njs_lvlhsh_query_t *lhq, void *data)
+{
+    njs_regexp_cache_entry_t  *entry;
+
+    entry = data;
+
+    if (njs_strstr_eq(&lhq->key, &entry->text)) {
+        return NJS_OK;
+    }
+
+    return NJS_DECLINED;
+}
+
+
+static void
+njs_regexp_cache_evict(njs_regexp_cache_t *cache)
+{
+    njs_queue_link_t          *link;
+    njs_lvlhsh_query_t        lhq;
+    njs_regexp_cache_entry_t  *entry;
+
+    link = njs_queue_last(&cache->lru);
+    entry = njs_queue_link_data(link, njs_regexp_cache_entry_t, link);
+
+    njs_queue_remove(link);
+
+    lhq.key = entry->text;
+    lhq.key_hash = njs_djb_hash(entry->text.start, entry->text.length);
+    lhq.proto = &njs_regexp_cache_proto;
+    lhq.pool = cache->pool;
+
+    (void) njs_lvlhsh_delete(&cache->hash[entry->flags], &lhq);
+
+    if (entry->refs != 0) {
+        entry->evicted = 1;
+        return;
+    }
+
+    njs_regexp_pattern_free(entry->pattern, cache->pool, cache->regex_context);
+    njs_mp_free(cache->pool, entry);
+}
+
+
+void
+njs_regexp_release(njs_vm_t *vm)
+{
+    njs_queue_t               *lru;
+    njs_queue_link_t          *link;
+    njs_regexp_cache_t        *cache;
+    njs_regexp_pattern_t      *pattern;
+    njs_regexp_cache_entry_t  *entry;
+
+    njs_regexp_cache_release(vm);
+
+    for (pattern = vm->regexp_patterns; pattern != NULL;
+         pattern = pattern->next)
+    {
+        njs_regex_free(&pattern->regex[0], vm->regex_context);
+        njs_regex_free(&pattern->regex[1], vm->regex_context);
+    }
+
+    vm->regexp_patterns = NULL;
+
+    cache = (vm->shared != NULL) ? vm->shared->regexp_cache : NULL;
+
+    if (cache == NULL || cache->pool != vm->mem_pool) {
+        return;
+    }
+
+    /* The VM created the cache. */
+
+    lru = &cache->lru;
+
+    for (link = njs_queue_first(lru);
+         link != njs_queue_tail(lru);
+         link = njs_queue_next(link))
+    {
+        entry = njs_queue_link_data(link, njs_regexp_cache_entry_t, link);
+
+        njs_regex_free(&entry->pattern->regex[0], cache->regex_context);
+        njs_regex_free(&entry->pattern->regex[1], cache->regex_context);
+    }
+}
+
+
+static void
+njs_regexp_cache_release(njs_vm_t *vm)
+{
+    njs_regexp_cache_t        *cache;
+    njs_regexp_cache_ref_t    *ref;
+    njs_regexp_cache_entry_t  *entry;
+
+    if (vm->regexp_cache_refs == NULL) {
+        return;
+    }
+
+    cache = vm->shared->regexp_cache;
+
+    for (ref = vm->regexp_cache_refs; ref != NULL; ref = ref->next) {
+        entry = ref->entry;
+
+        if (entry->vm == vm) {
+            entry->vm = NULL;
+        }
+
+        if (--entry->refs == 0 && entry->evicted) {
+            njs_regexp_pattern_free(entry->pattern, cache->pool,
+                                    cache->regex_context);
+            njs_mp_free(cache->pool, entry);
+        }
+    }
+
+    vm->regexp_cache_refs = NULL;
+}
+
+
+void
+njs_vm_regexp_cache_stat(njs_vm_t *vm, njs_vm_regexp_cache_stat_t *stat)
+{
+    njs_regexp_cache_t  *cache;
+
+    cache = vm->shared->regexp_cache;
+
+    stat->size = cache->size;
+    stat->max = cache->max;
+    stat->hits = cache->hits;
+    stat->misses = cache->misses;
+}
+
+
 static int
 njs_regexp_pattern_compile(njs_vm_t *vm, njs_regex_t *regex, u_char *source,
-    int options)
+    int options, njs_regex_context_t *ctx)
 {
     njs_int_t            ret;
     njs_trace_handler_t  handler;
@@ -627,7 +1188,7 @@ njs_regexp_pattern_compile(njs_vm_t *vm, njs_regex_t *regex, u_char *source,
     vm->trace.handler = njs_regexp_compile_trace_handler;
 
     /* Zero length means a zero-terminated string. */
-    ret = njs_regex_compile(regex, source, 0, options, vm->regex_context);
+    ret = njs_regex_compile(regex, source, 0, options, ctx);
 
     vm->trace.handler = handler;
 
@@ -639,6 +1200,82 @@ njs_regexp_pattern_compile(njs_vm_t *vm, njs_regex_t *regex, u_char *source,
 }
 
 
+njs_bool_t
+njs_regexp_pattern_valid(njs_vm_t *vm, njs_regexp_pattern_t *pattern,
+    njs_uint_t type)
+{
+    if (njs_slow_path(pattern->lazy & (1 << type))) {
+        njs_regexp_pattern_compile_lazy(vm, pattern, type);
+    }
+
+    return njs_regex_is_valid(&pattern->regex[type]);
+}
+
+
+/*
+ * A pattern may be shared by the clones of the VM, so the variant
+ * is compiled with the context of the VM which created the pattern.
+ * A variant which fails to compile does not match, the same as
+ * a variant which fails to compile along with the pattern.
+ */
+
+static void
+njs_regexp_pattern_compile_lazy(njs_vm_t *vm, njs_regexp_pattern_t *pattern,
+    njs_uint_t type)
+{
+    int                  options;
+    size_t               length;
+    u_char               *source;
+    njs_int_t            ret;
+    njs_regex_t          *regex;
+    njs_value_t          retval;
+    njs_trace_t          *trace;
+    njs_regex_context_t  *ctx;
+    njs_trace_handler_t  handler;
+
+    pattern->lazy &= ~(1 << type);
+
+    options = pattern->options;
+
+    if (type == NJS_REGEXP_UTF8) {
+        options |= PCRE_UTF8;
+    }
+
+    /* The source is stored as "/pattern/flags". */
+    source = &pattern->source[1];
+    length = njs_strlen(pattern->source) - pattern->flags - 1;
+
+    if (length == 0) {
+        /* Zero length means a zero-terminated string. */
+        source = (u_char *) "";
+    }
+
+    regex = &pattern->regex[type];
+    ctx = pattern->regex_context;
+
+    retval = vm->retval;
+    trace = ctx->trace;
+    handler = vm->trace.handler;
+
+    ctx->trace = &vm->trace;
+    vm->trace.handler = njs_regexp_compile_trace_handler;
+
+    ret = njs_regex_compile(regex, source, length, options, ctx);
+
+    vm->trace.handler = handler;
+    ctx->trace = trace;
+    vm->retval = retval;
+
+    if (njs_fast_path(ret == NJS_OK
+                      && njs_regex_ncaptures(regex) == pattern->ncaptures))
+    {
+        return;
+    }
+
+    njs_regex_free(regex, ctx);
+}
+
+
 static u_char *
 njs_regexp_compile_trace_handler(njs_trace_t *trace, njs_trace_data_t *td,
     u_char *start)
@@ -664,16 +1301,23 @@ njs_regexp_compile_trace_handler(njs_trace_t *trace, njs_trace_data_t *td,
 
 
 njs_int_t
-njs_regexp_match(njs_vm_t *vm, njs_regex_t *regex, const u_char *subject,
-    size_t len, njs_regex_match_data_t *match_data)
+njs_regexp_match(njs_vm_t *vm, njs_regexp_pattern_t *pattern,
+    njs_uint_t type, const u_char *subject, size_t off, size_t len,
+    njs_regex_match_data_t *match_data)
 {
     njs_int_t            ret;
     njs_trace_handler_t  handler;
 
+    if (pattern->literals != NULL) {
+        return njs_regexp_literals_match(pattern->literals, subject, off, len,
+                                         match_data);
+    }
+
     handler = vm->trace.handler;
     vm->trace.handler = njs_regexp_match_trace_handler;
 
-    ret = njs_regex_match(regex, subject, len, match_data, vm->regex_context);
+    ret = njs_regex_match(&pattern->regex[type], subject, off, len,
+                          match_data, vm->regex_context);
 
     vm->trace.handler = handler;
 
@@ -681,6 +1325,98 @@ njs_regexp_match(njs_vm_t *vm, njs_regex_t *regex, const u_char *subject,
 }
 
 
+/*
+ * The literals are matched bytewise both in byte and in UTF-8 strings,
+ * because a valid UTF-8 sequence cannot start in the middle of another
+ * one.  The result is the same as the one of pcre_exec(): the leftmost
+ * match, the first of the alternatives matching at the same position.
+ * So each next alternative is searched only before the match found.
+ */
+
+static njs_int_t
+njs_regexp_literals_match(njs_regexp_literals_t *literals,
+    const u_char *subject, size_t off, size_t len,
+    njs_regex_match_data_t *match_data)
+{
+    int           *captures;
+    njs_str_t     *literal, *alt, *last;
+    const u_char  *p, *end, *found, *stop;
+
+    p = subject + off;
+    end = subject + len;
+
+    literal = literals->literal;
+
+    switch (literals->type) {
+
+    case NJS_REGEXP_MATCH_PREFIX:
+
+        /* "^" matches only at the start of the subject. */
+
+        if (off != 0
+            || len < literal->length
+            || memcmp(p, literal->start, literal->length) != 0)
+        {
+            return NJS_REGEX_NOMATCH;
+        }
+
+        goto found;
+
+    case NJS_REGEXP_MATCH_LITERAL:
+
+        p = njs_str_search(p, end, literal->start, literal->length);
+        if (p == NULL) {
+            return NJS_REGEX_NOMATCH;
+        }
+
+        goto found;
+
+    default:
+
+        found = NULL;
+        last = &literal[literals->n];
+
+        for (alt = literal; alt < last; alt++) {
+            stop = end;
+
+            if (found != NULL) {
+                stop = found - 1 + alt->length;
+
+                if (stop > end) {
+                    stop = end;
+                }
+            }
+
+            p = njs_str_search(subject + off, stop, alt->start, alt->length);
+
+            if (p != NULL) {
+                found = p;
+                literal = alt;
+
+                if (p == subject + off) {
+                    break;
+                }
+            }
+        }
+
+        if (found == NULL) {
+            return NJS_REGEX_NOMATCH;
+        }
+
+        p = found;
+    }
+
+found:
+
+    captures = njs_regex_captures(match_data);
+
+    captures[0] = p - subject;
+    captures[1] = p - subject + literal->length;
+
+    return 1;
+}
+
+
 static u_char *
 njs_regexp_match_trace_handler(njs_trace_t *trace, njs_trace_data_t *td,
     u_char *start)
@@ -729,9 +1465,7 @@ static njs_int_t
 njs_regexp_prototype_last_index(njs_vm_t *vm, njs_object_prop_t *unused,
     njs_value_t *value, njs_value_t *setval, njs_value_t *retval)
 {
-    uint32_t           index, last_index;
-    njs_regexp_t       *regexp;
-    njs_string_prop_t  string;
+    njs_regexp_t  *regexp;
 
     regexp = njs_object_proto_lookup(njs_object(value), NJS_REGEXP,
                                      njs_regexp_t);
@@ -747,22 +1481,7 @@ njs_regexp_prototype_last_index(njs_vm_t *vm, njs_object_prop_t *unused,
         return NJS_OK;
     }
 
-    if (njs_slow_path(!njs_is_number(&regexp->last_index))) {
-        *retval = regexp->last_index;
-        return NJS_OK;
-    }
-
-    (void) njs_string_prop(&string, &regexp->string);
-
-    last_index = njs_number(&regexp->last_index);
-
-    if (njs_slow_path(string.size < last_index)) {
-        *retval = regexp->last_index;
-        return NJS_OK;
-    }
-
-    index = njs_string_index(&string, last_index);
-    njs_set_number(retval, index);
+    *retval = regexp->last_index;
 
     return NJS_OK;
 }
@@ -905,23 +1624,21 @@ njs_regexp_prototype_test(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     regex = &pattern->regex[n];
     match_data = vm->single_match_data;
 
-    if (njs_regex_is_valid(regex)) {
+    if (njs_regexp_pattern_valid(vm, pattern, n)) {
         if (njs_regex_backrefs(regex) != 0) {
-            match_data = njs_regex_match_data(regex, vm->regex_context);
+            match_data = njs_regexp_match_data(vm, regex);
             if (njs_slow_path(match_data == NULL)) {
-                njs_memory_error(vm);
                 return NJS_ERROR;
             }
         }
 
-        match = njs_regexp_match(vm, regex, string.start, string.size,
-                               match_data);
+        match = njs_regexp_match(vm, pattern, n, string.start, 0,
+                                 string.size, match_data);
         if (match >= 0) {
             retval = &njs_value_true;
 
         } else if (match != NJS_REGEX_NOMATCH) {
-            ret = NJS_ERROR;
-            goto done;
+            return NJS_ERROR;
         }
 
         if (pattern->global) {
@@ -932,7 +1649,13 @@ njs_regexp_prototype_test(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 
             if (match >= 0) {
                 captures = njs_regex_captures(match_data);
-                last_index += captures[1];
+
+                if (string.length != 0 && string.length != string.size) {
+                    last_index += njs_string_index(&string, captures[1]);
+
+                } else {
+                    last_index += captures[1];
+                }
 
             } else {
                 last_index = 0;
@@ -942,17 +1665,9 @@ njs_regexp_prototype_test(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
         }
     }
 
-    ret = NJS_OK;
-
     vm->retval = *retval;
 
-done:
-
-    if (match_data != vm->single_match_data) {
-        njs_regex_match_data_free(match_data, vm->regex_context);
-    }
-
-    return ret;
+    return NJS_OK;
 }
 
 
@@ -960,11 +1675,13 @@ njs_int_t
 njs_regexp_prototype_exec(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     njs_index_t unused)
 {
+    size_t                  offset, length;
     uint32_t                last_index;
     njs_int_t               ret;
     njs_utf8_t              utf8;
     njs_value_t             *value, lvalue;
     njs_regexp_t            *regexp;
+    const u_char            *p;
     njs_string_prop_t       string;
     njs_regexp_utf8_t       type;
     njs_regexp_pattern_t    *pattern;
@@ -999,44 +1716,53 @@ njs_regexp_prototype_exec(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 
     (void) njs_string_prop(&string, value);
 
-    if (string.size >= last_index) {
-        utf8 = NJS_STRING_BYTE;
-        type = NJS_REGEXP_BYTE;
+    utf8 = NJS_STRING_BYTE;
+    type = NJS_REGEXP_BYTE;
+    length = string.size;
 
-        if (string.length != 0) {
-            utf8 = NJS_STRING_ASCII;
-            type = NJS_REGEXP_UTF8;
+    if (string.length != 0) {
+        utf8 = NJS_STRING_ASCII;
+        type = NJS_REGEXP_UTF8;
+        length = string.length;
 
-            if (string.length != string.size) {
-                utf8 = NJS_STRING_UTF8;
-            }
+        if (string.length != string.size) {
+            utf8 = NJS_STRING_UTF8;
         }
+    }
 
-        pattern = regexp->pattern;
+    if (last_index <= length && njs_regexp_pattern_valid(vm, pattern, type)) {
 
-        if (njs_regex_is_valid(&pattern->regex[type])) {
-            string.start += last_index;
-            string.size -= last_index;
+        /*
+         * The whole subject is matched from the lastIndex offset,
+         * so a global matching loop checks the UTF-8 subject once.
+         */
 
-            match_data = njs_regex_match_data(&pattern->regex[type],
-                                              vm->regex_context);
-            if (njs_slow_path(match_data == NULL)) {
-                njs_memory_error(vm);
-                return NJS_ERROR;
-            }
+        offset = last_index;
+
+        if (utf8 == NJS_STRING_UTF8) {
+            offset = string.size;
 
-            ret = njs_regexp_match(vm, &pattern->regex[type], string.start,
-                                   string.size, match_data);
-            if (ret >= 0) {
-                return njs_regexp_exec_result(vm, regexp, utf8, string.start,
-                                              match_data, last_index);
+            if (last_index != length) {
+                p = njs_string_offset(string.start, string.start + string.size,
+                                      last_index);
+                offset = p - string.start;
             }
+        }
 
-            if (njs_slow_path(ret != NJS_REGEX_NOMATCH)) {
-                njs_regex_match_data_free(match_data, vm->regex_context);
+        match_data = njs_regexp_match_data(vm, &pattern->regex[type]);
+        if (njs_slow_path(match_data == NULL)) {
+            return NJS_ERROR;
+        }
 
-                return NJS_ERROR;
-            }
+        ret = njs_regexp_match(vm, pattern, type, string.start, offset,
+                               string.size, match_data);
+        if (ret >= 0) {
+            return njs_regexp_exec_result(vm, regexp, utf8, &string,
+                                          match_data);
+        }
+
+        if (njs_slow_path(ret != NJS_REGEX_NOMATCH)) {
+            return NJS_ERROR;
         }
     }
 
@@ -1050,9 +1776,40 @@ njs_regexp_prototype_exec(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 }
 
 
+/*
+ * The match data is reused by all the RegExp.prototype.exec() calls
+ * of the VM, it grows to the largest number of captures.
+ */
+
+static njs_regex_match_data_t *
+njs_regexp_match_data(njs_vm_t *vm, njs_regex_t *regex)
+{
+    njs_uint_t  ncaptures;
+
+    ncaptures = njs_regex_ncaptures(regex);
+
+    if (ncaptures > vm->match_data_ncaptures) {
+        if (vm->match_data != NULL) {
+            njs_regex_match_data_free(vm->match_data, vm->regex_context);
+        }
+
+        vm->match_data = njs_regex_match_data(regex, vm->regex_context);
+        if (njs_slow_path(vm->match_data == NULL)) {
+            vm->match_data_ncaptures = 0;
+            njs_memory_error(vm);
+            return NULL;
+        }
+
+        vm->match_data_ncaptures = ncaptures;
+    }
+
+    return vm->match_data;
+}
+
+
 static njs_int_t
 njs_regexp_exec_result(njs_vm_t *vm, njs_regexp_t *regexp, njs_utf8_t utf8,
-    u_char *string, njs_regex_match_data_t *match_data, uint32_t last_index)
+    njs_string_prop_t *string, njs_regex_match_data_t *match_data)
 {
     int                 *captures;
     u_char              *start;
@@ -1081,13 +1838,14 @@ njs_regexp_exec_result(njs_vm_t *vm, njs_regexp_t *regexp, njs_utf8_t utf8,
         n = 2 * i;
 
         if (captures[n] != -1) {
-            start = &string[captures[n]];
+            start = &string->start[captures[n]];
             size = captures[n + 1] - captures[n];
 
             length = njs_string_calc_length(utf8, start, size);
+            length = (length >= 0) ? length : 0;
 
-            ret = njs_regexp_string_create(vm, &array->start[i], start, size,
-                                           length);
+            ret = njs_string_view(vm, &array->start[i], &regexp->string, start,
+                                  size, length);
             if (njs_slow_path(ret != NJS_OK)) {
                 goto fail;
             }
@@ -1102,12 +1860,20 @@ njs_regexp_exec_result(njs_vm_t *vm, njs_regexp_t *regexp, njs_utf8_t utf8,
         goto fail;
     }
 
-    /* TODO: Non UTF-8 position */
+    if (utf8 == NJS_STRING_UTF8) {
+        njs_set_number(&prop->value, njs_string_index(string, captures[0]));
+
+        if (regexp->pattern->global) {
+            njs_set_number(&regexp->last_index,
+                           njs_string_index(string, captures[1]));
+        }
 
-    njs_set_number(&prop->value, last_index + captures[0]);
+    } else {
+        njs_set_number(&prop->value, captures[0]);
 
-    if (regexp->pattern->global) {
-        njs_set_number(&regexp->last_index, last_index + captures[1]);
+        if (regexp->pattern->global) {
+            njs_set_number(&regexp->last_index, captures[1]);
+        }
     }
 
     lhq.key_hash = NJS_INDEX_HASH;
@@ -1191,8 +1957,7 @@ njs_regexp_exec_result(njs_vm_t *vm, njs_regexp_t *regexp, njs_utf8_t utf8,
 
     njs_set_array(&vm->retval, array);
 
-    ret = NJS_OK;
-    goto done;
+    return NJS_OK;
 
 insert_fail:
 
@@ -1200,13 +1965,7 @@ insert_fail:
 
 fail:
 
-    ret = NJS_ERROR;
-
-done:
-
-    njs_regex_match_data_free(match_data, vm->regex_context);
-
-    return ret;
+    return NJS_ERROR;
 }
 
 
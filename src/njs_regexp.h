@@ -23,8 +23,15 @@ njs_token_t njs_regexp_literal(njs_vm_t *vm, njs_parser_t *parser,
     njs_value_t *value);
 njs_regexp_pattern_t *njs_regexp_pattern_create(njs_vm_t *vm,
     u_char *string, size_t length, njs_regexp_flags_t flags);
-njs_int_t njs_regexp_match(njs_vm_t *vm, njs_regex_t *regex,
-    const u_char *subject, size_t len, njs_regex_match_data_t *match_data);
+njs_regexp_cache_t *njs_regexp_cache_create(njs_vm_t *vm);
+njs_regexp_pattern_t *njs_regexp_pattern_cached(njs_vm_t *vm,
+    u_char *string, size_t length, njs_regexp_flags_t flags);
+void njs_regexp_release(njs_vm_t *vm);
+njs_bool_t njs_regexp_pattern_valid(njs_vm_t *vm,
+    njs_regexp_pattern_t *pattern, njs_uint_t type);
+njs_int_t njs_regexp_match(njs_vm_t *vm, njs_regexp_pattern_t *pattern,
+    njs_uint_t type, const u_char *subject, size_t off, size_t len,
+    njs_regex_match_data_t *match_data);
 njs_regexp_t *njs_regexp_alloc(njs_vm_t *vm, njs_regexp_pattern_t *pattern);
 njs_int_t njs_regexp_prototype_exec(njs_vm_t *vm, njs_value_t *args,
     njs_uint_t nargs, njs_index_t unused);
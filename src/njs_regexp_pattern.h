@@ -14,9 +14,28 @@ typedef enum {
 } njs_regexp_utf8_t;
 
 
+typedef enum {
+    NJS_REGEXP_MATCH_LITERAL = 0,
+    NJS_REGEXP_MATCH_PREFIX,
+    NJS_REGEXP_MATCH_ALTERNATION,
+} njs_regexp_match_t;
+
+
 typedef struct njs_regexp_group_s  njs_regexp_group_t;
 
 
+/*
+ * A pattern which consists of literal characters only is matched
+ * without PCRE: "/abc/", "/^abc/" or "/abc|def/".
+ */
+
+typedef struct {
+    njs_regexp_match_t    type;
+    njs_uint_t            n;
+    njs_str_t             *literal;
+} njs_regexp_literals_t;
+
+
 struct njs_regexp_pattern_s {
     njs_regex_t           regex[2];
 
@@ -38,7 +57,18 @@ struct njs_regexp_pattern_s {
     uint8_t               ignore_case;  /* 1 bit */
     uint8_t               multiline;    /* 1 bit */
 
+    /* The variants which are compiled on first use. */
+    uint8_t               lazy;         /* 2 bits */
+
+    /* The PCRE options and the context to compile the lazy variants. */
+    int                   options;
+    njs_regex_context_t   *regex_context;
+
     njs_regexp_group_t    *groups;
+    njs_regexp_literals_t *literals;
+
+    /* The list of patterns compiled by a VM. */
+    njs_regexp_pattern_t  *next;
 };
 
 
@@ -0,0 +1,1269 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+
+#include <njs_main.h>
+
+#if (NJS_HAVE_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if (NJS_HAVE_SSSE3)
+#include <tmmintrin.h>
+#endif
+
+#if (NJS_HAVE_AVX2)
+#include <immintrin.h>
+#endif
+
+#if (NJS_HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
+
+/*
+ * njs_str_search() uses a filter on the first and the last needle bytes
+ * for short needles: a haystack block is compared with both bytes at once
+ * and only the candidate positions are compared with the whole needle.
+ * Long needles are searched with the Two-Way algorithm which is linear
+ * in the worst case and requires constant space.
+ */
+
+#define NJS_STR_SEARCH_SHORT  32
+
+
+static u_char *njs_str_search_scalar(const u_char *p, const u_char *end,
+    const u_char *needle, size_t size);
+#if (NJS_HAVE_SSE2)
+static u_char *njs_str_search_sse2(const u_char *p, const u_char *end,
+    const u_char *needle, size_t size);
+#endif
+#if (NJS_HAVE_AVX2)
+static u_char *njs_str_search_avx2(const u_char *p, const u_char *end,
+    const u_char *needle, size_t size);
+#endif
+static u_char *njs_str_search_resolve(const u_char *p, const u_char *end,
+    const u_char *needle, size_t size);
+static u_char *njs_str_search_two_way(const u_char *p, const u_char *end,
+    const u_char *needle, size_t size);
+static void njs_str_case_flip(u_char *dst, const u_char *src, size_t size,
+    u_char first);
+
+
+static u_char *(*njs_str_search_handler)(const u_char *p, const u_char *end,
+    const u_char *needle, size_t size) = njs_str_search_resolve;
+
+
+u_char *
+njs_str_search(const u_char *p, const u_char *end, const u_char *needle,
+    size_t size)
+{
+    if (njs_slow_path((size_t) (end - p) < size)) {
+        return NULL;
+    }
+
+    if (size <= 1) {
+        if (size == 0) {
+            return (u_char *) p;
+        }
+
+        return memchr(p, needle[0], end - p);
+    }
+
+    if (size <= NJS_STR_SEARCH_SHORT) {
+        return njs_str_search_handler(p, end, needle, size);
+    }
+
+    return njs_str_search_two_way(p, end, needle, size);
+}
+
+
+static u_char *
+njs_str_search_resolve(const u_char *p, const u_char *end,
+    const u_char *needle, size_t size)
+{
+    njs_str_search_handler = njs_str_search_scalar;
+
+#if (NJS_HAVE_SSE2)
+    njs_str_search_handler = njs_str_search_sse2;
+#endif
+
+#if (NJS_HAVE_AVX2)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        njs_str_search_handler = njs_str_search_avx2;
+    }
+#endif
+
+    return njs_str_search_handler(p, end, needle, size);
+}
+
+
+static u_char *
+njs_str_search_scalar(const u_char *p, const u_char *end,
+    const u_char *needle, size_t size)
+{
+    u_char        last;
+    const u_char  *stop;
+
+    last = needle[size - 1];
+    stop = end - size + 1;
+
+    while (p < stop) {
+        p = memchr(p, needle[0], stop - p);
+        if (p == NULL) {
+            return NULL;
+        }
+
+        if (p[size - 1] == last
+            && memcmp(p + 1, needle + 1, size - 2) == 0)
+        {
+            return (u_char *) p;
+        }
+
+        p++;
+    }
+
+    return NULL;
+}
+
+
+#if (NJS_HAVE_SSE2)
+
+static u_char *
+njs_str_search_sse2(const u_char *p, const u_char *end,
+    const u_char *needle, size_t size)
+{
+    int      mask;
+    __m128i  first, last, v1, v2;
+
+    first = _mm_set1_epi8(needle[0]);
+    last = _mm_set1_epi8(needle[size - 1]);
+
+    while ((size_t) (end - p) >= size - 1 + 16) {
+        v1 = _mm_loadu_si128((const __m128i *) p);
+        v2 = _mm_loadu_si128((const __m128i *) (p + size - 1));
+
+        mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(v1, first),
+                                               _mm_cmpeq_epi8(v2, last)));
+
+        while (mask != 0) {
+            if (memcmp(p + __builtin_ctz(mask) + 1, needle + 1, size - 2)
+                == 0)
+            {
+                return (u_char *) p + __builtin_ctz(mask);
+            }
+
+            mask &= mask - 1;
+        }
+
+        p += 16;
+    }
+
+    return njs_str_search_scalar(p, end, needle, size);
+}
+
+#endif
+
+
+#if (NJS_HAVE_AVX2)
+
+__attribute__((target("avx2")))
+static u_char *
+njs_str_search_avx2(const u_char *p, const u_char *end,
+    const u_char *needle, size_t size)
+{
+    uint32_t  mask;
+    __m256i   first, last, v1, v2;
+
+    first = _mm256_set1_epi8(needle[0]);
+    last = _mm256_set1_epi8(needle[size - 1]);
+
+    while ((size_t) (end - p) >= size - 1 + 32) {
+        v1 = _mm256_loadu_si256((const __m256i *) p);
+        v2 = _mm256_loadu_si256((const __m256i *) (p + size - 1));
+
+        mask = _mm256_movemask_epi8(
+                          _mm256_and_si256(_mm256_cmpeq_epi8(v1, first),
+                                           _mm256_cmpeq_epi8(v2, last)));
+
+        while (mask != 0) {
+            if (memcmp(p + __builtin_ctz(mask) + 1, needle + 1, size - 2)
+                == 0)
+            {
+                _mm256_zeroupper();
+                return (u_char *) p + __builtin_ctz(mask);
+            }
+
+            mask &= mask - 1;
+        }
+
+        p += 32;
+    }
+
+    /* See njs_utf8_ascii_avx2(). */
+
+    _mm256_zeroupper();
+
+    return njs_str_search_sse2(p, end, needle, size);
+}
+
+#endif
+
+
+/*
+ * The Two-Way algorithm by M. Crochemore and D. Perrin.  The needle
+ * is split by the critical factorization computed as the maximal
+ * suffix for both byte orders.  The right part is compared first from
+ * left to right, then the left part is compared from right to left.
+ * For periodic needles the matched prefix is remembered.  The last
+ * haystack byte under the window is used to skip with the bad character
+ * shift.
+ */
+
+static u_char *
+njs_str_search_two_way(const u_char *p, const u_char *end,
+    const u_char *needle, size_t size)
+{
+    u_char  c;
+    size_t  i, ip, jp, k, period, ms, period0, mem, mem0;
+    size_t  shift[256];
+
+    njs_memzero(shift, sizeof(shift));
+
+    for (i = 0; i < size; i++) {
+        shift[needle[i]] = i + 1;
+    }
+
+    /* The maximal suffix. */
+
+    ip = (size_t) -1;
+    jp = 0;
+    k = 1;
+    period = 1;
+
+    while (jp + k < size) {
+        if (needle[ip + k] == needle[jp + k]) {
+            if (k == period) {
+                jp += period;
+                k = 1;
+
+            } else {
+                k++;
+            }
+
+        } else if (needle[ip + k] > needle[jp + k]) {
+            jp += k;
+            k = 1;
+            period = jp - ip;
+
+        } else {
+            ip = jp++;
+            k = 1;
+            period = 1;
+        }
+    }
+
+    ms = ip;
+    period0 = period;
+
+    /* The maximal suffix for the opposite byte order. */
+
+    ip = (size_t) -1;
+    jp = 0;
+    k = 1;
+    period = 1;
+
+    while (jp + k < size) {
+        if (needle[ip + k] == needle[jp + k]) {
+            if (k == period) {
+                jp += period;
+                k = 1;
+
+            } else {
+                k++;
+            }
+
+        } else if (needle[ip + k] < needle[jp + k]) {
+            jp += k;
+            k = 1;
+            period = jp - ip;
+
+        } else {
+            ip = jp++;
+            k = 1;
+            period = 1;
+        }
+    }
+
+    if (ip + 1 > ms + 1) {
+        ms = ip;
+
+    } else {
+        period = period0;
+    }
+
+    if (memcmp(needle, needle + period, ms + 1) != 0) {
+        /* The needle is not periodic. */
+        mem0 = 0;
+        period = njs_max(ms, size - ms - 1) + 1;
+
+    } else {
+        mem0 = size - period;
+    }
+
+    mem = 0;
+
+    for ( ;; ) {
+        if ((size_t) (end - p) < size) {
+            return NULL;
+        }
+
+        c = p[size - 1];
+        k = size - shift[c];
+
+        if (k != 0) {
+            if (k < mem) {
+                k = mem;
+            }
+
+            p += k;
+            mem = 0;
+            continue;
+        }
+
+        /* The right part. */
+
+        for (k = njs_max(ms + 1, mem); k < size && needle[k] == p[k]; k++) {
+            /* void */
+        }
+
+        if (k < size) {
+            p += k - ms;
+            mem = 0;
+            continue;
+        }
+
+        /* The left part. */
+
+        for (k = ms + 1; k > mem && needle[k - 1] == p[k - 1]; k--) {
+            /* void */
+        }
+
+        if (k <= mem) {
+            return (u_char *) p;
+        }
+
+        p += period;
+        mem = mem0;
+    }
+}
+
+
+/*
+ * njs_str_lower_case() and njs_str_upper_case() convert ASCII letters
+ * and copy other bytes as is.  SSE2 and NEON are the baseline on
+ * the respective platforms, so they are used unconditionally.
+ */
+
+void
+njs_str_lower_case(u_char *dst, const u_char *src, size_t size)
+{
+    njs_str_case_flip(dst, src, size, 'A');
+}
+
+
+void
+njs_str_upper_case(u_char *dst, const u_char *src, size_t size)
+{
+    njs_str_case_flip(dst, src, size, 'a');
+}
+
+
+/*
+ * The case bit is flipped in the bytes from the first - first + 25 range.
+ */
+
+static void
+njs_str_case_flip(u_char *dst, const u_char *src, size_t size, u_char first)
+{
+    u_char        c;
+    const u_char  *end;
+#if (NJS_HAVE_SSE2)
+    __m128i       v, lo, hi, bit;
+#elif (NJS_HAVE_NEON)
+    uint8x16_t    v, lo, hi, bit;
+#endif
+
+    end = src + size;
+
+#if (NJS_HAVE_SSE2)
+
+    /* Bytes larger than 0x7F are negative in the signed comparisons. */
+
+    lo = _mm_set1_epi8(first - 1);
+    hi = _mm_set1_epi8(first + 26);
+    bit = _mm_set1_epi8(0x20);
+
+    while (end - src >= 16) {
+        v = _mm_loadu_si128((const __m128i *) src);
+
+        _mm_storeu_si128((__m128i *) dst,
+                         _mm_xor_si128(v,
+                             _mm_and_si128(bit,
+                                 _mm_and_si128(_mm_cmpgt_epi8(v, lo),
+                                               _mm_cmpgt_epi8(hi, v)))));
+        src += 16;
+        dst += 16;
+    }
+
+#elif (NJS_HAVE_NEON)
+
+    lo = vdupq_n_u8(first);
+    hi = vdupq_n_u8(first + 25);
+    bit = vdupq_n_u8(0x20);
+
+    while (end - src >= 16) {
+        v = vld1q_u8(src);
+
+        vst1q_u8(dst, veorq_u8(v, vandq_u8(bit, vandq_u8(vcgeq_u8(v, lo),
+                                                         vcleq_u8(v, hi)))));
+        src += 16;
+        dst += 16;
+    }
+
+#endif
+
+    while (src < end) {
+        c = *src++;
+        *dst++ = ((u_char) (c - first) < 26) ? c ^ 0x20 : c;
+    }
+}
+
+
+/*
+ * njs_str_skip_space() returns the first byte in the p - end range
+ * which is not an ASCII whitespace: <TAB>, <LF>, <VT>, <FF>, <CR>
+ * or <SP>.  njs_str_skip_space_back() returns the end of the range
+ * without trailing ASCII whitespaces.
+ */
+
+#if (NJS_HAVE_SSE2)
+
+njs_inline int
+njs_str_space_mask(__m128i v)
+{
+    __m128i  space;
+
+    space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(0x20)),
+                         _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(0x08)),
+                                       _mm_cmpgt_epi8(_mm_set1_epi8(0x0E), v)));
+
+    return _mm_movemask_epi8(space) ^ 0xFFFF;
+}
+
+#endif
+
+
+njs_inline njs_bool_t
+njs_str_is_space(u_char c)
+{
+    return (c == 0x20 || (u_char) (c - 0x09) < 5);
+}
+
+
+const u_char *
+njs_str_skip_space(const u_char *p, const u_char *end)
+{
+#if (NJS_HAVE_SSE2)
+    int  mask;
+
+    while (end - p >= 16) {
+        mask = njs_str_space_mask(_mm_loadu_si128((const __m128i *) p));
+
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+
+        p += 16;
+    }
+#endif
+
+    while (p < end && njs_str_is_space(*p)) {
+        p++;
+    }
+
+    return p;
+}
+
+
+const u_char *
+njs_str_skip_space_back(const u_char *start, const u_char *p)
+{
+#if (NJS_HAVE_SSE2)
+    int  mask;
+
+    while (p - start >= 16) {
+        mask = njs_str_space_mask(_mm_loadu_si128((const __m128i *) (p - 16)));
+
+        if (mask != 0) {
+            return p - 16 + 32 - __builtin_clz(mask);
+        }
+
+        p -= 16;
+    }
+#endif
+
+    while (p > start && njs_str_is_space(p[-1])) {
+        p--;
+    }
+
+    return p;
+}
+
+
+/*
+ * njs_str_escape_find() returns the first byte in the p - end range
+ * which is set in the 256-bit escape map, njs_str_escape_count() returns
+ * the number of such bytes.  The vector code looks up the bit of an ASCII
+ * byte with a byte shuffle over the first 128 bits of the map, so all
+ * bytes larger than 0x7F must be set in the map.
+ */
+
+njs_inline njs_bool_t
+njs_str_escaped(const uint32_t *escape, u_char c)
+{
+    return ((escape[c >> 5] & ((uint32_t) 1 << (c & 0x1f))) != 0);
+}
+
+
+#if (NJS_HAVE_SSSE3)
+
+__attribute__((target("ssse3")))
+njs_inline int
+njs_str_escape_mask_ssse3(__m128i v, __m128i map)
+{
+    __m128i  row, bit;
+
+    row = _mm_shuffle_epi8(map, _mm_and_si128(_mm_srli_epi16(v, 3),
+                                              _mm_set1_epi8(0x0f)));
+
+    bit = _mm_shuffle_epi8(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+                                         1, 2, 4, 8, 16, 32, 64, -128),
+                           _mm_and_si128(v, _mm_set1_epi8(7)));
+
+    return _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(
+                                              _mm_and_si128(row, bit), bit),
+                                          v));
+}
+
+
+__attribute__((target("ssse3")))
+static const u_char *
+njs_str_escape_find_ssse3(const u_char *p, const u_char *end,
+    const uint32_t *escape)
+{
+    int      mask;
+    __m128i  map;
+
+    map = _mm_loadu_si128((const __m128i *) escape);
+
+    while (end - p >= 16) {
+        mask = njs_str_escape_mask_ssse3(_mm_loadu_si128((const __m128i *) p),
+                                         map);
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+
+        p += 16;
+    }
+
+    while (p < end && !njs_str_escaped(escape, *p)) {
+        p++;
+    }
+
+    return p;
+}
+
+
+__attribute__((target("ssse3")))
+static size_t
+njs_str_escape_count_ssse3(const u_char *p, const u_char *end,
+    const uint32_t *escape)
+{
+    size_t   n;
+    __m128i  map;
+
+    n = 0;
+    map = _mm_loadu_si128((const __m128i *) escape);
+
+    while (end - p >= 16) {
+        n += __builtin_popcount(njs_str_escape_mask_ssse3(
+                                   _mm_loadu_si128((const __m128i *) p), map));
+        p += 16;
+    }
+
+    while (p < end) {
+        n += njs_str_escaped(escape, *p++);
+    }
+
+    return n;
+}
+
+#elif (NJS_HAVE_NEON)
+
+njs_inline uint8x16_t
+njs_str_escape_mask_neon(uint8x16_t v, uint8x16_t map)
+{
+    uint8x16_t  row, bit;
+
+    static const uint8_t  bits[16] = {
+        1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+    };
+
+    /* The table lookup returns 0 for the indices of bytes above 0x7F. */
+
+    row = vqtbl1q_u8(map, vshrq_n_u8(v, 3));
+    bit = vqtbl1q_u8(vld1q_u8(bits), vandq_u8(v, vdupq_n_u8(7)));
+
+    return vorrq_u8(vtstq_u8(row, bit), vcgeq_u8(v, vdupq_n_u8(0x80)));
+}
+
+#endif
+
+
+const u_char *
+njs_str_escape_find(const u_char *p, const u_char *end,
+    const uint32_t *escape)
+{
+#if (NJS_HAVE_SSSE3)
+    if (__builtin_cpu_supports("ssse3")) {
+        return njs_str_escape_find_ssse3(p, end, escape);
+    }
+
+#elif (NJS_HAVE_NEON)
+    uint64_t    mask;
+    uint8x16_t  map, m;
+
+    map = vld1q_u8((const uint8_t *) escape);
+
+    while (end - p >= 16) {
+        m = njs_str_escape_mask_neon(vld1q_u8(p), map);
+
+        /* Each byte of the mask is narrowed to a nibble. */
+
+        mask = vget_lane_u64(vreinterpret_u64_u8(
+                             vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+        if (mask != 0) {
+            return p + (__builtin_ctzll(mask) >> 2);
+        }
+
+        p += 16;
+    }
+#endif
+
+    while (p < end && !njs_str_escaped(escape, *p)) {
+        p++;
+    }
+
+    return p;
+}
+
+
+size_t
+njs_str_escape_count(const u_char *p, const u_char *end,
+    const uint32_t *escape)
+{
+    size_t      n;
+#if (NJS_HAVE_NEON && !NJS_HAVE_SSSE3)
+    uint8x16_t  map;
+#endif
+
+#if (NJS_HAVE_SSSE3)
+    if (__builtin_cpu_supports("ssse3")) {
+        return njs_str_escape_count_ssse3(p, end, escape);
+    }
+#endif
+
+    n = 0;
+
+#if (NJS_HAVE_NEON && !NJS_HAVE_SSSE3)
+    map = vld1q_u8((const uint8_t *) escape);
+
+    while (end - p >= 16) {
+        n += vaddvq_u8(vandq_u8(njs_str_escape_mask_neon(vld1q_u8(p), map),
+                                vdupq_n_u8(1)));
+        p += 16;
+    }
+#endif
+
+    while (p < end) {
+        n += njs_str_escaped(escape, *p++);
+    }
+
+    return n;
+}
+
+
+/*
+ * The vector codecs below convert the longest prefix of the source which
+ * consists of whole valid blocks and return the number of consumed source
+ * bytes, the rest is converted by the caller's scalar code which also
+ * handles invalid input.  The destination must have room for the whole
+ * encoded or decoded source.
+ */
+
+#if (NJS_HAVE_SSSE3)
+
+__attribute__((target("ssse3")))
+static size_t
+njs_str_encode_hex_ssse3(u_char *dst, const u_char *src, size_t size)
+{
+    __m128i       v, lo, hi, digits, mask;
+    const u_char  *p, *end;
+
+    p = src;
+    end = src + size;
+
+    digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                           '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    mask = _mm_set1_epi8(0x0f);
+
+    while (end - p >= 16) {
+        v = _mm_loadu_si128((const __m128i *) p);
+
+        hi = _mm_shuffle_epi8(digits,
+                              _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        lo = _mm_shuffle_epi8(digits, _mm_and_si128(v, mask));
+
+        _mm_storeu_si128((__m128i *) dst, _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *) (dst + 16), _mm_unpackhi_epi8(hi, lo));
+
+        p += 16;
+        dst += 32;
+    }
+
+    return p - src;
+}
+
+
+/*
+ * Returns the values of hex digits, or -1 if a block contains another
+ * character.  As in njs_char_to_hex(), the case bit is set before
+ * the digits are tested.
+ */
+
+__attribute__((target("ssse3")))
+njs_inline int
+njs_str_decode_hex_block_ssse3(const u_char *p, __m128i *out)
+{
+    __m128i  c, digit, letter;
+
+    c = _mm_or_si128(_mm_loadu_si128((const __m128i *) p),
+                     _mm_set1_epi8(0x20));
+
+    digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                          _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), c));
+    letter = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)),
+                           _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), c));
+
+    if (_mm_movemask_epi8(_mm_or_si128(digit, letter)) != 0xffff) {
+        return -1;
+    }
+
+    c = _mm_sub_epi8(c, _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8('0')),
+                                     _mm_and_si128(letter,
+                                                   _mm_set1_epi8('a' - 10))));
+
+    /* Pairs of digits are merged into 16-bit values. */
+
+    *out = _mm_maddubs_epi16(c, _mm_set1_epi16(0x0110));
+
+    return 0;
+}
+
+
+__attribute__((target("ssse3")))
+static size_t
+njs_str_decode_hex_ssse3(u_char *dst, const u_char *src, size_t size)
+{
+    __m128i       v0, v1;
+    const u_char  *p, *end;
+
+    p = src;
+    end = src + size;
+
+    while (end - p >= 32) {
+        if (njs_str_decode_hex_block_ssse3(p, &v0) != 0
+            || njs_str_decode_hex_block_ssse3(p + 16, &v1) != 0)
+        {
+            break;
+        }
+
+        _mm_storeu_si128((__m128i *) dst, _mm_packus_epi16(v0, v1));
+
+        p += 32;
+        dst += 16;
+    }
+
+    return p - src;
+}
+
+
+/*
+ * The base64 codecs follow the algorithms by W. Mula and D. Lemire:
+ * 3-byte groups are spread to four 6-bit values with the multiplications
+ * of 16-bit lanes and the values are translated to the characters by
+ * adding an offset which depends on the value range.
+ */
+
+__attribute__((target("ssse3")))
+njs_inline __m128i
+njs_str_encode_base64_ssse3_block(__m128i v, __m128i shift)
+{
+    __m128i  t0, t1, r, less;
+
+    v = _mm_shuffle_epi8(v, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+                                         4, 5, 3, 4, 1, 2, 0, 1));
+
+    t0 = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)),
+                         _mm_set1_epi32(0x04000040));
+    t1 = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)),
+                         _mm_set1_epi32(0x01000010));
+    v = _mm_or_si128(t0, t1);
+
+    /*
+     * The ranges: 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10,
+     * 62 -> 11, 63 -> 12.
+     */
+
+    r = _mm_subs_epu8(v, _mm_set1_epi8(51));
+    less = _mm_cmpgt_epi8(_mm_set1_epi8(26), v);
+    r = _mm_or_si128(r, _mm_and_si128(less, _mm_set1_epi8(13)));
+
+    return _mm_add_epi8(v, _mm_shuffle_epi8(shift, r));
+}
+
+
+__attribute__((target("ssse3")))
+njs_inline __m128i
+njs_str_encode_base64_shift_ssse3(njs_bool_t url)
+{
+    char  c62, c63;
+
+    c62 = url ? '-' : '+';
+    c63 = url ? '_' : '/';
+
+    return _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+                         '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                         '0' - 52, '0' - 52, '0' - 52, c62 - 62,
+                         c63 - 63, 'A', 0, 0);
+}
+
+
+__attribute__((target("ssse3")))
+static size_t
+njs_str_encode_base64_ssse3(u_char *dst, const u_char *src, size_t size,
+    njs_bool_t url)
+{
+    __m128i       shift;
+    const u_char  *p, *end;
+
+    p = src;
+    end = src + size;
+
+    shift = njs_str_encode_base64_shift_ssse3(url);
+
+    /* 16 bytes are loaded, 12 of them are encoded. */
+
+    while (end - p >= 16) {
+        _mm_storeu_si128((__m128i *) dst,
+                         njs_str_encode_base64_ssse3_block(
+                             _mm_loadu_si128((const __m128i *) p), shift));
+        p += 12;
+        dst += 16;
+    }
+
+    return p - src;
+}
+
+
+/*
+ * Returns the 6-bit values of base64 characters, or -1 if a block
+ * contains another character including padding.
+ */
+
+__attribute__((target("ssse3")))
+njs_inline int
+njs_str_decode_base64_block_ssse3(const u_char *p, __m128i *out,
+    njs_bool_t url)
+{
+    char     c62, c63;
+    __m128i  c, upper, lower, digit, s62, s63, valid, shift;
+
+    c62 = url ? '-' : '+';
+    c63 = url ? '_' : '/';
+
+    c = _mm_loadu_si128((const __m128i *) p);
+
+    /* Bytes larger than 0x7F are negative in the signed comparisons. */
+
+    upper = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('A' - 1)),
+                          _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), c));
+    lower = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)),
+                          _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), c));
+    digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                          _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), c));
+    s62 = _mm_cmpeq_epi8(c, _mm_set1_epi8(c62));
+    s63 = _mm_cmpeq_epi8(c, _mm_set1_epi8(c63));
+
+    valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                         _mm_or_si128(digit, _mm_or_si128(s62, s63)));
+
+    if (_mm_movemask_epi8(valid) != 0xffff) {
+        return -1;
+    }
+
+    shift = _mm_or_si128(
+                _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                             _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+                _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                    _mm_or_si128(_mm_and_si128(s62, _mm_set1_epi8(62 - c62)),
+                                 _mm_and_si128(s63,
+                                               _mm_set1_epi8(63 - c63)))));
+
+    c = _mm_add_epi8(c, shift);
+
+    /* Four 6-bit values are merged into 24 bits of a 32-bit lane. */
+
+    c = _mm_maddubs_epi16(c, _mm_set1_epi32(0x01400140));
+    *out = _mm_madd_epi16(c, _mm_set1_epi32(0x00011000));
+
+    return 0;
+}
+
+
+__attribute__((target("ssse3")))
+static size_t
+njs_str_decode_base64_ssse3(u_char *dst, const u_char *src, size_t size,
+    njs_bool_t url)
+{
+    __m128i       v, order;
+    const u_char  *p, *end;
+
+    p = src;
+    end = src + size;
+
+    order = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                          -1, -1, -1, -1);
+
+    /*
+     * 16 bytes are stored, 12 of them are decoded, the destination
+     * has room for them while 8 more source bytes remain.
+     */
+
+    while (end - p >= 24) {
+        if (njs_str_decode_base64_block_ssse3(p, &v, url) != 0) {
+            break;
+        }
+
+        _mm_storeu_si128((__m128i *) dst, _mm_shuffle_epi8(v, order));
+
+        p += 16;
+        dst += 12;
+    }
+
+    return p - src;
+}
+
+#endif
+
+
+#if (NJS_HAVE_SSSE3 && NJS_HAVE_AVX2)
+
+__attribute__((target("avx2")))
+static size_t
+njs_str_encode_hex_avx2(u_char *dst, const u_char *src, size_t size)
+{
+    __m256i       v, lo, hi, digits, mask, r0, r1;
+    const u_char  *p, *end;
+
+    p = src;
+    end = src + size;
+
+    digits = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                              '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                              '0', '1', '2', '3', '4', '5', '6', '7',
+                              '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    mask = _mm256_set1_epi8(0x0f);
+
+    while (end - p >= 32) {
+        v = _mm256_loadu_si256((const __m256i *) p);
+
+        hi = _mm256_shuffle_epi8(digits,
+                                 _mm256_and_si256(_mm256_srli_epi16(v, 4),
+                                                  mask));
+        lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(v, mask));
+
+        /* The unpacking works within 128-bit lanes. */
+
+        r0 = _mm256_unpacklo_epi8(hi, lo);
+        r1 = _mm256_unpackhi_epi8(hi, lo);
+
+        _mm256_storeu_si256((__m256i *) dst,
+                            _mm256_permute2x128_si256(r0, r1, 0x20));
+        _mm256_storeu_si256((__m256i *) (dst + 32),
+                            _mm256_permute2x128_si256(r0, r1, 0x31));
+
+        p += 32;
+        dst += 64;
+    }
+
+    _mm256_zeroupper();
+
+    return p - src + njs_str_encode_hex_ssse3(dst, p, end - p);
+}
+
+
+__attribute__((target("avx2")))
+njs_inline int
+njs_str_decode_hex_block_avx2(const u_char *p, __m256i *out)
+{
+    __m256i  c, digit, letter;
+
+    c = _mm256_or_si256(_mm256_loadu_si256((const __m256i *) p),
+                        _mm256_set1_epi8(0x20));
+
+    digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+                             _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+    letter = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('a' - 1)),
+                              _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), c));
+
+    if ((uint32_t) _mm256_movemask_epi8(_mm256_or_si256(digit, letter))
+        != 0xffffffff)
+    {
+        return -1;
+    }
+
+    c = _mm256_sub_epi8(c,
+                        _mm256_or_si256(
+                            _mm256_and_si256(digit, _mm256_set1_epi8('0')),
+                            _mm256_and_si256(letter,
+                                             _mm256_set1_epi8('a' - 10))));
+
+    *out = _mm256_maddubs_epi16(c, _mm256_set1_epi16(0x0110));
+
+    return 0;
+}
+
+
+__attribute__((target("avx2")))
+static size_t
+njs_str_decode_hex_avx2(u_char *dst, const u_char *src, size_t size)
+{
+    __m256i       v0, v1;
+    const u_char  *p, *end;
+
+    p = src;
+    end = src + size;
+
+    while (end - p >= 64) {
+        if (njs_str_decode_hex_block_avx2(p, &v0) != 0
+            || njs_str_decode_hex_block_avx2(p + 32, &v1) != 0)
+        {
+            break;
+        }
+
+        /* The packing works within 128-bit lanes. */
+
+        _mm256_storeu_si256((__m256i *) dst,
+                            _mm256_permute4x64_epi64(
+                                _mm256_packus_epi16(v0, v1), 0xd8));
+        p += 64;
+        dst += 32;
+    }
+
+    _mm256_zeroupper();
+
+    return p - src + njs_str_decode_hex_ssse3(dst, p, end - p);
+}
+
+
+__attribute__((target("avx2")))
+static size_t
+njs_str_encode_base64_avx2(u_char *dst, const u_char *src, size_t size,
+    njs_bool_t url)
+{
+    __m128i       shift;
+    __m256i       v, t0, t1, r, less, shift2;
+    const u_char  *p, *end;
+
+    p = src;
+    end = src + size;
+
+    shift = njs_str_encode_base64_shift_ssse3(url);
+    shift2 = _mm256_broadcastsi128_si256(shift);
+
+    /* Each 128-bit lane encodes 12 of 16 loaded bytes. */
+
+    while (end - p >= 28) {
+        v = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) p)),
+                _mm_loadu_si128((const __m128i *) (p + 12)), 1);
+
+        v = _mm256_shuffle_epi8(v, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+                                                   4, 5, 3, 4, 1, 2, 0, 1,
+                                                   10, 11, 9, 10, 7, 8, 6, 7,
+                                                   4, 5, 3, 4, 1, 2, 0, 1));
+
+        t0 = _mm256_mulhi_epu16(_mm256_and_si256(v,
+                                                 _mm256_set1_epi32(0x0fc0fc00)),
+                                _mm256_set1_epi32(0x04000040));
+        t1 = _mm256_mullo_epi16(_mm256_and_si256(v,
+                                                 _mm256_set1_epi32(0x003f03f0)),
+                                _mm256_set1_epi32(0x01000010));
+        v = _mm256_or_si256(t0, t1);
+
+        r = _mm256_subs_epu8(v, _mm256_set1_epi8(51));
+        less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), v);
+        r = _mm256_or_si256(r, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+
+        _mm256_storeu_si256((__m256i *) dst,
+                            _mm256_add_epi8(v, _mm256_shuffle_epi8(shift2, r)));
+        p += 24;
+        dst += 32;
+    }
+
+    _mm256_zeroupper();
+
+    return p - src + njs_str_encode_base64_ssse3(dst, p, end - p, url);
+}
+
+
+__attribute__((target("avx2")))
+static size_t
+njs_str_decode_base64_avx2(u_char *dst, const u_char *src, size_t size,
+    njs_bool_t url)
+{
+    __m128i       v0, v1;
+    __m256i       v, order;
+    const u_char  *p, *end;
+
+    p = src;
+    end = src + size;
+
+    order = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                             -1, -1, -1, -1,
+                             2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                             -1, -1, -1, -1);
+
+    /*
+     * 32 bytes are stored, 24 of them are decoded, the destination
+     * has room for them while 16 more source bytes remain.
+     */
+
+    while (end - p >= 48) {
+        if (njs_str_decode_base64_block_ssse3(p, &v0, url) != 0
+            || njs_str_decode_base64_block_ssse3(p + 16, &v1, url) != 0)
+        {
+            break;
+        }
+
+        v = _mm256_shuffle_epi8(_mm256_inserti128_si256(
+                                    _mm256_castsi128_si256(v0), v1, 1),
+                                order);
+
+        _mm256_storeu_si256((__m256i *) dst,
+                            _mm256_permutevar8x32_epi32(v,
+                                _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7)));
+        p += 32;
+        dst += 24;
+    }
+
+    _mm256_zeroupper();
+
+    return p - src + njs_str_decode_base64_ssse3(dst, p, end - p, url);
+}
+
+#endif
+
+
+size_t
+njs_str_encode_hex(u_char *dst, const u_char *src, size_t size)
+{
+#if (NJS_HAVE_SSSE3 && NJS_HAVE_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        return njs_str_encode_hex_avx2(dst, src, size);
+    }
+#endif
+
+#if (NJS_HAVE_SSSE3)
+    if (__builtin_cpu_supports("ssse3")) {
+        return njs_str_encode_hex_ssse3(dst, src, size);
+    }
+#endif
+
+    return 0;
+}
+
+
+size_t
+njs_str_decode_hex(u_char *dst, const u_char *src, size_t size)
+{
+#if (NJS_HAVE_SSSE3 && NJS_HAVE_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        return njs_str_decode_hex_avx2(dst, src, size);
+    }
+#endif
+
+#if (NJS_HAVE_SSSE3)
+    if (__builtin_cpu_supports("ssse3")) {
+        return njs_str_decode_hex_ssse3(dst, src, size);
+    }
+#endif
+
+    return 0;
+}
+
+
+size_t
+njs_str_encode_base64(u_char *dst, const u_char *src, size_t size,
+    njs_bool_t url)
+{
+#if (NJS_HAVE_SSSE3 && NJS_HAVE_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        return njs_str_encode_base64_avx2(dst, src, size, url);
+    }
+#endif
+
+#if (NJS_HAVE_SSSE3)
+    if (__builtin_cpu_supports("ssse3")) {
+        return njs_str_encode_base64_ssse3(dst, src, size, url);
+    }
+#endif
+
+    return 0;
+}
+
+
+size_t
+njs_str_decode_base64(u_char *dst, const u_char *src, size_t size,
+    njs_bool_t url)
+{
+#if (NJS_HAVE_SSSE3 && NJS_HAVE_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        return njs_str_decode_base64_avx2(dst, src, size, url);
+    }
+#endif
+
+#if (NJS_HAVE_SSSE3)
+    if (__builtin_cpu_supports("ssse3")) {
+        return njs_str_decode_base64_ssse3(dst, src, size, url);
+    }
+#endif
+
+    return 0;
+}
@@ -76,6 +76,39 @@ njs_strlchr(u_char *p, u_char *last, u_char c)
 }
 
 
+/*
+ * njs_str_search() returns the first occurrence of the needle
+ * in the p - end range, or NULL.
+ */
+NJS_EXPORT u_char *njs_str_search(const u_char *p, const u_char *end,
+    const u_char *needle, size_t size);
+NJS_EXPORT void njs_str_lower_case(u_char *dst, const u_char *src,
+    size_t size);
+NJS_EXPORT void njs_str_upper_case(u_char *dst, const u_char *src,
+    size_t size);
+NJS_EXPORT const u_char *njs_str_skip_space(const u_char *p,
+    const u_char *end);
+NJS_EXPORT const u_char *njs_str_skip_space_back(const u_char *start,
+    const u_char *p);
+
+NJS_EXPORT const u_char *njs_str_escape_find(const u_char *p,
+    const u_char *end, const uint32_t *escape);
+NJS_EXPORT size_t njs_str_escape_count(const u_char *p, const u_char *end,
+    const uint32_t *escape);
+
+/*
+ * The vector prefix of the hex and base64 codecs, see njs_str.c.
+ */
+NJS_EXPORT size_t njs_str_encode_hex(u_char *dst, const u_char *src,
+    size_t size);
+NJS_EXPORT size_t njs_str_decode_hex(u_char *dst, const u_char *src,
+    size_t size);
+NJS_EXPORT size_t njs_str_encode_base64(u_char *dst, const u_char *src,
+    size_t size, njs_bool_t url);
+NJS_EXPORT size_t njs_str_decode_base64(u_char *dst, const u_char *src,
+    size_t size, njs_bool_t url);
+
+
 #define                                                                       \
 njs_strlen(s)                                                                 \
     strlen((char *) s)
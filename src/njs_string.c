@@ -12,13 +12,6 @@
 #define NJS_TRIM_END    2
 
 
-typedef struct {
-    u_char                     *start;
-    size_t                     size;
-    njs_value_t                value;
-} njs_string_replace_part_t;
-
-
 #define NJS_SUBST_COPY        255
 #define NJS_SUBST_PRECEDING   254
 #define NJS_SUBST_FOLLOWING   253
@@ -27,6 +20,7 @@ typedef struct {
 typedef struct {
      uint32_t  type;
      uint32_t  size;
+     ssize_t   length;
      u_char    *start;
 } njs_string_subst_t;
 
@@ -34,17 +28,25 @@ typedef struct {
 typedef struct {
     njs_value_t                retval;
 
-    njs_arr_t                  parts;
-    njs_string_replace_part_t  array[3];
-    njs_string_replace_part_t  *part;
+    njs_chb_t                  chain;
+    ssize_t                    length;
+
+    const u_char               *start;
+    const u_char               *end;
+
+    /* The last match offset in characters. */
+    const u_char               *pos;
+    size_t                     index;
+
+    njs_string_subst_t         literal;
+    njs_string_subst_t         *subst;
+    njs_uint_t                 nsubst;
 
-    njs_arr_t                  *substitutions;
     njs_function_t             *function;
+    njs_value_t                *arguments;
 
     njs_regex_match_data_t     *match_data;
 
-    njs_bool_t                 empty;
-
     njs_utf8_t                 utf8:8;
     njs_regexp_utf8_t          type:8;
 } njs_string_replace_t;
@@ -68,6 +70,8 @@ static njs_int_t njs_string_bytes_from_array(njs_vm_t *vm,
     const njs_value_t *value);
 static njs_int_t njs_string_bytes_from_string(njs_vm_t *vm,
     const njs_value_t *args, njs_uint_t nargs);
+static const u_char *njs_string_utf8_search(const u_char *p,
+    const u_char *end, const u_char *needle, size_t size);
 static njs_int_t njs_string_starts_or_ends_with(njs_vm_t *vm, njs_value_t *args,
     njs_uint_t nargs, njs_bool_t starts);
 static njs_int_t njs_string_trim(njs_vm_t *vm, njs_value_t *value,
@@ -77,26 +81,21 @@ static njs_int_t njs_string_prototype_pad(njs_vm_t *vm, njs_value_t *args,
 static njs_int_t njs_string_match_multiple(njs_vm_t *vm, njs_value_t *args,
     njs_regexp_pattern_t *pattern);
 static njs_int_t njs_string_split_part_add(njs_vm_t *vm, njs_array_t *array,
-    njs_utf8_t utf8, const u_char *start, size_t size);
+    const njs_value_t *src, njs_utf8_t utf8, const u_char *start, size_t size);
 static njs_int_t njs_string_replace_regexp(njs_vm_t *vm, njs_value_t *this,
     njs_value_t *regex, njs_string_replace_t *r);
-static njs_int_t njs_string_replace_regexp_function(njs_vm_t *vm,
-    njs_value_t *this, njs_value_t *regex, njs_string_replace_t *r,
-    int *captures, njs_uint_t n);
-static njs_int_t njs_string_replace_regexp_join(njs_vm_t *vm,
-    njs_string_replace_t *r);
 static njs_int_t njs_string_replace_search(njs_vm_t *vm, njs_value_t *this,
     njs_value_t *search, njs_string_replace_t *r);
-static njs_int_t njs_string_replace_search_function(njs_vm_t *vm,
-        njs_value_t *this, njs_value_t *search, njs_string_replace_t *r);
+static njs_int_t njs_string_replace_match(njs_vm_t *vm, njs_value_t *this,
+    njs_string_replace_t *r, const u_char *base, int *captures, njs_uint_t n);
 static njs_int_t njs_string_replace_parse(njs_vm_t *vm,
     njs_string_replace_t *r, u_char *p, u_char *end, size_t size,
     njs_uint_t ncaptures);
-static njs_int_t njs_string_replace_substitute(njs_vm_t *vm,
-    njs_string_replace_t *r, int *captures);
-static njs_int_t njs_string_replace_join(njs_vm_t *vm, njs_string_replace_t *r);
-static void njs_string_replacement_copy(njs_string_replace_part_t *string,
+static void njs_string_replace_substitute(njs_string_replace_t *r,
+    const u_char *base, int *captures);
+static void njs_string_replace_value(njs_string_replace_t *r,
     const njs_value_t *value);
+static njs_int_t njs_string_replace_join(njs_vm_t *vm, njs_string_replace_t *r);
 static njs_int_t njs_string_encode(njs_vm_t *vm, njs_value_t *value,
     const uint32_t *escape);
 static njs_int_t njs_string_decode(njs_vm_t *vm, njs_value_t *value,
@@ -177,11 +176,59 @@ njs_string_new(njs_vm_t *vm, njs_value_t *value, const u_char *start,
 }
 
 
+/*
+ * njs_string_view() creates a string from the part of the src string.
+ * A long enough part of a long string references the src string bytes
+ * instead of copying them.  UTF-8 strings which may reach the offset map
+ * code are always copied because the map is stored after the string bytes.
+ */
+
+njs_int_t
+njs_string_view(njs_vm_t *vm, njs_value_t *dst, const njs_value_t *src,
+    const u_char *start, uint32_t size, uint32_t length)
+{
+    njs_string_t  *string, *parent;
+
+    if (size < NJS_STRING_VIEW_MIN
+        || src->short_string.size != NJS_STRING_LONG
+        || (size != length && length >= NJS_STRING_MAP_STRIDE))
+    {
+        return njs_string_new(vm, dst, start, size, length);
+    }
+
+    string = njs_mp_alloc(vm->mem_pool, sizeof(njs_string_t));
+    if (njs_slow_path(string == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    parent = src->long_string.data;
+
+    if (src->long_string.external != 0xff && parent->retain != 0xffff) {
+        parent->retain++;
+    }
+
+    string->start = (u_char *) start;
+    string->length = length;
+    string->retain = 1;
+
+    dst->type = NJS_STRING;
+    njs_string_truth(dst, size);
+    dst->short_string.size = NJS_STRING_LONG;
+    dst->short_string.length = 0;
+    dst->long_string.external = 0;
+    dst->long_string.size = size;
+    dst->long_string.data = string;
+
+    return NJS_OK;
+}
+
+
 u_char *
 njs_string_alloc(njs_vm_t *vm, njs_value_t *value, uint64_t size,
     uint64_t length)
 {
-    uint32_t      total, map_offset, *map;
+    uint32_t      total, map_offset, *map, *cursor;
     njs_string_t  *string;
 
     if (njs_slow_path(size > NJS_STRING_MAX_LENGTH)) {
@@ -227,8 +274,12 @@ njs_string_alloc(njs_vm_t *vm, njs_value_t *value, uint64_t size,
         string->retain = 1;
 
         if (map_offset != 0) {
-            map = (uint32_t *) (string->start + map_offset);
+            map = njs_string_map_start(string->start, size);
             map[0] = 0;
+
+            cursor = njs_string_map_cursor(map);
+            cursor[0] = 0;
+            cursor[1] = 0;
         }
 
         return string->start;
@@ -285,7 +336,10 @@ njs_string_hex(njs_vm_t *vm, njs_value_t *value, const njs_str_t *src)
     p = njs_string_alloc(vm, value, len * 2, len * 2);
 
     if (njs_fast_path(p != NULL)) {
-        for (i = 0; i < len; i++) {
+        i = njs_str_encode_hex(p, start, len);
+        p += i * 2;
+
+        for ( /* void */ ; i < len; i++) {
             c = start[i];
             *p++ = hex[c >> 4];
             *p++ = hex[c & 0x0f];
@@ -323,12 +377,20 @@ njs_encode_base64_core(njs_str_t *dst, const njs_str_t *src,
     const u_char *basis, njs_bool_t padding)
 {
    u_char  *d, *s, c0, c1, c2;
-   size_t  len;
+   size_t  len, n;
 
     len = src->length;
     s = src->start;
     d = dst->start;
 
+    /* The base64url alphabet has '-' in place of '+'. */
+
+    n = njs_str_encode_base64(d, s, len, basis[62] == '-');
+
+    s += n;
+    d += n / 3 * 4;
+    len -= n;
+
     while (len > 2) {
         c0 = s[0];
         c1 = s[1];
@@ -445,7 +507,7 @@ njs_string_validate(njs_vm_t *vm, njs_string_prop_t *string, njs_value_t *value)
     u_char    *start;
     size_t    new_size, map_offset;
     ssize_t   size, length;
-    uint32_t  *map;
+    uint32_t  *map, *cursor;
 
     size = value->short_string.size;
 
@@ -496,8 +558,12 @@ njs_string_validate(njs_vm_t *vm, njs_string_prop_t *string, njs_value_t *value)
                     string->start = start;
                     value->long_string.data->start = start;
 
-                    map = (uint32_t *) (start + map_offset);
+                    map = njs_string_map_start(start, size);
                     map[0] = 0;
+
+                    cursor = njs_string_map_cursor(map);
+                    cursor[0] = 0;
+                    cursor[1] = 0;
                 }
             }
 
@@ -985,7 +1051,7 @@ njs_string_prototype_from_utf8(njs_vm_t *vm, njs_value_t *args,
 
     if (string.length != 0) {
         /* ASCII or UTF8 string. */
-        return njs_string_slice(vm, &vm->retval, &string, &slice);
+        return njs_string_slice(vm, &vm->retval, &args[0], &string, &slice);
     }
 
     string.start += slice.start;
@@ -1031,7 +1097,7 @@ njs_string_prototype_to_utf8(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
         return ret;
     }
 
-    return njs_string_slice(vm, &vm->retval, &string, &slice);
+    return njs_string_slice(vm, &vm->retval, &args[0], &string, &slice);
 }
 
 
@@ -1062,7 +1128,7 @@ njs_string_prototype_from_bytes(njs_vm_t *vm, njs_value_t *args,
 
     if (string.length != 0) {
         /* ASCII or UTF8 string. */
-        return njs_string_slice(vm, &vm->retval, &string, &slice);
+        return njs_string_slice(vm, &vm->retval, &args[0], &string, &slice);
     }
 
     size = 0;
@@ -1127,7 +1193,7 @@ njs_string_prototype_to_bytes(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 
     if (string.length == 0) {
         /* Byte string. */
-        return njs_string_slice(vm, &vm->retval, &string, &slice);
+        return njs_string_slice(vm, &vm->retval, &args[0], &string, &slice);
     }
 
     p = njs_string_alloc(vm, &vm->retval, slice.length, 0);
@@ -1137,8 +1203,11 @@ njs_string_prototype_to_bytes(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
         if (string.length != string.size) {
             /* UTF-8 string. */
             end = string.start + string.size;
+            s = end;
 
-            s = njs_string_offset(string.start, end, slice.start);
+            if (slice.start < string.length) {
+                s = njs_string_offset(string.start, end, slice.start);
+            }
 
             length = slice.length;
 
@@ -1191,7 +1260,7 @@ njs_string_prototype_slice(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
         return ret;
     }
 
-    return njs_string_slice(vm, &vm->retval, &string, &slice);
+    return njs_string_slice(vm, &vm->retval, &args[0], &string, &slice);
 }
 
 
@@ -1274,7 +1343,7 @@ njs_string_prototype_substring(njs_vm_t *vm, njs_value_t *args,
     slice.start = start;
     slice.length = length;
 
-    return njs_string_slice(vm, &vm->retval, &string, &slice);
+    return njs_string_slice(vm, &vm->retval, &args[0], &string, &slice);
 }
 
 
@@ -1357,7 +1426,7 @@ njs_string_prototype_substr(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     slice.start = start;
     slice.length = length;
 
-    return njs_string_slice(vm, &vm->retval, &string, &slice);
+    return njs_string_slice(vm, &vm->retval, &args[0], &string, &slice);
 }
 
 
@@ -1393,7 +1462,7 @@ njs_string_prototype_char_at(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     slice.start = start;
     slice.length = length;
 
-    return njs_string_slice(vm, &vm->retval, &string, &slice);
+    return njs_string_slice(vm, &vm->retval, &args[0], &string, &slice);
 }
 
 
@@ -1535,7 +1604,7 @@ njs_string_slice_string_prop(njs_string_prop_t *dst,
 
 
 njs_int_t
-njs_string_slice(njs_vm_t *vm, njs_value_t *dst,
+njs_string_slice(njs_vm_t *vm, njs_value_t *dst, const njs_value_t *src,
     const njs_string_prop_t *string, const njs_slice_prop_t *slice)
 {
     njs_string_prop_t  prop;
@@ -1543,7 +1612,8 @@ njs_string_slice(njs_vm_t *vm, njs_value_t *dst,
     njs_string_slice_string_prop(&prop, string, slice);
 
     if (njs_fast_path(prop.size != 0)) {
-        return njs_string_new(vm, dst, prop.start, prop.size, prop.length);
+        return njs_string_view(vm, dst, src, prop.start, prop.size,
+                               prop.length);
     }
 
     *dst = njs_string_empty;
@@ -1726,10 +1796,12 @@ njs_string_decode_hex(njs_vm_t *vm, njs_value_t *value, const njs_str_t *src)
         return NJS_ERROR;
     }
 
+    i = njs_str_decode_hex(dst, start, len);
+
     n = 0;
-    p = dst;
+    p = dst + i / 2;
 
-    for (i = 0; i < len; i++) {
+    for ( /* void */ ; i < len; i++) {
         c = njs_char_to_hex(start[i]);
         if (njs_slow_path(c < 0)) {
             break;
@@ -1810,7 +1882,7 @@ static njs_int_t
 njs_decode_base64_core(njs_vm_t *vm, njs_value_t *value, const njs_str_t *src,
     const u_char *basis)
 {
-    size_t  len, dst_len;
+    size_t  len, dst_len, n;
     u_char  *d, *s, *dst;
 
     if (njs_slow_path(src->length == 0)) {
@@ -1818,7 +1890,23 @@ njs_decode_base64_core(njs_vm_t *vm, njs_value_t *value, const njs_str_t *src,
         return NJS_OK;
     }
 
-    for (len = 0; len < src->length; len++) {
+    /*
+     * The string is allocated for the whole source and truncated
+     * if the source is padded or contains an invalid character.
+     */
+
+    dst_len = njs_base64_decoded_length(src->length);
+
+    dst = njs_string_alloc(vm, value, dst_len, 0);
+    if (njs_slow_path(dst == NULL)) {
+        return NJS_ERROR;
+    }
+
+    /* The base64url alphabet has '-' in place of '+'. */
+
+    n = njs_str_decode_base64(dst, src->start, src->length, basis['-'] == 62);
+
+    for (len = n; len < src->length; len++) {
         if (src->start[len] == '=') {
             break;
         }
@@ -1833,15 +1921,9 @@ njs_decode_base64_core(njs_vm_t *vm, njs_value_t *value, const njs_str_t *src,
         len -= 1;
     }
 
-    dst_len = njs_base64_decoded_length(len);
-
-    dst = njs_string_alloc(vm, value, dst_len, 0);
-    if (njs_slow_path(dst == NULL)) {
-        return NJS_ERROR;
-    }
-
-    s = src->start;
-    d = dst;
+    s = src->start + n;
+    d = dst + n / 4 * 3;
+    len -= n;
 
     while (len > 3) {
         *d++ = (u_char) (basis[s[0]] << 2 | basis[s[1]] >> 4);
@@ -2019,29 +2101,26 @@ njs_string_prototype_index_of(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
             if (string.size == (size_t) length) {
                 /* Byte or ASCII string. */
 
-                end -= (search.size - 1);
-
-                for (p = string.start + index; p < end; p++) {
-                    if (memcmp(p, search.start, search.size) == 0) {
-                        goto done;
-                    }
-
-                    index++;
+                p = njs_str_search(string.start + index, end, search.start,
+                                   search.size);
+                if (p != NULL) {
+                    index = p - string.start;
+                    goto done;
                 }
 
             } else {
                 /* UTF-8 string. */
 
-                p = njs_string_offset(string.start, end, index);
-                end -= search.size - 1;
+                if (search_length == 0) {
+                    goto done;
+                }
 
-                while (p < end) {
-                    if (memcmp(p, search.start, search.size) == 0) {
-                        goto done;
-                    }
+                p = njs_string_offset(string.start, end, index);
+                p = njs_string_utf8_search(p, end, search.start, search.size);
 
-                    index++;
-                    p = njs_utf8_next(p, end);
+                if (p != NULL) {
+                    index = njs_string_index(&string, p - string.start);
+                    goto done;
                 }
             }
 
@@ -2061,6 +2140,28 @@ done:
 }
 
 
+/*
+ * njs_string_utf8_search() skips the occurrences which do not start
+ * at a character boundary.  They are possible if the needle is a byte
+ * string.
+ */
+
+static const u_char *
+njs_string_utf8_search(const u_char *p, const u_char *end,
+    const u_char *needle, size_t size)
+{
+    for ( ;; ) {
+        p = njs_str_search(p, end, needle, size);
+
+        if (p == NULL || size == 0 || (*p & 0xC0) != 0x80) {
+            return p;
+        }
+
+        p++;
+    }
+}
+
+
 static njs_int_t
 njs_string_prototype_last_index_of(njs_vm_t *vm, njs_value_t *args,
     njs_uint_t nargs, njs_index_t unused)
@@ -2253,14 +2354,8 @@ njs_string_prototype_includes(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
                 p = njs_string_offset(string.start, end, index);
             }
 
-            end -= search.size - 1;
-
-            while (p < end) {
-                if (memcmp(p, search.start, search.size) == 0) {
-                    goto done;
-                }
-
-                p++;
+            if (njs_str_search(p, end, search.start, search.size) != NULL) {
+                goto done;
             }
         }
     }
@@ -2395,30 +2490,62 @@ done:
 
 
 /*
- * njs_string_offset() assumes that index is correct.
+ * njs_string_offset() assumes that index is correct and is less than
+ * the string length, because the map has no entry for the string end.
  */
 
 const u_char *
 njs_string_offset(const u_char *start, const u_char *end, size_t index)
 {
-    uint32_t    *map;
-    njs_uint_t  skip;
+    size_t        last;
+    uint32_t      *map, *cursor;
+    njs_uint_t    skip;
+    const u_char  *p;
 
-    if (index >= NJS_STRING_MAP_STRIDE) {
-        map = njs_string_map_start(end);
+    if (index < NJS_STRING_MAP_STRIDE) {
+        /* The string may have no map. */
 
-        if (map[0] == 0) {
-            njs_string_offset_map_init(start, end - start);
+        for (skip = index; skip != 0; skip--) {
+            start = njs_utf8_next(start, end);
+        }
+
+        return start;
+    }
+
+    map = njs_string_map_start(start, end - start);
+
+    if (map[0] == 0) {
+        njs_string_offset_map_init(start, end - start);
+    }
+
+    cursor = njs_string_map_cursor(map);
+    last = cursor[0];
+    skip = index % NJS_STRING_MAP_STRIDE;
+
+    if (last <= index && index - last < skip) {
+        p = start + cursor[1];
+        skip = index - last;
+
+    } else if (last > index && last - index < skip) {
+        p = start + cursor[1];
+
+        for (skip = last - index; skip != 0; skip--) {
+            p = njs_utf8_prev(p);
         }
 
-        start += map[index / NJS_STRING_MAP_STRIDE - 1];
+    } else {
+        p = start + map[index / NJS_STRING_MAP_STRIDE - 1];
     }
 
-    for (skip = index % NJS_STRING_MAP_STRIDE; skip != 0; skip--) {
-        start = njs_utf8_next(start, end);
+    while (skip != 0) {
+        p = njs_utf8_next(p, end);
+        skip--;
     }
 
-    return start;
+    cursor[0] = index;
+    cursor[1] = p - start;
+
+    return p;
 }
 
 
@@ -2439,10 +2566,9 @@ njs_string_index(njs_string_prop_t *string, uint32_t offset)
     last = 0;
     index = 0;
 
-    if (string->length >= NJS_STRING_MAP_STRIDE) {
+    if (string->length > NJS_STRING_MAP_STRIDE) {
 
-        end = string->start + string->size;
-        map = njs_string_map_start(end);
+        map = njs_string_map_start(string->start, string->size);
 
         if (map[0] == 0) {
             njs_string_offset_map_init(string->start, string->size);
@@ -2478,7 +2604,7 @@ njs_string_offset_map_init(const u_char *start, size_t size)
     const u_char  *p, *end;
 
     end = start + size;
-    map = njs_string_map_start(end);
+    map = njs_string_map_start(start, size);
     p = start;
     n = 0;
     offset = NJS_STRING_MAP_STRIDE;
@@ -2508,11 +2634,11 @@ static njs_int_t
 njs_string_prototype_to_lower_case(njs_vm_t *vm, njs_value_t *args,
     njs_uint_t nargs, njs_index_t unused)
 {
-    size_t             size, length;
+    size_t             size;
     u_char             *p;
     uint32_t           code;
     njs_int_t          ret;
-    const u_char       *s, *end;
+    const u_char       *s, *end, *ascii;
     njs_string_prop_t  string;
 
     ret = njs_string_object_validate(vm, njs_arg(args, nargs, 0));
@@ -2530,26 +2656,26 @@ njs_string_prototype_to_lower_case(njs_vm_t *vm, njs_value_t *args,
             return NJS_ERROR;
         }
 
-        s = string.start;
-        size = string.size;
-
-        while (size != 0) {
-            *p++ = njs_lower_case(*s++);
-            size--;
-        }
+        njs_str_lower_case(p, string.start, string.size);
 
     } else {
         /* UTF-8 string. */
         s = string.start;
         end = s + string.size;
-        length = string.length;
 
         size = 0;
 
-        while (length != 0) {
+        for ( ;; ) {
+            ascii = njs_utf8_ascii(s, end);
+            size += ascii - s;
+            s = ascii;
+
+            if (s == end) {
+                break;
+            }
+
             code = njs_utf8_lower_case(&s, end);
             size += njs_utf8_size(code);
-            length--;
         }
 
         p = njs_string_alloc(vm, &vm->retval, size, string.length);
@@ -2558,12 +2684,19 @@ njs_string_prototype_to_lower_case(njs_vm_t *vm, njs_value_t *args,
         }
 
         s = string.start;
-        length = string.length;
 
-        while (length != 0) {
+        for ( ;; ) {
+            ascii = njs_utf8_ascii(s, end);
+            njs_str_lower_case(p, s, ascii - s);
+            p += ascii - s;
+            s = ascii;
+
+            if (s == end) {
+                break;
+            }
+
             code = njs_utf8_lower_case(&s, end);
             p = njs_utf8_encode(p, code);
-            length--;
         }
     }
 
@@ -2581,11 +2714,11 @@ static njs_int_t
 njs_string_prototype_to_upper_case(njs_vm_t *vm, njs_value_t *args,
     njs_uint_t nargs, njs_index_t unused)
 {
-    size_t             size, length;
+    size_t             size;
     u_char             *p;
     uint32_t           code;
     njs_int_t          ret;
-    const u_char       *s, *end;
+    const u_char       *s, *end, *ascii;
     njs_string_prop_t  string;
 
     ret = njs_string_object_validate(vm, njs_arg(args, nargs, 0));
@@ -2603,26 +2736,26 @@ njs_string_prototype_to_upper_case(njs_vm_t *vm, njs_value_t *args,
             return NJS_ERROR;
         }
 
-        s = string.start;
-        size = string.size;
-
-        while (size != 0) {
-            *p++ = njs_upper_case(*s++);
-            size--;
-        }
+        njs_str_upper_case(p, string.start, string.size);
 
     } else {
         /* UTF-8 string. */
         s = string.start;
         end = s + string.size;
-        length = string.length;
 
         size = 0;
 
-        while (length != 0) {
+        for ( ;; ) {
+            ascii = njs_utf8_ascii(s, end);
+            size += ascii - s;
+            s = ascii;
+
+            if (s == end) {
+                break;
+            }
+
             code = njs_utf8_upper_case(&s, end);
             size += njs_utf8_size(code);
-            length--;
         }
 
         p = njs_string_alloc(vm, &vm->retval, size, string.length);
@@ -2631,12 +2764,19 @@ njs_string_prototype_to_upper_case(njs_vm_t *vm, njs_value_t *args,
         }
 
         s = string.start;
-        length = string.length;
 
-        while (length != 0) {
+        for ( ;; ) {
+            ascii = njs_utf8_ascii(s, end);
+            njs_str_upper_case(p, s, ascii - s);
+            p += ascii - s;
+            s = ascii;
+
+            if (s == end) {
+                break;
+            }
+
             code = njs_utf8_upper_case(&s, end);
             p = njs_utf8_encode(p, code);
-            length--;
         }
     }
 
@@ -2704,6 +2844,18 @@ njs_string_trim(njs_vm_t *vm, njs_value_t *value, njs_uint_t mode)
     start = string.start;
     end = string.start + string.size;
 
+    if (mode & NJS_TRIM_START) {
+        p = njs_str_skip_space(start, end);
+        trim += p - start;
+        start = p;
+    }
+
+    if (mode & NJS_TRIM_END) {
+        p = njs_str_skip_space_back(start, end);
+        trim += end - p;
+        end = p;
+    }
+
     if (string.length == 0 || string.length == string.size) {
         /* Byte or ASCII string. */
 
@@ -2795,7 +2947,7 @@ njs_string_trim(njs_vm_t *vm, njs_value_t *value, njs_uint_t mode)
 
     length = (string.length != 0) ? string.length - trim : 0;
 
-    return njs_string_new(vm, &vm->retval, start, end - start, length);
+    return njs_string_view(vm, &vm->retval, value, start, end - start, length);
 
 empty:
 
@@ -3045,7 +3197,7 @@ njs_string_prototype_search(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
             (void) njs_string_prop(&string, value);
 
             if (string.size != 0) {
-                pattern = njs_regexp_pattern_create(vm, string.start,
+                pattern = njs_regexp_pattern_cached(vm, string.start,
                                                     string.size, 0);
                 if (njs_slow_path(pattern == NULL)) {
                     return NJS_ERROR;
@@ -3063,8 +3215,8 @@ njs_string_prototype_search(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 
         n = (string.length != 0);
 
-        if (njs_regex_is_valid(&pattern->regex[n])) {
-            ret = njs_regexp_match(vm, &pattern->regex[n], string.start,
+        if (njs_regexp_pattern_valid(vm, pattern, n)) {
+            ret = njs_regexp_match(vm, pattern, n, string.start, 0,
                                    string.size, vm->single_match_data);
             if (ret >= 0) {
                 captures = njs_regex_captures(vm->single_match_data);
@@ -3183,18 +3335,25 @@ njs_string_match_multiple(njs_vm_t *vm, njs_value_t *args,
         }
     }
 
-    if (njs_regex_is_valid(&pattern->regex[type])) {
+    if (njs_regexp_pattern_valid(vm, pattern, type)) {
 
         array = njs_array_alloc(vm, 0, NJS_ARRAY_SPARE);
         if (njs_slow_path(array == NULL)) {
             return NJS_ERROR;
         }
 
+        /*
+         * The whole subject is matched from the current offset, so it is
+         * checked for UTF-8 validity once.  The matches are string views
+         * of the subject.
+         */
+
         p = string.start;
         end = p + string.size;
 
         do {
-            ret = njs_regexp_match(vm, &pattern->regex[type], p, string.size,
+            ret = njs_regexp_match(vm, pattern, type, string.start,
+                                   p - string.start, string.size,
                                    vm->single_match_data);
             if (ret < 0) {
                 if (njs_fast_path(ret == NJS_REGEX_NOMATCH)) {
@@ -3212,32 +3371,30 @@ njs_string_match_multiple(njs_vm_t *vm, njs_value_t *args,
             }
 
             captures = njs_regex_captures(vm->single_match_data);
-            start = p + captures[0];
+            start = string.start + captures[0];
 
-            if (captures[1] == 0) {
+            if (captures[1] == captures[0]) {
                 if (start < end) {
                     p = (utf8 != NJS_STRING_BYTE) ? njs_utf8_next(start, end)
                                                   : start + 1;
-                    string.size = end - p;
 
                 } else {
                     /* To exit the loop. */
-                    p++;
+                    p = end + 1;
                 }
 
                 size = 0;
                 length = 0;
 
             } else {
-                p += captures[1];
-                string.size -= captures[1];
+                p = string.start + captures[1];
 
                 size = captures[1] - captures[0];
                 length = njs_string_calc_length(utf8, start, size);
             }
 
-            ret = njs_string_new(vm, &array->start[array->length],
-                                 start, size, length);
+            ret = njs_string_view(vm, &array->start[array->length], &args[0],
+                                  start, size, length);
             if (njs_slow_path(ret != NJS_OK)) {
                 return ret;
             }
@@ -3268,7 +3425,7 @@ njs_string_prototype_split(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     njs_utf8_t            utf8;
     njs_value_t           *value;
     njs_array_t           *array;
-    const u_char          *p, *start, *next, *last, *end;
+    const u_char          *p, *start, *next, *end;
     njs_regexp_utf8_t     type;
     njs_string_prop_t     string, split;
     njs_regexp_pattern_t  *pattern;
@@ -3329,7 +3486,7 @@ njs_string_prototype_split(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
         case NJS_REGEXP:
             pattern = njs_regexp_pattern(&args[1]);
 
-            if (!njs_regex_is_valid(&pattern->regex[type])) {
+            if (!njs_regexp_pattern_valid(vm, pattern, type)) {
                 goto single;
             }
 
@@ -3337,13 +3494,14 @@ njs_string_prototype_split(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
             end = string.start + string.size;
 
             do {
-                ret = njs_regexp_match(vm, &pattern->regex[type], start,
-                                       end - start, vm->single_match_data);
+                ret = njs_regexp_match(vm, pattern, type, string.start,
+                                       start - string.start, string.size,
+                                       vm->single_match_data);
                 if (ret >= 0) {
                     captures = njs_regex_captures(vm->single_match_data);
 
-                    p = start + captures[0];
-                    next = start + captures[1];
+                    p = string.start + captures[0];
+                    next = string.start + captures[1];
 
                 } else if (ret == NJS_REGEX_NOMATCH) {
                     p = (u_char *) end;
@@ -3362,7 +3520,8 @@ njs_string_prototype_split(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 
                 size = p - start;
 
-                ret = njs_string_split_part_add(vm, array, utf8, start, size);
+                ret = njs_string_split_part_add(vm, array, &args[0], utf8,
+                                                start, size);
                 if (njs_slow_path(ret != NJS_OK)) {
                     return ret;
                 }
@@ -3393,19 +3552,13 @@ njs_string_prototype_split(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
 
             start = string.start;
             end = string.start + string.size;
-            last = end - split.size;
 
             do {
-                for (p = start; p <= last; p++) {
-                    if (memcmp(p, split.start, split.size) == 0) {
-                        goto found;
-                    }
+                p = njs_str_search(start, end, split.start, split.size);
+                if (p == NULL) {
+                    p = end;
                 }
 
-                p = end;
-
-found:
-
                 next = p + split.size;
 
                 /* Empty split string. */
@@ -3417,7 +3570,8 @@ found:
 
                 size = p - start;
 
-                ret = njs_string_split_part_add(vm, array, utf8, start, size);
+                ret = njs_string_split_part_add(vm, array, &args[0], utf8,
+                                                start, size);
                 if (njs_slow_path(ret != NJS_OK)) {
                     return ret;
                 }
@@ -3446,32 +3600,67 @@ done:
 
 
 static njs_int_t
-njs_string_split_part_add(njs_vm_t *vm, njs_array_t *array, njs_utf8_t utf8,
-    const u_char *start, size_t size)
+njs_string_split_part_add(njs_vm_t *vm, njs_array_t *array,
+    const njs_value_t *src, njs_utf8_t utf8, const u_char *start, size_t size)
 {
-    ssize_t  length;
+    ssize_t    length;
+    njs_int_t  ret;
 
     length = njs_string_calc_length(utf8, start, size);
 
-    return njs_array_string_add(vm, array, start, size, length);
+    ret = njs_array_expand(vm, array, 0, 1);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
+
+    return njs_string_view(vm, &array->start[array->length++], src, start,
+                           size, length);
 }
 
 
 /*
  * String.replace([regexp|string[, string|function]])
+ *
+ * The result is streamed into a chain buffer as the matches are found,
+ * so the memory used is proportional to the output.  A replacement string
+ * is parsed once into a template of literal parts and "$" substitutions,
+ * and the UTF-8 length of the result is accumulated along the way.
  */
 
+njs_inline void
+njs_string_replace_append(njs_string_replace_t *r, const u_char *start,
+    size_t size, ssize_t length)
+{
+    if (size != 0) {
+        njs_chb_append(&r->chain, start, size);
+
+        r->length = (r->length >= 0 && length >= 0) ? r->length + length : -1;
+    }
+}
+
+
+njs_inline void
+njs_string_replace_subject(njs_string_replace_t *r, const u_char *start,
+    size_t size)
+{
+    njs_string_replace_append(r, start, size,
+                              (r->utf8 == NJS_STRING_ASCII)
+                              ? (ssize_t) size : njs_utf8_length(start, size));
+}
+
+
 static njs_int_t
 njs_string_prototype_replace(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     njs_index_t unused)
 {
-    u_char                *p, *start, *end;
+    u_char                *p, *end;
     njs_int_t             ret;
     njs_uint_t            ncaptures;
     njs_value_t           *this, *search, *replace;
     njs_value_t           search_lvalue, replace_lvalue;
     njs_regex_t           *regex;
-    njs_string_prop_t     string;
+    njs_string_prop_t     string, replacement;
+    njs_regexp_pattern_t  *pattern;
     njs_string_replace_t  *r, string_replace;
 
     ret = njs_string_object_validate(vm, njs_arg(args, nargs, 0));
@@ -3509,12 +3698,13 @@ njs_string_prototype_replace(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
     }
 
     if (njs_is_regexp(search)) {
-        regex = &njs_regexp_pattern(search)->regex[r->type];
+        pattern = njs_regexp_pattern(search);
 
-        if (!njs_regex_is_valid(regex)) {
+        if (!njs_regexp_pattern_valid(vm, pattern, r->type)) {
             goto original;
         }
 
+        regex = &pattern->regex[r->type];
         ncaptures = njs_regex_ncaptures(regex);
 
     } else {
@@ -3529,58 +3719,72 @@ njs_string_prototype_replace(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
         }
     }
 
-    /* This cannot fail. */
-    r->part = njs_arr_init(vm->mem_pool, &r->parts, &r->array,
-                           3, sizeof(njs_string_replace_part_t));
-
-    r->substitutions = NULL;
+    r->subst = &r->literal;
+    r->nsubst = 1;
     r->function = NULL;
+    r->arguments = NULL;
 
-    /* A literal replacement is stored in the second part. */
+    if (njs_is_function(replace)) {
+        r->function = njs_function(replace);
 
-    if (nargs == 2) {
-        njs_string_replacement_copy(&r->part[1], &njs_string_undefined);
+        /* The matched substrings, the offset and the whole string. */
 
-    } else if (njs_is_function(replace)) {
-        r->function = njs_function(replace);
+        r->arguments = njs_mp_alloc(vm->mem_pool,
+                                    (ncaptures + 3) * sizeof(njs_value_t));
+        if (njs_slow_path(r->arguments == NULL)) {
+            njs_memory_error(vm);
+            return NJS_ERROR;
+        }
 
     } else {
-        if (njs_slow_path(!njs_is_string(replace))) {
+        if (nargs == 2) {
+            replace = njs_value_arg(&njs_string_undefined);
+
+        } else if (njs_slow_path(!njs_is_string(replace))) {
             ret = njs_value_to_string(vm, replace, replace);
             if (njs_slow_path(ret != NJS_OK)) {
                 return ret;
             }
         }
 
-        njs_string_replacement_copy(&r->part[1], replace);
+        (void) njs_string_prop(&replacement, replace);
+
+        /* A replacement without substitutions is a single literal part. */
 
-        start = r->part[1].start;
+        r->literal.type = NJS_SUBST_COPY;
+        r->literal.start = replacement.start;
+        r->literal.size = replacement.size;
+        r->literal.length = replacement.length;
 
-        if (start == NULL) {
-            start = r->part[1].value.short_string.start;
+        if (replacement.length == 0 && replacement.size != 0) {
+            r->literal.length = njs_utf8_length(replacement.start,
+                                                replacement.size);
         }
 
-        end = start + r->part[1].size;
+        end = replacement.start + replacement.size;
 
-        for (p = start; p < end; p++) {
+        for (p = replacement.start; p < end; p++) {
             if (*p == '$') {
-                ret = njs_string_replace_parse(vm, r, p, end, p - start,
+                ret = njs_string_replace_parse(vm, r, p, end,
+                                               p - replacement.start,
                                                ncaptures);
                 if (njs_slow_path(ret != NJS_OK)) {
                     return ret;
                 }
 
-                /* Reset parts array to the subject string only. */
-                r->parts.items = 1;
-
                 break;
             }
         }
     }
 
-    r->part[0].start = string.start;
-    r->part[0].size = string.size;
-    njs_set_invalid(&r->part[0].value);
+    r->start = string.start;
+    r->end = string.start + string.size;
+
+    r->pos = string.start;
+    r->index = 0;
+
+    njs_chb_init(&r->chain, vm->mem_pool);
+    r->length = 0;
 
     if (regex != NULL) {
         r->match_data = njs_regex_match_data(regex, vm->regex_context);
@@ -3588,10 +3792,25 @@ njs_string_prototype_replace(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
             return NJS_ERROR;
         }
 
-        return njs_string_replace_regexp(vm, this, search, r);
+        ret = njs_string_replace_regexp(vm, this, search, r);
+
+        njs_regex_match_data_free(r->match_data, vm->regex_context);
+
+    } else {
+        ret = njs_string_replace_search(vm, this, search, r);
+    }
+
+    njs_chb_destroy(&r->chain);
+
+    if (r->arguments != NULL) {
+        njs_mp_free(vm->mem_pool, r->arguments);
+    }
+
+    if (r->subst != &r->literal) {
+        njs_mp_free(vm->mem_pool, r->subst);
     }
 
-    return njs_string_replace_search(vm, this, search, r);
+    return ret;
 
 original:
 
@@ -3605,22 +3824,31 @@ static njs_int_t
 njs_string_replace_regexp(njs_vm_t *vm, njs_value_t *this, njs_value_t *regex,
     njs_string_replace_t *r)
 {
-    int                        *captures;
-    u_char                     *p, *start;
-    njs_int_t                  ret;
-    const u_char               *end;
-    njs_regexp_pattern_t       *pattern;
-    njs_string_replace_part_t  replace;
+    int                   *captures;
+    njs_int_t             ret;
+    njs_uint_t            n;
+    njs_regex_t           *rx;
+    const u_char          *p, *last, *start, *end;
+    njs_regexp_pattern_t  *pattern;
 
     pattern = njs_regexp_pattern(regex);
-    end = r->part[0].start + r->part[0].size;
+    rx = &pattern->regex[r->type];
+    n = njs_regex_ncaptures(rx);
+
+    start = r->start;
+    end = r->end;
+
+    /*
+     * The subject is searched from the "p" position and is copied
+     * to the result up to the "last" position.
+     */
 
-    replace = r->part[1];
+    p = start;
+    last = NULL;
 
     do {
-        ret = njs_regexp_match(vm, &pattern->regex[r->type],
-                               r->part[0].start, r->part[0].size,
-                               r->match_data);
+        ret = njs_regexp_match(vm, pattern, r->type, start, p - start,
+                               end - start, r->match_data);
 
         if (ret < 0) {
             if (njs_slow_path(ret != NJS_REGEX_NOMATCH)) {
@@ -3632,299 +3860,162 @@ njs_string_replace_regexp(njs_vm_t *vm, njs_value_t *this, njs_value_t *regex,
 
         captures = njs_regex_captures(r->match_data);
 
-        if (r->substitutions != NULL) {
-            ret = njs_string_replace_substitute(vm, r, captures);
-            if (njs_slow_path(ret != NJS_OK)) {
-                return ret;
-            }
-
-            if (!pattern->global) {
-                return njs_string_replace_regexp_join(vm, r);
-            }
-
-            continue;
+        if (last == NULL) {
+            last = start;
         }
 
-        if (r->part != r->parts.start) {
-            r->part = njs_arr_add(&r->parts);
-            if (njs_slow_path(r->part == NULL)) {
-                return NJS_ERROR;
-            }
-
-            r->part = njs_arr_add(&r->parts);
-            if (njs_slow_path(r->part == NULL)) {
-                return NJS_ERROR;
-            }
+        njs_string_replace_subject(r, last, start + captures[0] - last);
 
-            r->part -= 2;
+        ret = njs_string_replace_match(vm, this, r, start, captures, n);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
         }
 
-        if (captures[1] == 0) {
-
-            /* Empty match. */
-
-            start = r->part[0].start;
-
-            if (start < end) {
-                p = (r->utf8 != NJS_STRING_BYTE)
-                    ? (u_char *) njs_utf8_next(start, end) : start + 1;
+        last = start + captures[1];
 
-                r->part[1].start = start;
-                r->part[1].size = p - start;
+        if (captures[0] != captures[1]) {
+            p = last;
 
-                r->part[2].start = p;
-                r->part[2].size = end - p;
+        } else {
 
-            } else {
-                r->part[1].size = 0;
-                r->part[2].size = 0;
+            /* An empty match, the next search starts after a character. */
 
-                /* To exit the loop. */
-                r->part[2].start = start + 1;
+            if (last == end) {
+                break;
             }
 
-            if (r->function != NULL) {
-                return njs_string_replace_regexp_function(vm, this, regex, r,
-                                                          captures, ret);
-            }
+            p = (r->utf8 != NJS_STRING_BYTE) ? njs_utf8_next(last, end)
+                                             : last + 1;
+        }
 
-            r->part[0] = replace;
+    } while (pattern->global);
 
-        } else {
-            r->part[2].start = r->part[0].start + captures[1];
-            r->part[2].size = r->part[0].size - captures[1];
-            njs_set_invalid(&r->part[2].value);
+    if (last == NULL) {
+        njs_string_copy(&vm->retval, this);
+        return NJS_OK;
+    }
 
-            if (r->function != NULL) {
-                return njs_string_replace_regexp_function(vm, this, regex, r,
-                                                          captures, ret);
-            }
+    njs_string_replace_subject(r, last, end - last);
 
-            r->part[0].size = captures[0];
+    return njs_string_replace_join(vm, r);
+}
 
-            r->part[1] = replace;
-        }
 
-        if (!pattern->global) {
-            return njs_string_replace_regexp_join(vm, r);
-        }
+static njs_int_t
+njs_string_replace_search(njs_vm_t *vm, njs_value_t *this, njs_value_t *search,
+    njs_string_replace_t *r)
+{
+    int           captures[2];
+    njs_int_t     ret;
+    njs_str_t     string;
+    const u_char  *p;
+
+    njs_string_get(search, &string);
 
-        r->part += 2;
+    if (r->utf8 < 2) {
+        p = njs_str_search(r->start, r->end, string.start, string.length);
 
-    } while (r->part[0].start <= end);
+    } else {
+        p = njs_string_utf8_search(r->start, r->end, string.start,
+                                   string.length);
+    }
 
-    if (r->part != r->parts.start) {
-        return njs_string_replace_regexp_join(vm, r);
+    if (p == NULL) {
+        njs_string_copy(&vm->retval, this);
+        return NJS_OK;
     }
 
-    njs_regex_match_data_free(r->match_data, vm->regex_context);
+    captures[0] = p - r->start;
+    captures[1] = captures[0] + string.length;
 
-    njs_arr_destroy(&r->parts);
+    njs_string_replace_subject(r, r->start, captures[0]);
 
-    njs_string_copy(&vm->retval, this);
+    ret = njs_string_replace_match(vm, this, r, r->start, captures, 1);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
 
-    return NJS_OK;
+    njs_string_replace_subject(r, p + string.length,
+                               r->end - p - string.length);
+
+    return njs_string_replace_join(vm, r);
 }
 
 
+/*
+ * Appends the replacement of a match, the captures are offsets
+ * from the base position.
+ */
+
 static njs_int_t
-njs_string_replace_regexp_function(njs_vm_t *vm, njs_value_t *this,
-    njs_value_t *regex, njs_string_replace_t *r, int *captures, njs_uint_t n)
+njs_string_replace_match(njs_vm_t *vm, njs_value_t *this,
+    njs_string_replace_t *r, const u_char *base, int *captures, njs_uint_t n)
 {
-    u_char             *start;
-    size_t             size, length;
-    njs_int_t          ret;
-    njs_uint_t         i, k;
-    njs_value_t        *arguments;
-    njs_string_prop_t  string;
-
-    njs_set_invalid(&r->retval);
+    size_t        size;
+    njs_int_t     ret;
+    njs_uint_t    i;
+    njs_value_t   *arguments;
+    const u_char  *start;
 
-    arguments = njs_mp_alloc(vm->mem_pool, (n + 3) * sizeof(njs_value_t));
-    if (njs_slow_path(arguments == NULL)) {
-        return NJS_ERROR;
+    if (r->function == NULL) {
+        njs_string_replace_substitute(r, base, captures);
+        return NJS_OK;
     }
 
+    arguments = r->arguments;
+
     njs_set_undefined(&arguments[0]);
 
     /* Matched substring and parenthesized submatch strings. */
-    for (k = 0, i = 1; i <= n; i++) {
-
-        start = r->part[0].start + captures[k];
-        size = captures[k + 1] - captures[k];
-        k += 2;
 
-        length = njs_string_calc_length(r->utf8, start, size);
-
-        ret = njs_string_new(vm, &arguments[i], start, size, length);
-        if (njs_slow_path(ret != NJS_OK)) {
-            return NJS_ERROR;
+    for (i = 0; i < n; i++) {
+        if (captures[2 * i] < 0) {
+            njs_set_undefined(&arguments[i + 1]);
+            continue;
         }
-    }
-
-    r->empty = (captures[0] == captures[1]);
-
-    /* The offset of the matched substring. */
-    njs_set_number(&arguments[n + 1], captures[0]);
-
-    /* The whole string being examined. */
-    length = njs_string_calc_length(r->utf8, r->part[0].start, r->part[0].size);
-
-    (void) njs_string_prop(&string, this);
-
-    ret = njs_string_new(vm, &arguments[n + 2], string.start, string.size,
-                         length);
-
-    if (njs_slow_path(ret != NJS_OK)) {
-        return NJS_ERROR;
-    }
 
-    r->part[0].size = captures[0];
+        start = base + captures[2 * i];
+        size = captures[2 * i + 1] - captures[2 * i];
 
-    ret = njs_function_apply(vm, r->function, arguments, n + 3, &r->retval);
-
-    if (njs_slow_path(ret != NJS_OK)) {
-        return ret;
-    }
-
-    (void) njs_string_prop(&string, this);
-
-    if (njs_is_string(&r->retval)) {
-        njs_string_replacement_copy(&r->part[r->empty ? 0 : 1], &r->retval);
-
-        if (njs_regexp_pattern(regex)->global) {
-            r->part += 2;
-
-            if (r->part[0].start > (string.start + string.size)) {
-                return njs_string_replace_regexp_join(vm, r);
-            }
-
-            return njs_string_replace_regexp(vm, this, regex, r);
+        ret = njs_string_view(vm, &arguments[i + 1], this, start, size,
+                              njs_string_calc_length(r->utf8, start, size));
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
         }
-
-        return njs_string_replace_regexp_join(vm, r);
     }
 
-    njs_regex_match_data_free(r->match_data, vm->regex_context);
-
-    njs_internal_error(vm, "unexpected retval type:%s",
-                       njs_type_string(r->retval.type));
-
-    return NJS_ERROR;
-}
-
-
-static njs_int_t
-njs_string_replace_regexp_join(njs_vm_t *vm, njs_string_replace_t *r)
-{
-    njs_regex_match_data_free(r->match_data, vm->regex_context);
-
-    return njs_string_replace_join(vm, r);
-}
-
-
-static njs_int_t
-njs_string_replace_search(njs_vm_t *vm, njs_value_t *this, njs_value_t *search,
-    njs_string_replace_t *r)
-{
-    int        captures[2];
-    u_char     *p, *end;
-    size_t     size;
-    njs_int_t  ret;
-    njs_str_t  string;
-
-    njs_string_get(search, &string);
-
-    p = r->part[0].start;
-    end = (p + r->part[0].size) - (string.length - 1);
-
-    while (p < end) {
-        if (memcmp(p, string.start, string.length) == 0) {
-
-            if (r->substitutions != NULL) {
-                captures[0] = p - r->part[0].start;
-                captures[1] = captures[0] + string.length;
-
-                ret = njs_string_replace_substitute(vm, r, captures);
-                if (njs_slow_path(ret != NJS_OK)) {
-                    return ret;
-                }
-
-            } else {
-                r->part[2].start = p + string.length;
-                size = p - r->part[0].start;
-                r->part[2].size = r->part[0].size - size - string.length;
-                r->part[0].size = size;
-                njs_set_invalid(&r->part[2].value);
-
-                if (r->function != NULL) {
-                    return njs_string_replace_search_function(vm, this, search,
-                                                              r);
-                }
-            }
+    /* The offset of the matched substring. */
 
-            return njs_string_replace_join(vm, r);
-        }
+    start = base + captures[0];
 
-        if (r->utf8 < 2) {
-            p++;
+    if (r->utf8 == NJS_STRING_UTF8) {
+        r->index += njs_utf8_length(r->pos, start - r->pos);
+        r->pos = start;
 
-        } else {
-            p = (u_char *) njs_utf8_next(p, end);
-        }
+    } else {
+        r->index = start - r->start;
     }
 
-    njs_string_copy(&vm->retval, this);
-
-    return NJS_OK;
-}
-
-
-static njs_int_t
-njs_string_replace_search_function(njs_vm_t *vm, njs_value_t *this,
-    njs_value_t *search, njs_string_replace_t *r)
-{
-    njs_int_t    ret;
-    njs_value_t  string;
-    njs_value_t  arguments[4];
-
-    njs_set_undefined(&arguments[0]);
-
-    /* GC, args[0], args[1] */
-
-    /* Matched substring, it is the same as the args[1]. */
-    arguments[1] = *search;
-
-    /* The offset of the matched substring. */
-    njs_set_number(&arguments[2], r->part[0].size);
+    njs_set_number(&arguments[n + 1], r->index);
 
     /* The whole string being examined. */
-    arguments[3] = *this;
-
-    ret = njs_function_apply(vm, r->function, arguments, 4, &r->retval);
+    arguments[n + 2] = *this;
 
+    ret = njs_function_apply(vm, r->function, arguments, n + 3, &r->retval);
     if (njs_slow_path(ret != NJS_OK)) {
         return ret;
     }
 
-    if (!njs_is_primitive(&r->retval)) {
+    if (!njs_is_string(&r->retval)) {
         ret = njs_value_to_string(vm, &r->retval, &r->retval);
-        if (ret != NJS_OK) {
+        if (njs_slow_path(ret != NJS_OK)) {
             return ret;
         }
     }
 
-    ret = njs_primitive_value_to_string(vm, &string, &r->retval);
-    if (njs_slow_path(ret != NJS_OK)) {
-        njs_type_error(vm, "cannot convert primitive value to string: %s",
-                       njs_type_string(r->retval.type));
+    njs_string_replace_value(r, &r->retval);
 
-        return NJS_ERROR;
-    }
-
-    njs_string_replacement_copy(&r->part[1], &string);
-
-    return njs_string_replace_join(vm, r);
+    return NJS_OK;
 }
 
 
@@ -3934,12 +4025,15 @@ njs_string_replace_parse(njs_vm_t *vm, njs_string_replace_t *r, u_char *p,
 {
     u_char              c;
     uint32_t            type;
+    njs_arr_t           subst;
+    njs_uint_t          i;
     njs_string_subst_t  *s;
 
-    r->substitutions = njs_arr_create(vm->mem_pool, 4,
-                                      sizeof(njs_string_subst_t));
-
-    if (njs_slow_path(r->substitutions == NULL)) {
+    if (njs_slow_path(njs_arr_init(vm->mem_pool, &subst, NULL, 4,
+                                   sizeof(njs_string_subst_t))
+                      == NULL))
+    {
+        njs_memory_error(vm);
         return NJS_ERROR;
     }
 
@@ -3952,9 +4046,9 @@ njs_string_replace_parse(njs_vm_t *vm, njs_string_replace_t *r, u_char *p,
 copy:
 
     if (s == NULL) {
-        s = njs_arr_add(r->substitutions);
+        s = njs_arr_add(&subst);
         if (njs_slow_path(s == NULL)) {
-            return NJS_ERROR;
+            goto memory_error;
         }
 
         s->type = NJS_SUBST_COPY;
@@ -4016,244 +4110,128 @@ skip:
             goto copy;
         }
 
-        s = njs_arr_add(r->substitutions);
+        s = njs_arr_add(&subst);
         if (njs_slow_path(s == NULL)) {
-            return NJS_ERROR;
+            goto memory_error;
         }
 
         s->type = type;
         s = NULL;
     }
 
-    return NJS_OK;
-}
+    s = subst.start;
 
-
-static njs_int_t
-njs_string_replace_substitute(njs_vm_t *vm, njs_string_replace_t *r,
-    int *captures)
-{
-    int                        *capture;
-    uint32_t                   i, n, last;
-    const u_char               *end;
-    njs_string_subst_t         *s;
-    njs_string_replace_part_t  *part, *subject;
-
-    capture = NULL;
-
-    last = r->substitutions->items;
-    end = r->part[0].start + r->part[0].size;
-
-    part = njs_arr_add_multiple(&r->parts, last + 1);
-    if (njs_slow_path(part == NULL)) {
-        return NJS_ERROR;
+    for (i = 0; i < subst.items; i++) {
+        if (s[i].type == NJS_SUBST_COPY) {
+            s[i].length = njs_utf8_length(s[i].start, s[i].size);
+        }
     }
 
-    r->part = &part[-1];
+    r->subst = subst.start;
+    r->nsubst = subst.items;
 
-    part[last].start = r->part[0].start + captures[1];
+    return NJS_OK;
 
-    if (captures[1] == 0) {
+memory_error:
 
-        /* Empty match. */
+    njs_arr_destroy(&subst);
 
-        if (r->part[0].start < end) {
-            captures[1] = njs_utf8_next(r->part[0].start, end)
-                          - r->part[0].start;
-            part[last].start = r->part[0].start + captures[1];
+    njs_memory_error(vm);
 
-        } else {
-            /* To exit the loop. */
-            part[last].start = r->part[0].start + 1;
-        }
-    }
+    return NJS_ERROR;
+}
 
-    part[last].size = r->part[0].size - captures[1];
-    njs_set_invalid(&part[last].value);
 
-    r->part[0].size = captures[0];
+static void
+njs_string_replace_substitute(njs_string_replace_t *r, const u_char *base,
+    int *captures)
+{
+    uint32_t            n;
+    njs_uint_t          i;
+    njs_string_subst_t  *s;
 
-    s = r->substitutions->start;
+    s = r->subst;
 
-    for (i = 0; i < last; i++) {
+    for (i = 0; i < r->nsubst; i++) {
         n = s[i].type;
 
         switch (n) {
 
         /* Literal text, "$$", and out of range "$n" substitutions. */
         case NJS_SUBST_COPY:
-            part->start = s[i].start;
-            part->size = s[i].size;
+            njs_string_replace_append(r, s[i].start, s[i].size, s[i].length);
             break;
 
         /* "$`" substitution. */
         case NJS_SUBST_PRECEDING:
-            subject = r->parts.start;
-            part->start = subject->start;
-            part->size = (r->part[0].start - subject->start) + r->part[0].size;
+            njs_string_replace_subject(r, r->start,
+                                       base + captures[0] - r->start);
             break;
 
         /* "$'" substitution. */
         case NJS_SUBST_FOLLOWING:
-            part->start = r->part[last + 1].start;
-            part->size = r->part[last + 1].size;
+            njs_string_replace_subject(r, base + captures[1],
+                                       r->end - base - captures[1]);
             break;
 
-        /*
-         * "$n" and "$&" substitutions.
-         */
+        /* "$n" and "$&" substitutions, unmatched groups are empty. */
         default:
-            if (captures[n] == captures[n + 1]) {
-
-                /* Empty match. */
-
-                if (n > 0 && captures[n - 1] == captures[n]) {
-
-                    /*
-                     * Consecutive empty matches as in
-                     * 'ab'.replace(/(z*)(h*)/g, 'x')
-                     */
-
-                    part->size = 0;
-                    break;
-                }
-
-                capture = &captures[n];
-                continue;
+            if (captures[n] >= 0) {
+                njs_string_replace_subject(r, base + captures[n],
+                                           captures[n + 1] - captures[n]);
             }
 
-            if (capture != NULL) {
-
-                /*
-                 * Inserting a single character after a series of
-                 * (possibly several) empty matches.
-                 */
-
-                if (part->start < end) {
-                    part->start = r->part[0].start + *capture;
-                    part->size = njs_utf8_next(part->start, end) - part->start;
-
-                } else {
-                    part->size = 0;
-                }
-
-                capture = NULL;
-                break;
-            }
-
-            part->start = r->part[0].start + captures[n];
-            part->size = captures[n + 1] - captures[n];
             break;
         }
-
-        njs_set_invalid(&part->value);
-        part++;
     }
+}
 
-    if (capture != NULL) {
-        part->start = r->part[0].start + *capture;
 
-        if (part->start < end) {
-            part->size = njs_utf8_next(part->start, end) - part->start;
+static void
+njs_string_replace_value(njs_string_replace_t *r, const njs_value_t *value)
+{
+    ssize_t            length;
+    njs_string_prop_t  string;
 
-        } else {
-            part->size = 0;
-        }
+    (void) njs_string_prop(&string, value);
 
-        njs_set_invalid(&part->value);
-        part++;
-    }
+    length = string.length;
 
-    r->part = part;
+    if (length == 0 && string.size != 0) {
+        length = njs_utf8_length(string.start, string.size);
+    }
 
-    return NJS_OK;
+    njs_string_replace_append(r, string.start, string.size, length);
 }
 
 
 static njs_int_t
 njs_string_replace_join(njs_vm_t *vm, njs_string_replace_t *r)
 {
-    u_char                     *p, *string;
-    size_t                     size, length, mask;
-    ssize_t                    len;
-    njs_uint_t                 i, n;
-    njs_string_replace_part_t  *part;
-
-    size = 0;
-    length = 0;
-    mask = -1;
-
-    part = r->parts.start;
-    n = r->parts.items;
-
-    for (i = 0; i < n; i++) {
-        if (part[i].size == 0) {
-            continue;
-        }
-
-        size += part[i].size;
-
-        if (part[i].start == NULL) {
-            part[i].start = part[i].value.short_string.start;
-        }
-
-        len = njs_utf8_length(part[i].start, part[i].size);
-
-        if (len >= 0) {
-            length += len;
-
-        } else {
-            mask = 0;
-        }
-    }
-
-    length &= mask;
+    u_char  *p;
+    size_t  size;
 
-    string = njs_string_alloc(vm, &vm->retval, size, length);
-    if (njs_slow_path(string == NULL)) {
+    if (njs_slow_path(r->chain.error)) {
+        njs_memory_error(vm);
         return NJS_ERROR;
     }
 
-    p = string;
+    size = njs_chb_size(&r->chain);
 
-    for (i = 0; i < n; i++) {
-        size = part[i].size;
+    /* A byte string if any part is not valid UTF-8. */
 
-        if (size != 0) {
-            p = njs_cpymem(p, part[i].start, size);
-        }
-
-        /* GC: release valid values. */
+    p = njs_string_alloc(vm, &vm->retval, size,
+                         (r->length >= 0) ? (size_t) r->length : 0);
+    if (njs_slow_path(p == NULL)) {
+        return NJS_ERROR;
     }
 
-    njs_arr_destroy(&r->parts);
+    njs_chb_join_to(&r->chain, p);
 
     return NJS_OK;
 }
 
 
-static void
-njs_string_replacement_copy(njs_string_replace_part_t *string,
-    const njs_value_t *value)
-{
-    size_t  size;
-
-    string->value = *value;
-
-    size = value->short_string.size;
-
-    if (size != NJS_STRING_LONG) {
-        string->start = NULL;
-
-    } else {
-        string->start = value->long_string.data->start;
-        size = value->long_string.size;
-    }
-
-    string->size = size;
-}
-
-
 double
 njs_string_to_number(const njs_value_t *value, njs_bool_t parse_float)
 {
@@ -4805,60 +4783,64 @@ njs_string_encode_uri_component(njs_vm_t *vm, njs_value_t *args,
 }
 
 
+/*
+ * The encoder looks for the first byte to escape with the vector
+ * classification and returns the source if there is none.  Otherwise
+ * the number of escapes is counted with the same classification, as
+ * the worst case allocation would triple the size of long strings in
+ * the memory pool, and runs of unreserved bytes are copied at once.
+ */
+
 static njs_int_t
 njs_string_encode(njs_vm_t *vm, njs_value_t *value, const uint32_t *escape)
 {
-    u_char               byte, *src, *dst;
-    size_t               n, size;
+    u_char               byte, *dst;
+    size_t               size;
     njs_str_t            string;
+    const u_char         *p, *run, *end;
     static const u_char  hex[16] = "0123456789ABCDEF";
 
-    njs_prefetch(escape);
-
     njs_string_get(value, &string);
 
-    src = string.start;
-    n = 0;
-
-    for (size = string.length; size != 0; size--) {
-        byte = *src++;
+    end = string.start + string.length;
 
-        if ((escape[byte >> 5] & ((uint32_t) 1 << (byte & 0x1f))) != 0) {
-            n += 2;
-        }
-    }
+    p = njs_str_escape_find(string.start, end, escape);
 
-    if (n == 0) {
+    if (p == end) {
         /* GC: retain src. */
         vm->retval = *value;
         return NJS_OK;
     }
 
-    size = string.length + n;
+    size = string.length + njs_str_escape_count(p, end, escape) * 2;
 
     dst = njs_string_alloc(vm, &vm->retval, size, size);
     if (njs_slow_path(dst == NULL)) {
         return NJS_ERROR;
     }
 
-    size = string.length;
-    src = string.start;
+    run = string.start;
 
-    do {
-        byte = *src++;
+    for ( ;; ) {
+        dst = njs_cpymem(dst, run, p - run);
+
+        if (p == end) {
+            break;
+        }
+
+        do {
+            byte = *p++;
 
-        if ((escape[byte >> 5] & ((uint32_t) 1 << (byte & 0x1f))) != 0) {
             *dst++ = '%';
             *dst++ = hex[byte >> 4];
             *dst++ = hex[byte & 0xf];
 
-        } else {
-            *dst++ = byte;
-        }
-
-        size--;
+        } while (p < end
+                 && (escape[*p >> 5] & ((uint32_t) 1 << (*p & 0x1f))) != 0);
 
-    } while (size != 0);
+        run = p;
+        p = njs_str_escape_find(p, end, escape);
+    }
 
     return NJS_OK;
 }
@@ -4960,15 +4942,24 @@ njs_string_decode_uri_component(njs_vm_t *vm, njs_value_t *args,
 }
 
 
+/*
+ * The decoder makes a single pass: the result is not longer than the source,
+ * so it is allocated with the source size and truncated afterwards.  Runs
+ * between escapes are found with memchr() and copied at once.
+ */
+
 static njs_int_t
 njs_string_decode(njs_vm_t *vm, njs_value_t *value, const uint32_t *reserve)
 {
     int8_t               d0, d1;
-    u_char               byte, *start, *src, *dst;
-    size_t               n;
-    ssize_t              size, length;
-    njs_str_t            string;
+    u_char               byte, *start, *dst;
+    size_t               size;
+    ssize_t              length;
+    njs_int_t            ret;
     njs_bool_t           utf8;
+    njs_string_t         *data;
+    const u_char         *p, *run, *end;
+    njs_string_prop_t    string;
 
     static const int8_t  hex[256]
         njs_aligned(32) =
@@ -4994,94 +4985,102 @@ njs_string_decode(njs_vm_t *vm, njs_value_t *value, const uint32_t *reserve)
     njs_prefetch(&hex['0']);
     njs_prefetch(reserve);
 
-    njs_string_get(value, &string);
-
-    src = string.start;
-    n = 0;
-
-    for (size = string.length; size != 0; size--) {
-        byte = *src++;
-
-        if (byte == '%') {
-            size -= 2;
+    (void) njs_string_prop(&string, value);
 
-            if (size <= 0) {
-                goto uri_error;
-            }
-
-            d0 = hex[*src++];
-            if (d0 < 0) {
-                goto uri_error;
-            }
-
-            d1 = hex[*src++];
-            if (d1 < 0) {
-                goto uri_error;
-            }
-
-            byte = (d0 << 4) + d1;
+    end = string.start + string.size;
 
-            if ((reserve[byte >> 5] & ((uint32_t) 1 << (byte & 0x1f))) == 0) {
-                n += 2;
-            }
-        }
-    }
+    p = memchr(string.start, '%', string.size);
 
-    if (n == 0) {
+    if (p == NULL) {
         /* GC: retain src. */
         vm->retval = *value;
         return NJS_OK;
     }
 
-    n = string.length - n;
-
-    start = njs_string_alloc(vm, &vm->retval, n, n);
+    start = njs_string_alloc(vm, &vm->retval, string.size, string.size);
     if (njs_slow_path(start == NULL)) {
         return NJS_ERROR;
     }
 
-    utf8 = 0;
-    dst = start;
-    size = string.length;
-    src = string.start;
+    utf8 = (string.length != string.size);
+    dst = njs_cpymem(start, string.start, p - string.start);
 
-    do {
-        byte = *src++;
+    for ( ;; ) {
+        if (end - p < 3) {
+            goto uri_error;
+        }
 
-        if (byte == '%') {
-            size -= 2;
+        d0 = hex[p[1]];
+        d1 = hex[p[2]];
 
-            d0 = hex[*src++];
-            d1 = hex[*src++];
-            byte = (d0 << 4) + d1;
+        if ((d0 | d1) < 0) {
+            goto uri_error;
+        }
+
+        byte = (d0 << 4) + d1;
 
+        if ((reserve[byte >> 5] & ((uint32_t) 1 << (byte & 0x1f))) != 0) {
+            dst = njs_cpymem(dst, p, 3);
+
+        } else {
             utf8 |= (byte >= 0x80);
+            *dst++ = byte;
+        }
 
-            if ((reserve[byte >> 5] & ((uint32_t) 1 << (byte & 0x1f))) != 0) {
-                *dst++ = '%';
-                *dst++ = src[-2];
-                byte = src[-1];
-            }
+        run = p + 3;
+
+        p = memchr(run, '%', end - run);
+
+        if (p == NULL) {
+            dst = njs_cpymem(dst, run, end - run);
+            break;
         }
 
-        *dst++ = byte;
-        size--;
+        dst = njs_cpymem(dst, run, p - run);
+    }
 
-    } while (size != 0);
+    size = dst - start;
+    length = size;
 
     if (utf8) {
-        length = njs_utf8_length(start, n);
+        length = njs_utf8_length(start, size);
 
         if (length < 0) {
             length = 0;
         }
+    }
 
-        if (vm->retval.short_string.size != NJS_STRING_LONG) {
-            vm->retval.short_string.length = length;
+    if ((size_t) length != size && length > NJS_STRING_MAP_STRIDE) {
+        /* The offset map does not fit into the allocated string. */
 
-        } else {
-            vm->retval.long_string.data->length = length;
-        }
+        data = vm->retval.long_string.data;
+
+        ret = njs_string_new(vm, &vm->retval, start, size, length);
+
+        njs_mp_free(vm->mem_pool, data);
+
+        return ret;
+    }
+
+    data = NULL;
+
+    if (vm->retval.short_string.size == NJS_STRING_LONG
+        && size <= NJS_STRING_SHORT)
+    {
+        data = vm->retval.long_string.data;
+    }
+
+    njs_string_truncate(&vm->retval, size);
+
+    if (data != NULL) {
+        njs_mp_free(vm->mem_pool, data);
+    }
+
+    if (vm->retval.short_string.size != NJS_STRING_LONG) {
+        vm->retval.short_string.length = length;
+
+    } else {
+        vm->retval.long_string.data->length = length;
     }
 
     return NJS_OK;
@@ -38,10 +38,19 @@
  */
 #define NJS_STRING_MAP_STRIDE  32
 
-#define njs_string_map_offset(size)  njs_align_size((size), sizeof(uint32_t))
+/*
+ * Parts of long strings which are not shorter than NJS_STRING_VIEW_MIN
+ * bytes reference the bytes of the original string instead of a copy.
+ */
+#define NJS_STRING_VIEW_MIN  64
+
+#define njs_string_map_offset(size)                                           \
+    (njs_align_size((size), sizeof(uint32_t)) + 2 * sizeof(uint32_t))
 
-#define njs_string_map_start(p)                                               \
-    ((uint32_t *) njs_align_ptr((p), sizeof(uint32_t)))
+#define njs_string_map_start(start, size)                                     \
+    ((uint32_t *) ((start) + njs_string_map_offset(size)))
+
+#define njs_string_map_cursor(map)  ((map) - 2)
 
 #define njs_string_map_size(length)                                           \
     (((length - 1) / NJS_STRING_MAP_STRIDE) * sizeof(uint32_t))
@@ -62,6 +71,12 @@
  * byte string just to be concatenated or to match regular expressions the
  * offset map is not required.
  *
+ * The map is preceded by a cursor of two uint32_t which keeps the last
+ * position found by njs_string_offset(): the character index and the byte
+ * offset.  So sequential access to characters walks only over the characters
+ * between the cursor and the requested position.  The map and the cursor
+ * are located relative to the string start.
+ *
  * The map is not allocated:
  * 1) if string length is zero hence string is a byte string;
  * 2) if string size and length are equal so the string contains only
@@ -144,6 +159,9 @@ njs_string_length(njs_value_t *string)
 
 njs_int_t njs_string_set(njs_vm_t *vm, njs_value_t *value, const u_char *start,
     uint32_t size);
+njs_int_t njs_string_view(njs_vm_t *vm, njs_value_t *dst,
+    const njs_value_t *src, const u_char *start, uint32_t size,
+    uint32_t length);
 u_char *njs_string_alloc(njs_vm_t *vm, njs_value_t *value, uint64_t size,
     uint64_t length);
 njs_int_t njs_string_new(njs_vm_t *vm, njs_value_t *value, const u_char *start,
@@ -169,7 +187,8 @@ njs_int_t njs_string_cmp(const njs_value_t *val1, const njs_value_t *val2);
 void njs_string_slice_string_prop(njs_string_prop_t *dst,
     const njs_string_prop_t *string, const njs_slice_prop_t *slice);
 njs_int_t njs_string_slice(njs_vm_t *vm, njs_value_t *dst,
-    const njs_string_prop_t *string, const njs_slice_prop_t *slice);
+    const njs_value_t *src, const njs_string_prop_t *string,
+    const njs_slice_prop_t *slice);
 const u_char *njs_string_offset(const u_char *start, const u_char *end,
     size_t index);
 uint32_t njs_string_index(njs_string_prop_t *string, uint32_t offset);
@@ -0,0 +1,377 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+
+#include <njs_main.h>
+
+
+/*
+ * Nodes of the chain grow with the builder, so a string assembled
+ * from many small pieces occupies a logarithmic number of nodes.
+ */
+
+#define NJS_STRING_BUILDER_NODE_MAX  (64 * 1024)
+
+
+typedef struct {
+    njs_chb_t           chain;
+
+    uint64_t            size;
+    uint64_t            length;
+
+    /* The result is a byte string. */
+    njs_bool_t          bytes;
+} njs_string_builder_t;
+
+
+static njs_string_builder_t *njs_string_builder(const njs_value_t *value);
+static njs_int_t njs_string_builder_append(njs_vm_t *vm,
+    njs_string_builder_t *sb, const u_char *start, size_t size);
+
+
+static njs_int_t
+njs_string_builder_create(njs_vm_t *vm, njs_value_t *args, njs_uint_t nargs,
+    njs_index_t unused)
+{
+    njs_object_value_t    *ov;
+    njs_string_builder_t  *sb;
+
+    ov = njs_mp_alloc(vm->mem_pool, sizeof(njs_object_value_t));
+    if (njs_slow_path(ov == NULL)) {
+        goto memory_error;
+    }
+
+    sb = njs_mp_alloc(vm->mem_pool, sizeof(njs_string_builder_t));
+    if (njs_slow_path(sb == NULL)) {
+        goto memory_error;
+    }
+
+    njs_chb_init(&sb->chain, vm->mem_pool);
+
+    sb->size = 0;
+    sb->length = 0;
+    sb->bytes = 0;
+
+    njs_lvlhsh_init(&ov->object.hash);
+    njs_lvlhsh_init(&ov->object.shared_hash);
+    ov->object.type = NJS_OBJECT_VALUE;
+    ov->object.shared = 0;
+    ov->object.extensible = 1;
+    ov->object.__proto__ =
+                     &vm->prototypes[NJS_OBJ_TYPE_STRING_BUILDER].object;
+
+    njs_set_data(&ov->value, sb);
+    ov->value.data.magic16 = NJS_OBJ_TYPE_STRING_BUILDER;
+
+    njs_set_object_value(&vm->retval, ov);
+
+    return NJS_OK;
+
+memory_error:
+
+    njs_memory_error(vm);
+
+    return NJS_ERROR;
+}
+
+
+static njs_string_builder_t *
+njs_string_builder(const njs_value_t *value)
+{
+    const njs_value_t  *data;
+
+    if (njs_is_object_value(value)) {
+        data = njs_object_value(value);
+
+        if (njs_is_data(data)
+            && data->data.magic16 == NJS_OBJ_TYPE_STRING_BUILDER)
+        {
+            return data->data.u.data;
+        }
+    }
+
+    return NULL;
+}
+
+
+njs_chb_t *
+njs_string_builder_chain(const njs_value_t *value)
+{
+    njs_string_builder_t  *sb;
+
+    sb = njs_string_builder(value);
+
+    return (sb != NULL) ? &sb->chain : NULL;
+}
+
+
+static njs_int_t
+njs_string_builder_append(njs_vm_t *vm, njs_string_builder_t *sb,
+    const u_char *start, size_t size)
+{
+    u_char          *p;
+    size_t          reserve;
+    njs_chb_node_t  *n;
+
+    if (size == 0) {
+        return NJS_OK;
+    }
+
+    reserve = size;
+
+    n = sb->chain.last;
+
+    if (n == NULL || njs_chb_node_room(n) < size) {
+        reserve = njs_min(sb->size, NJS_STRING_BUILDER_NODE_MAX);
+        reserve = njs_max(reserve, size);
+    }
+
+    p = njs_chb_reserve(&sb->chain, reserve);
+    if (njs_slow_path(p == NULL)) {
+        njs_memory_error(vm);
+        return NJS_ERROR;
+    }
+
+    memcpy(p, start, size);
+
+    njs_chb_written(&sb->chain, size);
+
+    sb->size += size;
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_string_builder_prototype_append(njs_vm_t *vm, njs_value_t *args,
+    njs_uint_t nargs, njs_index_t unused)
+{
+    njs_int_t             ret;
+    njs_uint_t            i;
+    njs_string_prop_t     string;
+    njs_string_builder_t  *sb;
+
+    sb = njs_string_builder(&args[0]);
+    if (njs_slow_path(sb == NULL)) {
+        njs_type_error(vm, "\"this\" is not a StringBuilder");
+        return NJS_ERROR;
+    }
+
+    for (i = 1; i < nargs; i++) {
+        if (!njs_is_string(&args[i])) {
+            ret = njs_value_to_string(vm, &args[i], &args[i]);
+            if (njs_slow_path(ret != NJS_OK)) {
+                return ret;
+            }
+        }
+
+        (void) njs_string_prop(&string, &args[i]);
+
+        ret = njs_string_builder_append(vm, sb, string.start, string.size);
+        if (njs_slow_path(ret != NJS_OK)) {
+            return ret;
+        }
+
+        sb->length += string.length;
+
+        if (string.length == 0 && string.size != 0) {
+            sb->bytes = 1;
+        }
+    }
+
+    vm->retval = args[0];
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_string_builder_prototype_append_bytes(njs_vm_t *vm, njs_value_t *args,
+    njs_uint_t nargs, njs_index_t unused)
+{
+    njs_int_t             ret;
+    njs_str_t             data;
+    njs_value_t           *value;
+    njs_array_buffer_t    *buffer;
+    njs_string_builder_t  *sb;
+
+    sb = njs_string_builder(&args[0]);
+    if (njs_slow_path(sb == NULL)) {
+        njs_type_error(vm, "\"this\" is not a StringBuilder");
+        return NJS_ERROR;
+    }
+
+    value = njs_arg(args, nargs, 1);
+
+    if (njs_is_string(value)) {
+        njs_string_get(value, &data);
+
+    } else if (njs_is_array_buffer(value)) {
+        buffer = njs_array_buffer(value);
+
+        data.start = buffer->u.u8;
+        data.length = buffer->size;
+
+    } else {
+        njs_type_error(vm, "data must be a string or an ArrayBuffer");
+        return NJS_ERROR;
+    }
+
+    ret = njs_string_builder_append(vm, sb, data.start, data.length);
+    if (njs_slow_path(ret != NJS_OK)) {
+        return ret;
+    }
+
+    if (data.length != 0) {
+        sb->bytes = 1;
+    }
+
+    vm->retval = args[0];
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_string_builder_prototype_length(njs_vm_t *vm, njs_value_t *args,
+    njs_uint_t nargs, njs_index_t unused)
+{
+    njs_string_builder_t  *sb;
+
+    sb = njs_string_builder(&args[0]);
+    if (njs_slow_path(sb == NULL)) {
+        njs_type_error(vm, "\"this\" is not a StringBuilder");
+        return NJS_ERROR;
+    }
+
+    njs_set_number(&vm->retval, sb->bytes ? sb->size : sb->length);
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+njs_string_builder_prototype_to_string(njs_vm_t *vm, njs_value_t *args,
+    njs_uint_t nargs, njs_index_t unused)
+{
+    u_char                *p;
+    njs_string_builder_t  *sb;
+
+    sb = njs_string_builder(&args[0]);
+    if (njs_slow_path(sb == NULL)) {
+        njs_type_error(vm, "\"this\" is not a StringBuilder");
+        return NJS_ERROR;
+    }
+
+    p = njs_string_alloc(vm, &vm->retval, sb->size,
+                         sb->bytes ? 0 : sb->length);
+    if (njs_slow_path(p == NULL)) {
+        return NJS_ERROR;
+    }
+
+    njs_chb_join_to(&sb->chain, p);
+
+    return NJS_OK;
+}
+
+
+static const njs_object_prop_t  njs_string_builder_prototype_properties[] =
+{
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_wellknown_symbol(NJS_SYMBOL_TO_STRING_TAG),
+        .value = njs_string("StringBuilder"),
+        .configurable = 1,
+    },
+
+    {
+        .type = NJS_PROPERTY_HANDLER,
+        .name = njs_string("constructor"),
+        .value = njs_prop_handler(njs_object_prototype_create_constructor),
+        .writable = 1,
+        .configurable = 1,
+    },
+
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("append"),
+        .value = njs_native_function(njs_string_builder_prototype_append, 1),
+        .writable = 1,
+        .configurable = 1,
+    },
+
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("appendBytes"),
+        .value = njs_native_function(
+                                  njs_string_builder_prototype_append_bytes, 1),
+        .writable = 1,
+        .configurable = 1,
+    },
+
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("length"),
+        .value = njs_value(NJS_INVALID, 1, NAN),
+        .getter = njs_native_function(njs_string_builder_prototype_length, 0),
+        .setter = njs_value(NJS_UNDEFINED, 0, NAN),
+        .writable = NJS_ATTRIBUTE_UNSET,
+        .configurable = 1,
+    },
+
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("toString"),
+        .value = njs_native_function(njs_string_builder_prototype_to_string,
+                                     0),
+        .writable = 1,
+        .configurable = 1,
+    },
+};
+
+
+const njs_object_init_t  njs_string_builder_prototype_init = {
+    njs_string_builder_prototype_properties,
+    njs_nitems(njs_string_builder_prototype_properties),
+};
+
+
+static const njs_object_prop_t  njs_string_builder_constructor_properties[] =
+{
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("name"),
+        .value = njs_string("StringBuilder"),
+        .configurable = 1,
+    },
+
+    {
+        .type = NJS_PROPERTY,
+        .name = njs_string("length"),
+        .value = njs_value(NJS_NUMBER, 0, 0.0),
+        .configurable = 1,
+    },
+
+    {
+        .type = NJS_PROPERTY_HANDLER,
+        .name = njs_string("prototype"),
+        .value = njs_prop_handler(njs_object_prototype_create),
+    },
+};
+
+
+const njs_object_init_t  njs_string_builder_constructor_init = {
+    njs_string_builder_constructor_properties,
+    njs_nitems(njs_string_builder_constructor_properties),
+};
+
+
+const njs_object_type_init_t  njs_string_builder_type_init = {
+    .constructor = njs_native_ctor(njs_string_builder_create, 0, 0),
+    .constructor_props = &njs_string_builder_constructor_init,
+    .prototype_props = &njs_string_builder_prototype_init,
+    .prototype_value = { .object_value = { .value = njs_value(NJS_DATA, 0, 0.0),
+                                           .object = { .type = NJS_OBJECT } } },
+};
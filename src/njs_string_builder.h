@@ -0,0 +1,16 @@
+
+/*
+ * Copyright (C) NGINX, Inc.
+ */
+
+#ifndef _NJS_STRING_BUILDER_H_INCLUDED_
+#define _NJS_STRING_BUILDER_H_INCLUDED_
+
+
+njs_chb_t *njs_string_builder_chain(const njs_value_t *value);
+
+
+extern const njs_object_type_init_t  njs_string_builder_type_init;
+
+
+#endif /* _NJS_STRING_BUILDER_H_INCLUDED_ */
@@ -22,6 +22,37 @@
 #include <njs_unicode_lower_case.h>
 #include <njs_unicode_upper_case.h>
 
+#if (NJS_HAVE_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if (NJS_HAVE_AVX2)
+#include <immintrin.h>
+#endif
+
+#if (NJS_HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
+
+static const u_char *njs_utf8_ascii_scalar(const u_char *p,
+    const u_char *end);
+#if (NJS_HAVE_SSE2)
+static const u_char *njs_utf8_ascii_sse2(const u_char *p, const u_char *end);
+#endif
+#if (NJS_HAVE_AVX2)
+static const u_char *njs_utf8_ascii_avx2(const u_char *p, const u_char *end);
+#endif
+#if (NJS_HAVE_NEON)
+static const u_char *njs_utf8_ascii_neon(const u_char *p, const u_char *end);
+#endif
+static const u_char *njs_utf8_ascii_resolve(const u_char *p,
+    const u_char *end);
+
+
+static const u_char *(*njs_utf8_ascii_handler)(const u_char *p,
+    const u_char *end) = njs_utf8_ascii_resolve;
+
 
 u_char *
 njs_utf8_encode(u_char *p, uint32_t u)
@@ -352,22 +383,35 @@ njs_utf8_upper_case(const u_char **start, const u_char *end)
 }
 
 
+/*
+ * The length functions skip ASCII runs with njs_utf8_ascii() and decode
+ * only the non-ASCII code points, so mostly ASCII strings are processed
+ * with SIMD instructions where available.
+ */
+
 ssize_t
 njs_utf8_length(const u_char *p, size_t len)
 {
     ssize_t       length;
-    const u_char  *end;
+    const u_char  *end, *ascii;
 
     length = 0;
 
     end = p + len;
 
     while (p < end) {
-        if (njs_slow_path(njs_utf8_decode(&p, end) == 0xffffffff)) {
-            return -1;
-        }
+        ascii = njs_utf8_ascii(p, end);
 
-        length++;
+        length += ascii - p;
+        p = ascii;
+
+        while (p < end && *p >= 0x80) {
+            if (njs_slow_path(njs_utf8_decode2(&p, end) == 0xffffffff)) {
+                return -1;
+            }
+
+            length++;
+        }
     }
 
     return length;
@@ -379,7 +423,7 @@ njs_utf8_safe_length(const u_char *p, size_t len, ssize_t *out_size)
 {
     ssize_t       size, length;
     uint32_t      codepoint;
-    const u_char  *end;
+    const u_char  *end, *ascii;
 
     size = 0;
     length = 0;
@@ -387,11 +431,19 @@ njs_utf8_safe_length(const u_char *p, size_t len, ssize_t *out_size)
     end = p + len;
 
     while (p < end) {
-        codepoint = njs_utf8_safe_decode(&p, end);
+        ascii = njs_utf8_ascii(p, end);
+
+        size += ascii - p;
+        length += ascii - p;
+        p = ascii;
 
-        size += njs_utf8_size(codepoint);
+        while (p < end && *p >= 0x80) {
+            codepoint = njs_utf8_safe_decode2(&p, end);
 
-        length++;
+            size += njs_utf8_size(codepoint);
+
+            length++;
+        }
     }
 
     if (out_size != NULL) {
@@ -410,10 +462,165 @@ njs_utf8_is_valid(const u_char *p, size_t len)
     end = p + len;
 
     while (p < end) {
-        if (njs_slow_path(njs_utf8_decode(&p, end) == 0xffffffff)) {
-            return 0;
+        p = njs_utf8_ascii(p, end);
+
+        while (p < end && *p >= 0x80) {
+            if (njs_slow_path(njs_utf8_decode2(&p, end) == 0xffffffff)) {
+                return 0;
+            }
         }
     }
 
     return 1;
 }
+
+
+/*
+ * njs_utf8_ascii() returns the end of the ASCII run starting at p.
+ * The implementation is selected on the first call according to
+ * the CPU features.
+ */
+
+const u_char *
+njs_utf8_ascii(const u_char *p, const u_char *end)
+{
+    return njs_utf8_ascii_handler(p, end);
+}
+
+
+static const u_char *
+njs_utf8_ascii_resolve(const u_char *p, const u_char *end)
+{
+    njs_utf8_ascii_handler = njs_utf8_ascii_scalar;
+
+#if (NJS_HAVE_SSE2)
+    njs_utf8_ascii_handler = njs_utf8_ascii_sse2;
+#endif
+
+#if (NJS_HAVE_NEON)
+    njs_utf8_ascii_handler = njs_utf8_ascii_neon;
+#endif
+
+#if (NJS_HAVE_AVX2)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        njs_utf8_ascii_handler = njs_utf8_ascii_avx2;
+    }
+#endif
+
+    return njs_utf8_ascii_handler(p, end);
+}
+
+
+static const u_char *
+njs_utf8_ascii_scalar(const u_char *p, const u_char *end)
+{
+    uint64_t  word;
+
+    while (end - p >= 8) {
+        memcpy(&word, p, 8);
+
+        if ((word & 0x8080808080808080ULL) != 0) {
+            break;
+        }
+
+        p += 8;
+    }
+
+    while (p < end && *p < 0x80) {
+        p++;
+    }
+
+    return p;
+}
+
+
+#if (NJS_HAVE_SSE2)
+
+static const u_char *
+njs_utf8_ascii_sse2(const u_char *p, const u_char *end)
+{
+    int      mask;
+    __m128i  v;
+
+    while (end - p >= 16) {
+        v = _mm_loadu_si128((const __m128i *) p);
+        mask = _mm_movemask_epi8(v);
+
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+
+        p += 16;
+    }
+
+    return njs_utf8_ascii_scalar(p, end);
+}
+
+#endif
+
+
+#if (NJS_HAVE_AVX2)
+
+__attribute__((target("avx2")))
+static const u_char *
+njs_utf8_ascii_avx2(const u_char *p, const u_char *end)
+{
+    uint32_t  mask;
+    __m256i   v1, v2;
+
+    while (end - p >= 64) {
+        v1 = _mm256_loadu_si256((const __m256i *) p);
+        v2 = _mm256_loadu_si256((const __m256i *) (p + 32));
+
+        if (_mm256_movemask_epi8(_mm256_or_si256(v1, v2)) != 0) {
+            break;
+        }
+
+        p += 64;
+    }
+
+    while (end - p >= 32) {
+        v1 = _mm256_loadu_si256((const __m256i *) p);
+        mask = _mm256_movemask_epi8(v1);
+
+        if (mask != 0) {
+            _mm256_zeroupper();
+            return p + __builtin_ctz(mask);
+        }
+
+        p += 32;
+    }
+
+    /*
+     * The upper halves of the registers are cleared explicitly to avoid
+     * the AVX-SSE transition penalty: compilers do not insert vzeroupper
+     * at all optimization levels.
+     */
+
+    _mm256_zeroupper();
+
+    return njs_utf8_ascii_sse2(p, end);
+}
+
+#endif
+
+
+#if (NJS_HAVE_NEON)
+
+static const u_char *
+njs_utf8_ascii_neon(const u_char *p, const u_char *end)
+{
+    while (end - p >= 16) {
+        if (vmaxvq_u8(vld1q_u8(p)) >= 0x80) {
+            break;
+        }
+
+        p += 16;
+    }
+
+    return njs_utf8_ascii_scalar(p, end);
+}
+
+#endif
@@ -35,6 +35,7 @@ NJS_EXPORT ssize_t njs_utf8_length(const u_char *p, size_t len);
 NJS_EXPORT ssize_t njs_utf8_safe_length(const u_char *p, size_t len,
     ssize_t *out_size);
 NJS_EXPORT njs_bool_t njs_utf8_is_valid(const u_char *p, size_t len);
+NJS_EXPORT const u_char *njs_utf8_ascii(const u_char *p, const u_char *end);
 
 
 /*
@@ -789,7 +789,7 @@ njs_string_property_query(njs_vm_t *vm, njs_property_query_t *pq,
          * A single codepoint string fits in retval
          * so the function cannot fail.
          */
-        (void) njs_string_slice(vm, &prop->value, &string, &slice);
+        (void) njs_string_slice(vm, &prop->value, object, &string, &slice);
 
         prop->type = NJS_PROPERTY;
         prop->writable = 0;
@@ -1117,6 +1117,8 @@ njs_value_property_set(njs_vm_t *vm, njs_value_t *value, njs_value_t *key,
             prop->configurable = 1;
             prop->writable = 1;
 
+            njs_object_enum_cache_invalidate(vm, njs_object(value));
+
             goto found;
         }
 
@@ -1150,6 +1152,8 @@ njs_value_property_set(njs_vm_t *vm, njs_value_t *value, njs_value_t *key,
         return NJS_ERROR;
     }
 
+    njs_object_enum_cache_invalidate(vm, njs_object(value));
+
 found:
 
     prop->value = *setval;
@@ -1220,6 +1224,8 @@ njs_value_property_delete(njs_vm_t *vm, njs_value_t *value, njs_value_t *key,
     prop->type = NJS_WHITEOUT;
     njs_set_invalid(&prop->value);
 
+    njs_object_enum_cache_invalidate(vm, njs_object(value));
+
     return NJS_OK;
 }
 
@@ -85,6 +85,7 @@ typedef struct njs_regexp_s           njs_regexp_t;
 typedef struct njs_date_s             njs_date_t;
 typedef struct njs_property_next_s    njs_property_next_t;
 typedef struct njs_object_init_s      njs_object_init_t;
+typedef struct njs_object_boilerplate_s  njs_object_boilerplate_t;
 
 
 /*
@@ -117,6 +117,8 @@ njs_vm_destroy(njs_vm_t *vm)
         }
     }
 
+    njs_regexp_release(vm);
+
     njs_mp_destroy(vm->mem_pool);
 }
 
@@ -240,6 +242,11 @@ njs_vm_clone(njs_vm_t *vm, njs_external_ptr_t external)
     nvm->trace.data = nvm;
     nvm->external = external;
 
+    njs_memzero(nvm->enum_cache, sizeof(nvm->enum_cache));
+
+    nvm->regexp_cache_refs = NULL;
+    nvm->regexp_patterns = NULL;
+
     ret = njs_vm_init(nvm);
     if (njs_slow_path(ret != NJS_OK)) {
         goto fail;
@@ -902,8 +909,10 @@ njs_int_t
 njs_vm_value_string_copy(njs_vm_t *vm, njs_str_t *retval,
     njs_value_t *value, uintptr_t *next)
 {
-    uintptr_t    n;
-    njs_array_t  *array;
+    uintptr_t       n;
+    njs_chb_t       *chain;
+    njs_array_t     *array;
+    njs_chb_node_t  *node;
 
     switch (value->type) {
 
@@ -931,6 +940,27 @@ njs_vm_value_string_copy(njs_vm_t *vm, njs_str_t *retval,
 
         break;
 
+    case NJS_OBJECT_VALUE:
+        chain = njs_string_builder_chain(value);
+        if (chain == NULL) {
+            return NJS_ERROR;
+        }
+
+        /* StringBuilder chunks are returned as is without joining. */
+
+        node = (*next == 0) ? chain->nodes : ((njs_chb_node_t *) *next)->next;
+
+        if (node == NULL) {
+            return NJS_DECLINED;
+        }
+
+        *next = (uintptr_t) node;
+
+        retval->start = node->start;
+        retval->length = njs_chb_node_size(node);
+
+        return NJS_OK;
+
     default:
         return NJS_ERROR;
     }
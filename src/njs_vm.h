@@ -26,6 +26,8 @@ typedef struct njs_parser_s           njs_parser_t;
 typedef struct njs_parser_scope_s     njs_parser_scope_t;
 typedef struct njs_parser_node_s      njs_parser_node_t;
 typedef struct njs_generator_s        njs_generator_t;
+typedef struct njs_regexp_cache_s     njs_regexp_cache_t;
+typedef struct njs_regexp_cache_ref_s  njs_regexp_cache_ref_t;
 
 
 typedef struct {
@@ -93,7 +95,10 @@ typedef enum {
     NJS_OBJ_TYPE_CRYPTO_HASH,
 #define NJS_OBJ_TYPE_HIDDEN_MIN    (NJS_OBJ_TYPE_CRYPTO_HASH)
     NJS_OBJ_TYPE_CRYPTO_HMAC,
-#define NJS_OBJ_TYPE_HIDDEN_MAX    (NJS_OBJ_TYPE_CRYPTO_HMAC + 1)
+    NJS_OBJ_TYPE_STRING_BUILDER,
+    NJS_OBJ_TYPE_JSON_PARSER,
+    NJS_OBJ_TYPE_JSON_VIEW,
+#define NJS_OBJ_TYPE_HIDDEN_MAX    (NJS_OBJ_TYPE_JSON_VIEW + 1)
     NJS_OBJ_TYPE_ERROR,
     NJS_OBJ_TYPE_EVAL_ERROR,
     NJS_OBJ_TYPE_INTERNAL_ERROR,
@@ -151,6 +156,15 @@ enum njs_object_e {
       + njs_scope_offset(index)))
 
 
+#define NJS_ENUM_CACHE_SIZE       64
+
+
+typedef struct {
+    const njs_object_t        *object;
+    njs_array_t               *keys;
+} njs_enum_cache_t;
+
+
 typedef struct {
     uint32_t                  line;
     njs_str_t                 file;
@@ -210,6 +224,16 @@ struct njs_vm_s {
     njs_regex_context_t      *regex_context;
     njs_regex_match_data_t   *single_match_data;
 
+    /* The match data reused by RegExp.prototype.exec(). */
+    njs_regex_match_data_t   *match_data;
+    njs_uint_t               match_data_ncaptures;
+
+    /* The cached RegExp patterns referenced by the VM. */
+    njs_regexp_cache_ref_t   *regexp_cache_refs;
+
+    /* The RegExp patterns allocated from the VM memory pool. */
+    njs_regexp_pattern_t     *regexp_patterns;
+
     /*
      * MemoryError is statically allocated immutable Error object
      * with the InternalError prototype.
@@ -233,6 +257,9 @@ struct njs_vm_s {
      */
     uintptr_t                stash; /* njs_property_query_t * */
 
+    /* Own enumerable keys of recently enumerated objects. */
+    njs_enum_cache_t         enum_cache[NJS_ENUM_CACHE_SIZE];
+
     uint64_t                 symbol_generator;
 };
 
@@ -269,6 +296,7 @@ struct njs_vm_shared_s {
     njs_function_t           constructors[NJS_OBJ_TYPE_MAX];
 
     njs_regexp_pattern_t     *empty_regexp_pattern;
+    njs_regexp_cache_t       *regexp_cache;
 };
 
 
@@ -13,13 +13,12 @@ struct njs_property_next_s {
     njs_array_t  *array;
 };
 
-static njs_jump_off_t njs_vmcode_object(njs_vm_t *vm);
+static njs_jump_off_t njs_vmcode_object(njs_vm_t *vm, u_char *pc);
 static njs_jump_off_t njs_vmcode_array(njs_vm_t *vm, u_char *pc);
 static njs_jump_off_t njs_vmcode_function(njs_vm_t *vm, u_char *pc);
 static njs_jump_off_t njs_vmcode_arguments(njs_vm_t *vm, u_char *pc);
 static njs_jump_off_t njs_vmcode_regexp(njs_vm_t *vm, u_char *pc);
-static njs_jump_off_t njs_vmcode_template_literal(njs_vm_t *vm,
-    njs_value_t *inlvd1, njs_value_t *inlvd2);
+static njs_jump_off_t njs_vmcode_template_literal(njs_vm_t *vm, u_char *pc);
 static njs_jump_off_t njs_vmcode_object_copy(njs_vm_t *vm, njs_value_t *value,
     njs_value_t *invld);
 
@@ -69,6 +68,101 @@ static njs_jump_off_t njs_function_frame_create(njs_vm_t *vm,
 static njs_object_t *njs_function_new_object(njs_vm_t *vm,
     njs_value_t *constructor);
 
+/*
+ * Fast paths for a dense array element and an ASCII string character
+ * accessed by an integer number key.  They mirror njs_array_property_query()
+ * and njs_string_property_query() and return NJS_DECLINED for anything else,
+ * including array holes, to fall back to the generic property lookup.
+ */
+
+njs_inline njs_int_t
+njs_vmcode_property_get_index(njs_value_t *value, njs_value_t *key,
+    njs_value_t *retval)
+{
+    u_char       *p;
+    double       num;
+    uint32_t     index;
+    njs_array_t  *array;
+
+    if (njs_slow_path(!njs_is_number(key))) {
+        return NJS_DECLINED;
+    }
+
+    num = njs_number(key);
+    index = (uint32_t) num;
+
+    if (njs_slow_path(index != num)) {
+        return NJS_DECLINED;
+    }
+
+    if (njs_is_array(value)) {
+        array = njs_array(value);
+
+        if (index < array->length && njs_is_valid(&array->start[index])) {
+            *retval = array->start[index];
+            return NJS_OK;
+        }
+
+        return NJS_DECLINED;
+    }
+
+    if (njs_is_string(value)) {
+        if (value->short_string.size != NJS_STRING_LONG) {
+            if (index >= value->short_string.size
+                || value->short_string.size != value->short_string.length)
+            {
+                return NJS_DECLINED;
+            }
+
+            p = value->short_string.start;
+
+        } else {
+            if (index >= value->long_string.size
+                || value->long_string.size
+                   != value->long_string.data->length)
+            {
+                return NJS_DECLINED;
+            }
+
+            p = value->long_string.data->start;
+        }
+
+        njs_string_short_set(retval, 1, 1);
+        retval->short_string.start[0] = p[index];
+
+        return NJS_OK;
+    }
+
+    return NJS_DECLINED;
+}
+
+
+njs_inline njs_int_t
+njs_vmcode_property_set_index(njs_value_t *value, njs_value_t *key,
+    njs_value_t *setval)
+{
+    double       num;
+    uint32_t     index;
+    njs_array_t  *array;
+
+    if (njs_slow_path(!njs_is_array(value) || !njs_is_number(key))) {
+        return NJS_DECLINED;
+    }
+
+    num = njs_number(key);
+    index = (uint32_t) num;
+    array = njs_array(value);
+
+    if (njs_slow_path(index != num || index >= array->length)) {
+        return NJS_DECLINED;
+    }
+
+    array->start[index] = *setval;
+
+    return NJS_OK;
+}
+
+
 /*
  * The nJSVM is optimized for an ABIs where the first several arguments
  * are passed in registers (AMD64, ARM32/64): two pointers to the operand
@@ -91,6 +185,7 @@ njs_vmcode_interpreter(njs_vm_t *vm, u_char *pc)
     njs_value_t                  numeric1, numeric2, primitive1, primitive2;
     njs_frame_t                  *frame;
     njs_jump_off_t               ret;
+    njs_object_prop_t            *prop;
     njs_vmcode_this_t            *this;
     njs_native_frame_t           *previous;
     njs_property_next_t          *next;
@@ -99,6 +194,7 @@ njs_vmcode_interpreter(njs_vm_t *vm, u_char *pc)
     njs_vmcode_prop_set_t        *set;
     njs_vmcode_operation_t       op;
     njs_vmcode_prop_next_t       *pnext;
+    njs_vmcode_prop_slot_t       *slot;
     njs_vmcode_test_jump_t       *test_jump;
     njs_vmcode_equal_jump_t      *equal;
     njs_vmcode_try_return_t      *try_return;
@@ -166,9 +262,13 @@ next:
                 get = (njs_vmcode_prop_get_t *) pc;
                 retval = njs_vmcode_operand(vm, get->value);
 
-                ret = njs_value_property(vm, value1, value2, retval);
-                if (njs_slow_path(ret == NJS_ERROR)) {
-                    goto error;
+                ret = njs_vmcode_property_get_index(value1, value2, retval);
+
+                if (ret != NJS_OK) {
+                    ret = njs_value_property(vm, value1, value2, retval);
+                    if (njs_slow_path(ret == NJS_ERROR)) {
+                        goto error;
+                    }
                 }
 
                 pc += sizeof(njs_vmcode_prop_get_t);
@@ -468,7 +568,7 @@ next:
                 break;
 
             case NJS_VMCODE_TEMPLATE_LITERAL:
-                ret = njs_vmcode_template_literal(vm, value1, value2);
+                ret = njs_vmcode_template_literal(vm, pc);
                 break;
 
             case NJS_VMCODE_PROPERTY_IN:
@@ -560,7 +660,7 @@ next:
                 goto next;
 
             case NJS_VMCODE_OBJECT:
-                ret = njs_vmcode_object(vm);
+                ret = njs_vmcode_object(vm, pc);
                 break;
 
             case NJS_VMCODE_ARRAY:
@@ -625,9 +725,13 @@ next:
                 set = (njs_vmcode_prop_set_t *) pc;
                 retval = njs_vmcode_operand(vm, set->value);
 
-                ret = njs_value_property_set(vm, value1, value2, retval);
-                if (njs_slow_path(ret == NJS_ERROR)) {
-                    goto error;
+                ret = njs_vmcode_property_set_index(value1, value2, retval);
+
+                if (ret != NJS_OK) {
+                    ret = njs_value_property_set(vm, value1, value2, retval);
+                    if (njs_slow_path(ret == NJS_ERROR)) {
+                        goto error;
+                    }
                 }
 
                 ret = sizeof(njs_vmcode_prop_set_t);
@@ -824,6 +928,18 @@ next:
 
                 break;
 
+            case NJS_VMCODE_PROPERTY_SLOT:
+                slot = (njs_vmcode_prop_slot_t *) pc;
+                retval = njs_vmcode_operand(vm, slot->value);
+
+                prop = njs_object_boilerplate_props(njs_object(value1));
+
+                /* GC: retain. */
+                prop[slot->slot].value = *retval;
+
+                ret = sizeof(njs_vmcode_prop_slot_t);
+                break;
+
             case NJS_VMCODE_TRY_START:
                 ret = njs_vmcode_try_start(vm, value1, value2, pc);
                 if (njs_slow_path(ret == NJS_ERROR)) {
@@ -937,11 +1053,19 @@ error:
 
 
 static njs_jump_off_t
-njs_vmcode_object(njs_vm_t *vm)
+njs_vmcode_object(njs_vm_t *vm, u_char *pc)
 {
-    njs_object_t  *object;
+    njs_object_t         *object;
+    njs_vmcode_object_t  *code;
 
-    object = njs_object_alloc(vm);
+    code = (njs_vmcode_object_t *) pc;
+
+    if (code->boilerplate != NULL) {
+        object = njs_object_boilerplate_clone(vm, code->boilerplate);
+
+    } else {
+        object = njs_object_alloc(vm);
+    }
 
     if (njs_fast_path(object != NULL)) {
         njs_set_object(&vm->retval, object);
@@ -967,7 +1091,12 @@ njs_vmcode_array(njs_vm_t *vm, u_char *pc)
 
     if (njs_fast_path(array != NULL)) {
 
-        if (code->ctor) {
+        if (code->items != NULL) {
+            /* Array with constant elements, [1,,'a'], [1,2,x]. */
+            memcpy(array->start, code->items,
+                   code->length * sizeof(njs_value_t));
+
+        } else if (code->ctor) {
             /* Array of the form [,,,], [1,,]. */
             value = array->start;
             length = array->length;
@@ -1062,39 +1191,93 @@ njs_vmcode_regexp(njs_vm_t *vm, u_char *pc)
 }
 
 
+/*
+ * The parts are converted to strings into a stack buffer first,
+ * so the result is allocated once with the precomputed size and length.
+ */
+
 static njs_jump_off_t
-njs_vmcode_template_literal(njs_vm_t *vm, njs_value_t *invld1,
-    njs_value_t *retval)
+njs_vmcode_template_literal(njs_vm_t *vm, u_char *pc)
 {
-    njs_array_t     *array;
-    njs_value_t     *value;
-    njs_jump_off_t  ret;
+    u_char                         *p;
+    uint64_t                       size, length, mask;
+    njs_int_t                      ret;
+    njs_uint_t                     i, n;
+    njs_index_t                    *parts;
+    njs_value_t                    *value, *values;
+    njs_string_prop_t              string;
+    njs_vmcode_template_literal_t  *code;
+    njs_value_t                    buf[NJS_TEMPLATE_LITERAL_PARTS];
+
+    code = (njs_vmcode_template_literal_t *) pc;
+
+    n = code->nparts;
+    parts = njs_vmcode_template_literal_parts(code);
+
+    values = buf;
+
+    if (njs_slow_path(n > NJS_TEMPLATE_LITERAL_PARTS)) {
+        values = njs_mp_alloc(vm->mem_pool, n * sizeof(njs_value_t));
+        if (njs_slow_path(values == NULL)) {
+            njs_memory_error(vm);
+            return NJS_ERROR;
+        }
+    }
 
-    static const njs_function_t  concat = {
-          .native = 1,
-          .args_offset = 1,
-          .u.native = njs_string_prototype_concat
-    };
+    size = 0;
+    length = 0;
+    mask = -1;
 
-    value = njs_vmcode_operand(vm, retval);
+    for (i = 0; i < n; i++) {
+        value = njs_vmcode_operand(vm, parts[i]);
 
-    if (!njs_is_primitive(value)) {
-        array = njs_array(value);
+        if (njs_fast_path(njs_is_string(value))) {
+            values[i] = *value;
 
-        ret = njs_function_frame(vm, (njs_function_t *) &concat,
-                                 &njs_string_empty, array->start,
-                                 array->length, 0);
-        if (njs_slow_path(ret != NJS_OK)) {
-            return ret;
+        } else {
+            ret = njs_value_to_string(vm, &values[i], value);
+            if (njs_slow_path(ret != NJS_OK)) {
+                goto done;
+            }
         }
 
-        ret = njs_function_frame_invoke(vm, (njs_index_t) retval);
-        if (njs_slow_path(ret != NJS_OK)) {
-            return ret;
+        (void) njs_string_prop(&string, &values[i]);
+
+        size += string.size;
+        length += string.length;
+
+        if (string.length == 0 && string.size != 0) {
+            mask = 0;
         }
     }
 
-    return sizeof(njs_vmcode_template_literal_t);
+    ret = njs_vmcode_template_literal_size(code);
+
+    if (n == 1) {
+        /* A long string is shared as is. */
+        vm->retval = values[0];
+        goto done;
+    }
+
+    p = njs_string_alloc(vm, &vm->retval, size, length & mask);
+    if (njs_slow_path(p == NULL)) {
+        ret = NJS_ERROR;
+        goto done;
+    }
+
+    for (i = 0; i < n; i++) {
+        (void) njs_string_prop(&string, &values[i]);
+
+        p = njs_cpymem(p, string.start, string.size);
+    }
+
+done:
+
+    if (values != buf) {
+        njs_mp_free(vm->mem_pool, values);
+    }
+
+    return ret;
 }
 
 
@@ -53,6 +53,7 @@ typedef uint8_t                         njs_vmcode_operation_t;
 #define NJS_VMCODE_THIS                 VMCODE0(17)
 #define NJS_VMCODE_ARGUMENTS            VMCODE0(18)
 #define NJS_VMCODE_PROTO_INIT           VMCODE0(19)
+#define NJS_VMCODE_PROPERTY_SLOT        VMCODE0(20)
 
 #define NJS_VMCODE_TRY_START            VMCODE0(32)
 #define NJS_VMCODE_THROW                VMCODE0(33)
@@ -167,6 +168,7 @@ typedef struct {
 typedef struct {
     njs_vmcode_t               code;
     njs_index_t                retval;
+    njs_object_boilerplate_t   *boilerplate;
 } njs_vmcode_object_t;
 
 
@@ -186,16 +188,32 @@ typedef struct {
     njs_vmcode_t               code;
     njs_index_t                retval;
     uintptr_t                  length;
+    /* Constant items of the literal, holes are invalid values. */
+    njs_value_t                *items;
     uint8_t                    ctor;       /* 1 bit  */
 } njs_vmcode_array_t;
 
 
 typedef struct {
-     njs_vmcode_t              code;
-     njs_index_t               retval;
+    njs_vmcode_t               code;
+    njs_index_t                retval;
+    njs_uint_t                 nparts;
+    /* The indexes of the parts follow. */
 } njs_vmcode_template_literal_t;
 
 
+#define njs_vmcode_template_literal_parts(code)                               \
+    ((njs_index_t *) ((u_char *) (code)                                       \
+                      + sizeof(njs_vmcode_template_literal_t)))
+
+/* The number of parts converted without an allocation. */
+#define NJS_TEMPLATE_LITERAL_PARTS      16
+
+#define njs_vmcode_template_literal_size(code)                                \
+    (sizeof(njs_vmcode_template_literal_t)                                    \
+     + (code)->nparts * sizeof(njs_index_t))
+
+
 typedef struct {
     njs_vmcode_t               code;
     njs_index_t                retval;
@@ -262,6 +280,14 @@ typedef struct {
 } njs_vmcode_prop_set_t;
 
 
+typedef struct {
+    njs_vmcode_t               code;
+    njs_index_t                value;
+    njs_index_t                object;
+    uintptr_t                  slot;
+} njs_vmcode_prop_slot_t;
+
+
 typedef struct {
     njs_vmcode_t               code;
     njs_index_t                value;
@@ -149,9 +149,329 @@ main(int argc, char **argv)
     static njs_str_t while_loop = njs_str(
         "var i = 0; while (i < 100000000) { i++ }; i");
 
+    static njs_str_t  array_index = njs_str(
+        "var a = new Array(1000), i, j, s = 0;"
+        "for (i = 0; i < 1000; i++) { a[i] = i & 0xff }"
+        "for (j = 0; j < 10000; j++) {"
+        "    for (i = 0; i < 1000; i++) { s = (s + a[i]) & 0xffff }"
+        "}"
+        "s");
+
+    static njs_str_t  string_index = njs_str(
+        "var b = 'abcdefgh'.repeat(128), i, j, s = 0;"
+        "for (j = 0; j < 10000; j++) {"
+        "    for (i = 0; i < 1024; i++) { s = (s + (b[i] < 'e')) & 0xffff }"
+        "}"
+        "s");
+
+    static njs_str_t  object_index = njs_str(
+        "var o = {}, i, j, s = 0;"
+        "for (i = 0; i < 1000; i++) { o[i] = i & 0xff }"
+        "for (j = 0; j < 1000; j++) {"
+        "    for (i = 0; i < 1000; i++) { s = (s + o[i]) & 0xffff }"
+        "}"
+        "s");
+
+    static njs_str_t  object_literal = njs_str(
+        "var o, i, s = 0;"
+        "for (i = 0; i < 100000; i++) {"
+        "    o = {a: 1, b: i, c: 'abc', d: null, e: true, f: [1, 2, i]};"
+        "    s = (s + o.a + o.b + o.f[2]) & 0xffff"
+        "}"
+        "s");
+
+    static njs_str_t  object_keys = njs_str(
+        "var o = {a:1, b:2, c:3, d:4, e:5, f:6, g:7, h:8}, i, p, s = 0;"
+        "for (i = 0; i < 100000; i++) {"
+        "    for (p in o) { s += o[p] }"
+        "    s += Object.keys(o).length"
+        "}"
+        "s");
+
+    static njs_str_t  from_utf8 = njs_str(
+        "var b = 'αβγ abcdefghijklmnopqrstuvwxyz0123456789'.toUTF8()"
+        "        .repeat(65536), i, s = 0;"
+        "for (i = 0; i < 100; i++) { s += b.fromUTF8().length }"
+        "s");
+
+    static njs_str_t  string_search = njs_str(
+        "var b = 'abcdefghij'.repeat(100000) + 'needle',"
+        "    n = 'abcdefghij'.repeat(4) + 'X', i, s = 0;"
+        "for (i = 0; i < 100; i++) {"
+        "    s += b.indexOf('needle') + b.indexOf(n)"
+        "         + b.replace('needle', 'N').length"
+        "}"
+        "s");
+
+    static njs_str_t  string_slice = njs_str(
+        "var b = 'abcdefghij'.repeat(100000), i, s = 0;"
+        "for (i = 0; i < 1000; i++) {"
+        "    s += b.slice(i, -i).length + b.substring(10).length"
+        "         + b.split('a', 10)[5].length"
+        "}"
+        "s");
+
+    static njs_str_t  char_code_at = njs_str(
+        "var s = 'абвгдеёжзийклмнопрстуфхцчшщъыьэюя'.repeat(30000), i, n = 0;"
+        "for (i = s.length - 1; i >= 0; i--) {"
+        "    n += s.charCodeAt(i)"
+        "}"
+        "n");
+
+    static njs_str_t  string_case = njs_str(
+        "var h = ['Content-Type', 'X-Forwarded-For', 'Accept-Encoding',"
+        "         'User-Agent'],"
+        "    b = 'Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 '.repeat(20),"
+        "    i, n = 0;"
+        "for (i = 0; i < 100000; i++) {"
+        "    n += h[i & 3].toLowerCase().length + b.toUpperCase().length"
+        "         + ('  ' + b + '\\r\\n').trim().length"
+        "}"
+        "n");
+
+    static njs_str_t  base64_hex = njs_str(
+        "var a = [], i, n = 0;"
+        "for (i = 0; i < 1000000; i++) { a.push((i * 7 + (i >> 8)) & 255) }"
+        "var b = String.bytesFrom(a), e = b.toString('base64'),"
+        "    x = b.toString('hex');"
+        "for (i = 0; i < 100; i++) {"
+        "    n += b.toString('base64').length"
+        "         + String.bytesFrom(e, 'base64').length"
+        "         + b.toString('hex').length"
+        "         + String.bytesFrom(x, 'hex').length"
+        "}"
+        "n");
+
+    static njs_str_t  uri_codec = njs_str(
+        "var u = ['/static/js/app.min.js', '/search?q=njs string',"
+        "         '/files/документ.pdf', '/a/b/c?x=1&y=2&z=3'],"
+        "    b = 'x-request-id-0123456789abcdef'.repeat(8), i, n = 0;"
+        "for (i = 0; i < 100000; i++) {"
+        "    n += encodeURIComponent(u[i & 3]).length"
+        "         + decodeURIComponent(encodeURI(u[i & 3])).length"
+        "         + encodeURIComponent(b).length + decodeURIComponent(b).length"
+        "}"
+        "n");
+
+    static njs_str_t  string_replace = njs_str(
+        "var s = 'GET /index.html HTTP/1.1 host=example.com; '.repeat(25000),"
+        "    i, n = 0;"
+        "for (i = 0; i < 20; i++) {"
+        "    n += s.replace(/\\//g, '\\\\/').length"
+        "         + s.replace(/(\\w+)=(\\w+)/g, '$2:$1').length"
+        "         + s.replace(/HTTP/g, (m) => m.toLowerCase()).length"
+        "}"
+        "n");
+
+    static njs_str_t  string_builder = njs_str(
+        "var i, k, sb, n = 0;"
+        "for (k = 0; k < 10; k++) {"
+        "    sb = new njs.StringBuilder();"
+        "    for (i = 0; i < 100000; i++) {"
+        "        sb.append('<li>', i, '</li>')"
+        "    }"
+        "    n += sb.toString().length"
+        "}"
+        "n");
+
+    static njs_str_t  template_literal = njs_str(
+        "var i, n = 0, h = 'example.com', u = '/index.html', a = 'аб';"
+        "for (i = 0; i < 1000000; i++) {"
+        "    n += `${h}${u}?id=${i}`.length + `${a}:${i & 7}`.length"
+        "}"
+        "n");
+
+    static njs_str_t  json_api = njs_str(
+        "var i, s, n = 0, items = [];"
+        "for (i = 0; i < 5000; i++) {"
+        "    items.push({id: i, login: 'user' + i, site_admin: (i & 1) == 0,"
+        "                url: 'https://api.example.com/users/' + i,"
+        "                bio: 'Lorem ipsum dolor sit amet, elit. '.repeat(6),"
+        "                score: i / 8, tags: ['nginx', 'njs'], owner: null})"
+        "}"
+        "s = JSON.stringify({total_count: 5000, items: items});"
+        "for (i = 0; i < 20; i++) {"
+        "    n += JSON.parse(s).items.length + s.length"
+        "}"
+        "n");
+
+    static njs_str_t  json_pretty = njs_str(
+        "var i, s, n = 0, items = [];"
+        "for (i = 0; i < 5000; i++) {"
+        "    items.push({title: 'Заголовок \\\"' + i + '\\\"',"
+        "                path: 'C:\\\\njs\\\\' + i,"
+        "                body: 'line 1\\nline 2\\t\\u00e9\\u2603'.repeat(4),"
+        "                size: i * 3, meta: {draft: false, tags: []}})"
+        "}"
+        "s = JSON.stringify({items: items}, null, 4);"
+        "for (i = 0; i < 20; i++) {"
+        "    n += JSON.parse(s).items.length + s.length"
+        "}"
+        "n");
+
+    static njs_str_t  json_stringify = njs_str(
+        "var i, n = 0, items = [];"
+        "for (i = 0; i < 5000; i++) {"
+        "    items.push({id: i, login: 'user' + i, site_admin: (i & 1) == 0,"
+        "                url: 'https://api.example.com/users/' + i,"
+        "                bio: 'Lorem \\\"ipsum\\\" dolor,\\n elit. '.repeat(6),"
+        "                score: i / 8, tags: ['nginx', 'njs'], owner: null,"
+        "                name: 'Имя'})"
+        "}"
+        "for (i = 0; i < 20; i++) {"
+        "    n += JSON.stringify({total_count: 5000, items: items}).length"
+        "}"
+        "n");
+
+    static njs_str_t  json_stream = njs_str(
+        "var i, j, p, s, n = 0, items = [];"
+        "for (i = 0; i < 5000; i++) {"
+        "    items.push(JSON.stringify({id: i, login: 'user' + i,"
+        "                site_admin: (i & 1) == 0,"
+        "                url: 'https://api.example.com/users/' + i,"
+        "                bio: 'Lorem ipsum dolor sit amet, elit. '.repeat(6),"
+        "                score: i / 8, tags: ['nginx', 'njs'], owner: null}))"
+        "}"
+        "s = items.join('\\n');"
+        "for (i = 0; i < 20; i++) {"
+        "    p = JSON.createParser();"
+        "    for (j = 0; j < s.length; j += 16384) {"
+        "        n += p.write(s.slice(j, j + 16384)).length"
+        "    }"
+        "    n += p.end().length"
+        "}"
+        "n");
+
+    static njs_str_t  json_records = njs_str(
+        "var i, s, n = 0, items = [];"
+        "for (i = 0; i < 50000; i++) {"
+        "    items.push({id: i, name: 'n' + i, active: true,"
+        "                created_at_timestamp: i * 1000,"
+        "                repository_full_name: 'org/repo', score: 1.5,"
+        "                html_url: 'u', tags: []})"
+        "}"
+        "s = JSON.stringify(items);"
+        "for (i = 0; i < 10; i++) {"
+        "    n += JSON.parse(s).length"
+        "}"
+        "n");
+
+    static njs_str_t  json_view = njs_str(
+        "var i, s, v, n = 0, items = [];"
+        "for (i = 0; i < 5000; i++) {"
+        "    items.push({id: i, login: 'user' + i, site_admin: (i & 1) == 0,"
+        "                url: 'https://api.example.com/users/' + i,"
+        "                bio: 'Lorem ipsum dolor sit amet, elit. '.repeat(6),"
+        "                score: i / 8, tags: ['nginx', 'njs'], owner: null})"
+        "}"
+        "s = JSON.stringify({items: items, total_count: 5000});"
+        "for (i = 0; i < 20; i++) {"
+        "    v = njs.jsonView(s);"
+        "    n += v.get('total_count') + v.get('items', 4999, 'id')"
+        "}"
+        "n");
+
+    static njs_str_t  regexp_routes = njs_str(
+        "var routes = ['^/api/v[0-9]+/users/([0-9]+)$', '^/static/.+\\.css$',"
+        "              '^/(en|de|fr)/docs/', '\\.(png|jpe?g|gif)$',"
+        "              '^/health$', '^/admin(/.*)?$'];"
+        "routes.map(r => new RegExp(r, 'i'))"
+        "      .filter(re => re.test('/api/v2/users/42')).length");
+
+    static njs_str_t  regexp_test = njs_str(
+        "var i, j, n = 0, lines = [];"
+        "for (i = 0; i < 10000; i++) {"
+        "    lines.push((i % 3 ? 'GET' : 'POST') + ' /api/v' + (i % 4)"
+        "               + '/users/' + i + (i % 5 ? ' HTTP/1.1' : ' HTTP/2.0'))"
+        "}"
+        "var re = /^(GET|POST) \\/api\\/v[0-9]+\\/users\\/[0-9]+ HTTP\\/1\\.[01]$/;"
+        "for (j = 0; j < 50; j++) {"
+        "    for (i = 0; i < lines.length; i++) {"
+        "        n += re.test(lines[i])"
+        "    }"
+        "}"
+        "n");
+
+    static njs_str_t  regexp_exec = njs_str(
+        "var i, m, n = 0, s = '';"
+        "for (i = 0; i < 2000; i++) { s += 'key' + i + '=' + (i * 7) + '; ' }"
+        "var re = /(\\w+)=(\\d+)/g;"
+        "for (i = 0; i < 20; i++) {"
+        "    re.lastIndex = 0;"
+        "    while ((m = re.exec(s)) !== null) { n += m[2].length }"
+        "}"
+        "n");
+
+    static njs_str_t  regexp_replace = njs_str(
+        "var i, n = 0;"
+        "var s = 'Lorem ipsum dolor sit amet, consectetur adipiscing elit. '"
+        "        .repeat(20000);"
+        "for (i = 0; i < 10; i++) {"
+        "    n += s.replace(/[aeiou]+/g, '_').length"
+        "}"
+        "n");
+
+    static njs_str_t  regexp_literal = njs_str(
+        "var i, j, n = 0, lines = [];"
+        "for (i = 0; i < 10000; i++) {"
+        "    lines.push((i % 3 ? '/static/' : '/api/v1/') + 'users/' + i"
+        "               + (i % 5 ? '.json' : '.css'))"
+        "}"
+        "for (j = 0; j < 50; j++) {"
+        "    for (i = 0; i < lines.length; i++) {"
+        "        n += /^\\/api\\//.test(lines[i]) + /users/.test(lines[i])"
+        "             + /\\.css|\\.js/.test(lines[i])"
+        "    }"
+        "}"
+        "n");
+
+    static njs_str_t  regexp_match = njs_str(
+        "var i, n = 0;"
+        "var s = 'Съешь же ещё этих мягких французских булок, lorem ipsum. '"
+        "        .repeat(2000);"
+        "for (i = 0; i < 10; i++) {"
+        "    n += s.match(/[a-z]+|[а-яё]+/g).length"
+        "}"
+        "n");
+
+    static njs_str_t  regexp_compile = njs_str(
+        "var i, n = 0;"
+        "for (i = 0; i < 20000; i++) {"
+        "    n += new RegExp('^(\\\\w+)=([^;]*)' + i).test('id=1' + i)"
+        "}"
+        "n");
+
     static njs_str_t  fibo_result = njs_str("3524578");
     static njs_str_t  json_result = njs_str("123");
     static njs_str_t  loop_result = njs_str("100000000");
+    static njs_str_t  array_index_result = njs_str("9920");
+    static njs_str_t  string_index_result = njs_str("8192");
+    static njs_str_t  object_index_result = njs_str("992");
+    static njs_str_t  object_literal_result = njs_str("58368");
+    static njs_str_t  object_keys_result = njs_str("4400000");
+    static njs_str_t  from_utf8_result = njs_str("262144000");
+    static njs_str_t  string_search_result = njs_str("200000000");
+    static njs_str_t  string_slice_result = njs_str("1998000000");
+    static njs_str_t  char_code_at_result = njs_str("1077150000");
+    static njs_str_t  string_case_result = njs_str("205200000");
+    static njs_str_t  base64_hex_result = njs_str("533333600");
+    static njs_str_t  uri_codec_result = njs_str("52200000");
+    static njs_str_t  string_replace_result = njs_str("65500000");
+    static njs_str_t  string_builder_result = njs_str("13888900");
+    static njs_str_t  template_literal_result = njs_str("35888890");
+    static njs_str_t  json_api_result = njs_str("35666400");
+    static njs_str_t  json_pretty_result = njs_str("35681940");
+    static njs_str_t  json_stringify_result = njs_str("35066400");
+    static njs_str_t  json_stream_result = njs_str("100000");
+    static njs_str_t  json_records_result = njs_str("500000");
+    static njs_str_t  json_view_result = njs_str("199980");
+    static njs_str_t  regexp_routes_result = njs_str("1");
+    static njs_str_t  regexp_test_result = njs_str("400000");
+    static njs_str_t  regexp_exec_result = njs_str("168220");
+    static njs_str_t  regexp_replace_result = njs_str("11400000");
+    static njs_str_t  regexp_literal_result = njs_str("1166700");
+    static njs_str_t  regexp_match_result = njs_str("180000");
+    static njs_str_t  regexp_compile_result = njs_str("20000");
 
 
     if (argc > 1) {
@@ -188,6 +508,146 @@ main(int argc, char **argv)
         case 'u':
             return njs_unit_test_benchmark(&fibo_utf8, &fibo_result,
                                            "fibobench utf8 strings", 1);
+
+        case 'i':
+            return njs_unit_test_benchmark(&array_index, &array_index_result,
+                                           "array index 10M", 1);
+
+        case 's':
+            return njs_unit_test_benchmark(&string_index, &string_index_result,
+                                           "string index 10M", 1);
+
+        case 'o':
+            return njs_unit_test_benchmark(&object_index, &object_index_result,
+                                           "object integer key 1M", 1);
+
+        case 'l':
+            return njs_unit_test_benchmark(&object_literal,
+                                           &object_literal_result,
+                                           "object literal 100K", 10);
+
+        case 'k':
+            return njs_unit_test_benchmark(&object_keys, &object_keys_result,
+                                           "for-in and Object.keys 100K", 10);
+
+        case 'U':
+            return njs_unit_test_benchmark(&from_utf8, &from_utf8_result,
+                                           "String.fromUTF8() 2.8MB x100", 1);
+
+        case 'S':
+            return njs_unit_test_benchmark(&string_search,
+                                           &string_search_result,
+                                           "string search 1MB x100", 1);
+
+        case 'L':
+            return njs_unit_test_benchmark(&string_slice,
+                                           &string_slice_result,
+                                           "string slice 1MB x1000", 1);
+
+        case 'C':
+            return njs_unit_test_benchmark(&char_code_at,
+                                           &char_code_at_result,
+                                           "String.charCodeAt() UTF-8 1M", 1);
+
+        case 'H':
+            return njs_unit_test_benchmark(&string_case, &string_case_result,
+                                           "toLowerCase()/toUpperCase()/trim()"
+                                           " x100000", 1);
+
+        case 'B':
+            return njs_unit_test_benchmark(&base64_hex, &base64_hex_result,
+                                           "base64/hex encode/decode 1MB x100",
+                                           1);
+
+        case 'E':
+            return njs_unit_test_benchmark(&uri_codec, &uri_codec_result,
+                                           "encodeURIComponent()/"
+                                           "decodeURIComponent() x100000", 1);
+
+        case 'R':
+            return njs_unit_test_benchmark(&string_replace,
+                                           &string_replace_result,
+                                           "String.prototype.replace() 1MB x20",
+                                           1);
+
+        case 'A':
+            return njs_unit_test_benchmark(&string_builder,
+                                           &string_builder_result,
+                                           "njs.StringBuilder 1.3MB x10", 1);
+
+        case 'T':
+            return njs_unit_test_benchmark(&template_literal,
+                                           &template_literal_result,
+                                           "template literals x1000000", 1);
+
+        case 'J':
+            return njs_unit_test_benchmark(&json_api, &json_api_result,
+                                           "JSON.parse() API response 1.8MB"
+                                           " x20", 1);
+
+        case 'P':
+            return njs_unit_test_benchmark(&json_pretty, &json_pretty_result,
+                                           "JSON.parse() pretty-printed 1.8MB"
+                                           " x20", 1);
+
+        case 'G':
+            return njs_unit_test_benchmark(&json_stringify,
+                                           &json_stringify_result,
+                                           "JSON.stringify() API response 1.8MB"
+                                           " x20", 1);
+
+        case 'N':
+            return njs_unit_test_benchmark(&json_stream, &json_stream_result,
+                                           "JSON.createParser() NDJSON 1.8MB"
+                                           " x20", 1);
+
+        case 'K':
+            return njs_unit_test_benchmark(&json_records,
+                                           &json_records_result,
+                                           "JSON.parse() 50K records x10", 1);
+
+        case 'V':
+            return njs_unit_test_benchmark(&json_view, &json_view_result,
+                                           "njs.jsonView() API response 1.8MB"
+                                           " x20", 1);
+
+        case 'r':
+            return njs_unit_test_benchmark(&regexp_routes,
+                                           &regexp_routes_result,
+                                           "new RegExp() routes per clone",
+                                           100000);
+
+        case 't':
+            return njs_unit_test_benchmark(&regexp_test, &regexp_test_result,
+                                           "RegExp.prototype.test() log lines",
+                                           1);
+
+        case 'e':
+            return njs_unit_test_benchmark(&regexp_exec, &regexp_exec_result,
+                                           "RegExp.prototype.exec() global"
+                                           " 27K", 1);
+
+        case 'p':
+            return njs_unit_test_benchmark(&regexp_replace,
+                                           &regexp_replace_result,
+                                           "String.prototype.replace() regexp"
+                                           " 1.1M", 1);
+
+        case 'x':
+            return njs_unit_test_benchmark(&regexp_literal,
+                                           &regexp_literal_result,
+                                           "RegExp.prototype.test() literals",
+                                           1);
+
+        case 'm':
+            return njs_unit_test_benchmark(&regexp_match, &regexp_match_result,
+                                           "String.prototype.match() global"
+                                           " UTF-8 110K", 1);
+
+        case 'c':
+            return njs_unit_test_benchmark(&regexp_compile,
+                                           &regexp_compile_result,
+                                           "new RegExp() 20K patterns", 1);
         }
     }
 
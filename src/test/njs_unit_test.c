@@ -2616,6 +2616,33 @@ static njs_unit_test_t  njs_test[] =
                  "for (var p in o) {s += p}; s"),
       njs_str("y") },
 
+    /* Object literals. */
+
+    { njs_str("var x = 2, o = {a:1, b:x, 'c':'s', 3:null, d:x * 2, e:true};"
+              "Object.keys(o) + '|' + JSON.stringify(o)"),
+      njs_str("a,b,c,3,d,e|{\"a\":1,\"b\":2,\"c\":\"s\",\"3\":null,\"d\":4,\"e\":true}") },
+
+    { njs_str("var r = [], i;"
+              "for (i = 0; i < 3; i++) { var o = {a:0, b:i, c:{d:1}}; o.a = i; o.c.d += i;"
+              "                          r.push(JSON.stringify(o)) }"
+              "r.join()"),
+      njs_str("{\"a\":0,\"b\":0,\"c\":{\"d\":1}},"
+              "{\"a\":1,\"b\":1,\"c\":{\"d\":2}},"
+              "{\"a\":2,\"b\":2,\"c\":{\"d\":3}}") },
+
+    { njs_str("var o = {a:1, b:2, a:3}; Object.keys(o) + ':' + o.a"),
+      njs_str("a,b:3") },
+
+    { njs_str("var o = {a:1, '1':2, 1:3}; Object.keys(o) + ':' + o[1]"),
+      njs_str("a,1:3") },
+
+    { njs_str("var o = {a:1, b:2}; delete o.a; o.c = 3; o.a = 4;"
+              "Object.keys(o) + ':' + Object.getOwnPropertyDescriptor(o, 'b').writable"),
+      njs_str("a,b,c:true") },
+
+    { njs_str("var o = {a:1, b:(function() { throw 'e' })()}"),
+      njs_str("e") },
+
     { njs_str("var o = {a:1, b:2}; var arr = []; "
                  "for (var a in o) {arr.push(a)}; arr"),
       njs_str("a,b") },
@@ -2624,6 +2651,31 @@ static njs_unit_test_t  njs_test[] =
                  "for (var a in o) {arr.push(a)}; arr"),
       njs_str("b") },
 
+    { njs_str("var o = {a:1, b:2}, r = [], p;"
+              "for (p in o) { r.push(p); delete o.b; o.c = 3 }"
+              "for (p in o) { r.push(p) }"
+              "r"),
+      njs_str("a,b,a,c") },
+
+    { njs_str("function F() { this.a = 1 }; var f = new F(), r = [], p;"
+              "for (p in f) { r.push(p) }"
+              "F.prototype.b = 2;"
+              "for (p in f) { r.push(p) }"
+              "r"),
+      njs_str("a,a,b") },
+
+    { njs_str("var o = {a:1, b:2}, r = [];"
+              "r.push(Object.keys(o)); o.c = 3;"
+              "r.push(Object.keys(o)); delete o.a;"
+              "r.push(Object.keys(o)); o.a = 4;"
+              "r.push(Object.keys(o));"
+              "Object.defineProperty(o, 'b', {enumerable:false});"
+              "r.push(Object.keys(o)); Object.keys(o).push('x');"
+              "r.push(Object.keys(o));"
+              "JSON.stringify(r)"),
+      njs_str("[[\"a\",\"b\"],[\"a\",\"b\",\"c\"],[\"b\",\"c\"],"
+              "[\"a\",\"b\",\"c\"],[\"a\",\"c\"],[\"a\",\"c\"]]") },
+
     /* switch. */
 
     { njs_str("switch"),
@@ -3461,6 +3513,17 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("var o = { [0]: 1, [-0]: 2 }; o[0];"),
       njs_str("2") },
 
+    { njs_str("var o = {}; o[0] = 'a'; o[4294967295] = 'b'; o[4294967296] = 'c';"
+                 "o[1.5] = 'd'; o[-1] = 'e';"
+                 "[o['0'], o['4294967295'], o['4294967296'], o['1.5'], o['-1']]"),
+      njs_str("a,b,c,d,e") },
+
+    { njs_str("var o = {'200': 'OK', '404': 'Not Found'}; o[200] + ' ' + o[404]"),
+      njs_str("OK Not Found") },
+
+    { njs_str("var o = {}; o[1e21] = 1; Object.keys(o)"),
+      njs_str("1e+21") },
+
     { njs_str("var k = 'abc'.split('');var o = {[k[0]]: 'baz'}; o.a"),
       njs_str("baz") },
 
@@ -3755,6 +3818,29 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("var a = [ function(a) {return a + 1} ]; a[0](5)"),
       njs_str("6") },
 
+    { njs_str("var a = [1,,3]; a[1] +' '+ a[2]"),
+      njs_str("undefined 3") },
+
+    { njs_str("var a = [1, 2, 3], i, s = 0;"
+                 "for (i = 0; i < 4; i++) { a[i] = a[i] * 2; s += a[i] }; s"),
+      njs_str("NaN") },
+
+    { njs_str("var a = [1, 2]; a[1.5] = 3; a[-0] = 5; a + ' ' + a[1.5]"),
+      njs_str("5,2 3") },
+
+    { njs_str("var s = 'abc', i, r = '';"
+                 "for (i = -1; i < 4; i++) { r += s[i] + ',' }; r"),
+      njs_str("undefined,a,b,c,undefined,") },
+
+    { njs_str("var s = 'αbβ'; s[0] + s[1] + s[2] + s[3]"),
+      njs_str("αbβundefined") },
+
+    { njs_str("var s = 'abcdefghijklmnopqrstuvwxyz'; s[25] + s[0]"),
+      njs_str("za") },
+
+    { njs_str("var s = 'abc'.toBytes(); s[1]"),
+      njs_str("b") },
+
     { njs_str("var s = '', a = [5,1,2], i;"
                  "a[null] = null;"
                  "a[undefined] = 'defined';"
@@ -3882,6 +3968,15 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("var a = ['β', 'γ']; var out= a.join('α'); [out, out.length]"),
       njs_str("βαγ,3") },
 
+    { njs_str("[1,2,3].join('-').length"),
+      njs_str("5") },
+
+    { njs_str("var out = [1, 'α', 2].join('β'); [out, out.length]"),
+      njs_str("1βαβ2,5") },
+
+    { njs_str("var out = [true, 'αβ', null].join(); [out, out.length]"),
+      njs_str("true,αβ,,8") },
+
     { njs_str("var a = []; a[5] = 5; a.join()"),
       njs_str(",,,,,5") },
 
@@ -3949,6 +4044,17 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("[1,2,,3].length"),
       njs_str("4") },
 
+    { njs_str("var a = [1,,'a',null]; [a.length, 1 in a, 3 in a, a[3]]"),
+      njs_str("4,false,true,") },
+
+    { njs_str("var x = 'x', a = [x, 1, , x + 'y']; a.join('|')"),
+      njs_str("x|1||xy") },
+
+    { njs_str("var r = [], i;"
+              "for (i = 0; i < 3; i++) { var a = [0, i, 2]; a[0] = i; r.push(a) }"
+              "r.join(';')"),
+      njs_str("0,0,2;1,1,2;2,2,2") },
+
     /**/
 
     { njs_str("var n = { toString: function() { return 1 } };   [1,2][n]"),
@@ -5244,6 +5350,34 @@ static njs_unit_test_t  njs_test[] =
                  "foo`That ${person} is a ${age}`;"),
       njs_str("That  is a Mike21") },
 
+    { njs_str("var a = 1, b = 'αβ'; [`${a}/${b}`, ``, `${a}`, typeof `${a}`]"),
+      njs_str("1/αβ,,1,string") },
+
+    { njs_str("var o = {toString() { return 'O' }};"
+              "`${o}-${null}-${undefined}-${[1,2]}-${{}}`"),
+      njs_str("O-null-undefined-1,2-[object Object]") },
+
+    { njs_str("var x = 1; `${x}${x = 5}${x}`"),
+      njs_str("155") },
+
+    { njs_str("var y = 'a'; function f() { y = 'b'; return 'c' }"
+              "`${y}${f()}${y}`"),
+      njs_str("acb") },
+
+    { njs_str("var s = 'q'.repeat(100), b = 'αβ';"
+              "[`${s}` === s, `${s}${b}`.length, `${s}${b}`[101]]"),
+      njs_str("true,102,β") },
+
+    { njs_str("`a${String.bytesFrom([0xff])}b`.length"),
+      njs_str("3") },
+
+    { njs_str("`${1}${2}${3}${4}${5}${6}${7}${8}${9}${10}"
+              "${11}${12}${13}${14}${15}${16}${17}${18}${19}${20}`"),
+      njs_str("1234567891011121314151617181920") },
+
+    { njs_str("`${Symbol()}`"),
+      njs_str("TypeError: Cannot convert a Symbol value to a string") },
+
     /* Strings. */
 
     { njs_str("var a = '0123456789' + '012345';"
@@ -5760,6 +5894,52 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("'α'.repeat(32).substring(32,32)"),
       njs_str("") },
 
+    { njs_str("var s = 'abcdefghij'.repeat(20), t = s.slice(5, 105);"
+              "[t.length, t.slice(0, 3), t[99], t == s.substr(5, 100),"
+              " s.substring(105, 5) === t]"),
+      njs_str("100,fgh,e,true,true") },
+
+    { njs_str("var s = 'y'.repeat(100), t = s.slice(1);"
+              "[t.length, (t + '!').length, s.length, t.toUpperCase().slice(-3)]"),
+      njs_str("99,100,100,YYY") },
+
+    { njs_str("var s = 'α'.repeat(40) + 'a'.repeat(100);"
+              "[s.slice(20, 70).length, s.slice(35).indexOf('a'),"
+              " s.substr(10, 31) === 'α'.repeat(30) + 'a']"),
+      njs_str("50,5,true") },
+
+    { njs_str("var t = 'α'.repeat(100).slice(3, 35);"
+              "[t.length, t[31], t.slice(30), t.indexOf('α', 31)]"),
+      njs_str("32,α,αα,31") },
+
+    { njs_str("var a = 'abcdefghijklmnopqrstuvwxyz0123456789';"
+              "var p = 'ж'.repeat(32) + a + a, t = p.slice(0, 32);"
+              "[t.indexOf('', 32), t.indexOf('ж', 31), t.lastIndexOf('ж'),"
+              " p.slice(32, 50) === a.slice(0, 18)]"),
+      njs_str("32,31,31,true") },
+
+    { njs_str("var p = 'ж'.repeat(32) + 'a'.repeat(64);"
+              "var m = /(ж+)a/.exec(p), r = /ж/g;"
+              "r.lastIndex = 31; var i = r.exec(m[1]).index;"
+              "[m[1].length, m[1].indexOf('', 32), i, r.exec(m[1]), r.lastIndex,"
+              " p.slice(32) === 'a'.repeat(64)]"),
+      njs_str("32,32,31,,0,true") },
+
+    { njs_str("var b = String.bytesFrom(Array(200).fill(0x62));"
+              "[b.slice(10, 110).length, b.slice(10, 110).toString('hex').length,"
+              " b.substring(100).fromUTF8().length]"),
+      njs_str("100,200,100") },
+
+    { njs_str("var p = ('x'.repeat(70) + ',').repeat(3).split(',');"
+              "[p.length, p[0].length, p[2] === 'x'.repeat(70), p[3]]"),
+      njs_str("4,70,true,") },
+
+    { njs_str("var s = 'c'.repeat(10) + 'a'.repeat(100) + 'b'.repeat(80);"
+              "var m = /(a+)(b+)/.exec(s);"
+              "[m[1].length, m[2].length, m.index,"
+              " m[1] + m[2] === 'a'.repeat(100) + 'b'.repeat(80)]"),
+      njs_str("100,80,10,true") },
+
     { njs_str("'abcdefghijklmno'.slice(NaN, 5)"),
       njs_str("abcde") },
 
@@ -6147,6 +6327,23 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("'12345абвгдеёжзийклмнопрстуфхцчшщъыьэюя'.substring(35)"),
       njs_str("эюя") },
 
+    { njs_str("var s = 'aαбв€😀'.repeat(300), h = 0, i;"
+              "for (i = 0; i < s.length; i++) { h = (h * 31 + s.charCodeAt(i)) >>> 0 }"
+              "h"),
+      njs_str("1261078492") },
+
+    { njs_str("var s = 'aαбв€😀'.repeat(300), h = 0, i;"
+              "for (i = s.length - 1; i >= 0; i--) { h = (h * 31 + s.codePointAt(i)) >>> 0 }"
+              "h"),
+      njs_str("1292965284") },
+
+    { njs_str("var s = 'aαбв€😀'.repeat(300), h = 0, i, k;"
+              "for (i = 0; i < 2000; i++) {"
+              "    k = (i * 7919) % s.length;"
+              "    h = (h * 31 + s.charCodeAt(k) + s.charAt(k).length) >>> 0 }"
+              "[h, s.substr(1733, 5), s.indexOf('€', 1000), s.lastIndexOf('a', 1000)]"),
+      njs_str("895704160,😀aαбв,1000,996") },
+
     { njs_str("'abcdef'.substr(-5, 4).substring(3, 1).charAt(1)"),
       njs_str("d") },
 
@@ -6240,6 +6437,19 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("'abcdef'.indexOf('', 3)"),
       njs_str("3") },
 
+    { njs_str("var s = 'ж'.repeat(32); [s.indexOf('', 32), s.indexOf('', 40)]"),
+      njs_str("32,32") },
+
+    { njs_str("var s = 'ж'.repeat(64); [s.indexOf('', 64), s.indexOf('', 63)]"),
+      njs_str("64,63") },
+
+    { njs_str("var s = 'ж'.repeat(64) + 'a';"
+              "[s.indexOf('a', 64), s.indexOf('', 65)]"),
+      njs_str("64,65") },
+
+    { njs_str("['ж'.repeat(32), 'ж'.repeat(64)].map(s => s.toBytes(s.length))"),
+      njs_str(",") },
+
     { njs_str("'12345'.indexOf()"),
       njs_str("-1") },
 
@@ -6255,6 +6465,37 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("''.indexOf.call(12345, 45, '0')"),
       njs_str("3") },
 
+    { njs_str("var s = 'x'.repeat(1000) + 'abc' + 'x'.repeat(10);"
+              "[s.indexOf('abc'), s.indexOf('abc', 1000), s.indexOf('abc', 1001),"
+              " s.indexOf('xa'), s.indexOf('cx'), s.indexOf('xx', 1002)]"),
+      njs_str("1000,1000,-1,999,1002,1003") },
+
+    { njs_str("var n = 'ab'.repeat(20) + 'c';"
+              "var s = 'ab'.repeat(500) + n + 'ab';"
+              "[s.indexOf(n), s.indexOf(n, 1001), s.includes(n),"
+              " (s + n).indexOf(n + 'ab' + n)]"),
+      njs_str("1000,-1,true,1000") },
+
+    { njs_str("var s = 'я'.repeat(100) + 'abc' + 'я'.repeat(100);"
+              "[s.indexOf('abc'), s.indexOf('яabc'), s.indexOf('cя', 103),"
+              " s.indexOf('я'.repeat(50), 90), s.includes('яab', 100)]"),
+      njs_str("100,99,-1,103,false") },
+
+    { njs_str("'αβ'.indexOf('\\xB1'.toBytes())"),
+      njs_str("-1") },
+
+    { njs_str("var sep = '-'.repeat(40);"
+              "['a', 'b', 'c', ''].join(sep).split(sep)"),
+      njs_str("a,b,c,") },
+
+    { njs_str("'a,b,'.repeat(20).split(',').length"),
+      njs_str("41") },
+
+    { njs_str("var s = 'x'.repeat(100) + 'абв' + 'x';"
+              "[s.replace('абв', 'Z').length, s.replace('вx', '$&$&').slice(-5),"
+              " s.replace('x'.repeat(40), '').length]"),
+      njs_str("102,бвxвx,64") },
+
     { njs_str("'abc'.lastIndexOf('abcdef')"),
       njs_str("-1") },
 
@@ -6425,6 +6666,25 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("'\x00абвгдеёжз'.toUpperCase().length"),
       njs_str("10") },
 
+    { njs_str("var s = 'Content-Type: TEXT/html @[`{ ZzAa09'.repeat(3);"
+              "[s.toLowerCase(), s.toUpperCase()].join('|')"),
+      njs_str("content-type: text/html @[`{ zzaa09content-type: text/html @[`{ zzaa09"
+              "content-type: text/html @[`{ zzaa09|"
+              "CONTENT-TYPE: TEXT/HTML @[`{ ZZAA09CONTENT-TYPE: TEXT/HTML @[`{ ZZAA09"
+              "CONTENT-TYPE: TEXT/HTML @[`{ ZZAA09") },
+
+    { njs_str("var s = 'Hello-World ПРИВЕТ abcdefghijklmnopqrstuvwxyz ÀÉÎ';"
+              "[s.toLowerCase(), s.toUpperCase()].join('|')"),
+      njs_str("hello-world привет abcdefghijklmnopqrstuvwxyz àéî|"
+              "HELLO-WORLD ПРИВЕТ ABCDEFGHIJKLMNOPQRSTUVWXYZ ÀÉÎ") },
+
+    { njs_str("var b = String.bytesFrom([0x41, 0xC1, 0x5A, 0x61, 0xE1, 0x7A, 0x40,"
+              "    0x5B, 0x60, 0x7B, 0x80, 0xFF, 0x41, 0x41, 0x41, 0x41, 0x41,"
+              "    0x41, 0x41, 0x61]);"
+              "[b.toLowerCase().toString('hex'), b.toUpperCase().toString('hex')]"),
+      njs_str("61c17a61e17a405b607b80ff6161616161616161,"
+              "41c15a41e15a405b607b80ff4141414141414141") },
+
     { njs_str("['ȿ', 'Ȿ', 'ȿ'.toUpperCase(), 'Ȿ'.toLowerCase()].map((v)=>v.toUTF8().length)"),
       njs_str("2,3,3,2") },
 
@@ -6478,6 +6738,16 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("'\\u2029abc\\uFEFF\\u2028'.trim()"),
       njs_str("abc") },
 
+    { njs_str("var w = ' \\t\\n\\v\\f\\r'.repeat(10);"
+              "[(w + 'abc def' + w).trim(), (w + 'abc' + w).trimStart().length,"
+              " (w + 'abc' + w).trimEnd().length, (w + w).trim().length,"
+              " (w + '\\u3000' + w + 'αβγ' + w).trim()]"),
+      njs_str("abc def,63,63,0,αβγ") },
+
+    { njs_str("String.bytesFrom([0x20, 0x20, 0xA0, 0x41, 0x20, 0xA0, 0x09])"
+              ".trim().toString('hex')"),
+      njs_str("41") },
+
 #if (!NJS_HAVE_MEMORY_SANITIZER) /* very long test under MSAN */
     { njs_str("var a = [], code;"
                  "for (code = 0; code <= 1114111; code++) {"
@@ -6696,6 +6966,36 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("'undefined'.replace(void 0, 'x')"),
       njs_str("x") },
 
+    { njs_str("'abc'.replace(/(?=b)/g, () => 'F')"),
+      njs_str("aFbc") },
+
+    { njs_str("'aaaa'.replace(/(?<=a)/g, 'X')"),
+      njs_str("aXaXaXaX") },
+
+    { njs_str("'aaa'.replace(/^a/g, 'X')"),
+      njs_str("Xaa") },
+
+    { njs_str("'abc'.replace(/(?=b)/, \"$'\")"),
+      njs_str("abcbc") },
+
+    { njs_str("'abc'.replace(/x*/g, '-')"),
+      njs_str("-a-b-c-") },
+
+    { njs_str("'a1b2'.replace(/\\d/g, (m) => m * 10)"),
+      njs_str("a10b20") },
+
+    { njs_str("'a1b2'.replace(/(\\d)|(x)/g, (m, p1, p2) => typeof p2)"),
+      njs_str("aundefinedbundefined") },
+
+    { njs_str("'αβγβ'.replace(/β/g, (m, off) => off)"),
+      njs_str("α1γ3") },
+
+    { njs_str("var s = 'αβγ'.repeat(100).replace(/β/g, 'bb'); [s.length, s[298]]"),
+      njs_str("400,b") },
+
+    { njs_str("'ab'.repeat(10000).replace(/b/g, '$&$&').length"),
+      njs_str("30000") },
+
     { njs_str("/]/"),
       njs_str("/\\]/") },
 
@@ -7142,6 +7442,35 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("String.bytesFrom('QUJDRA#', 'base64url')"),
       njs_str("ABCD") },
 
+    { njs_str("var b = String.bytesFrom(Array(300).fill(0).map((v, i) => i * 37));"
+              "var e = b.toString('base64'), x = b.toString('hex');"
+              "[e.length, x.length, String.bytesFrom(e, 'base64') === b,"
+              " String.bytesFrom(x, 'hex') === b,"
+              " String.bytesFrom(x.toUpperCase(), 'hex') === b,"
+              " String.bytesFrom(b.toString('base64url'), 'base64url') === b]"),
+      njs_str("400,600,true,true,true,true") },
+
+    { njs_str("var b = String.bytesFrom(Array(100).fill(0).map((v, i) => i * 5));"
+              "var e = b.toString('base64');"
+              "[e.indexOf('+') != -1, e.indexOf('/') != -1,"
+              " b.toString('base64url').indexOf('-') != -1,"
+              " b.toString('base64url').indexOf('_') != -1]"),
+      njs_str("true,true,true,true") },
+
+    { njs_str("var s = 'QUJD'.repeat(20);"
+              "[String.bytesFrom(s + 'RA==', 'base64').length,"
+              " String.bytesFrom(s.slice(0, 30) + '#' + s, 'base64').length,"
+              " String.bytesFrom(s.slice(0, 30) + '-' + s, 'base64').length,"
+              " String.bytesFrom(s.slice(0, 30) + '-' + s, 'base64url').length]"),
+      njs_str("61,22,22,83") },
+
+    { njs_str("var s = 'deadBEEF'.repeat(10);"
+              "[String.bytesFrom(s + 'aa', 'hex').length,"
+              " String.bytesFrom(s.slice(0, 40) + 'g0' + s, 'hex').length,"
+              " String.bytesFrom(s.slice(0, 41) + ':0' + s, 'hex').length,"
+              " String.bytesFrom(s + 'a', 'hex').length]"),
+      njs_str("41,20,20,40") },
+
     { njs_str("encodeURI.name"),
       njs_str("encodeURI")},
 
@@ -7211,6 +7540,31 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("decodeURI('%80%81%82').length"),
       njs_str("3")},
 
+    { njs_str("var s = 'abcdefghij'.repeat(10);"
+              "[encodeURIComponent(s) === s, encodeURI(s + '/' + s) === s + '/' + s,"
+              " encodeURIComponent(s + '/' + s + '?').length,"
+              " encodeURIComponent(s + ' ').slice(-6)]"),
+      njs_str("true,true,206,hij%20")},
+
+    { njs_str("var s = 'абвгд'.repeat(20), e = encodeURIComponent(s);"
+              "[e.length, e.slice(0, 12), decodeURIComponent(e) === s,"
+              " decodeURIComponent(e).length, decodeURIComponent(e)[77]]"),
+      njs_str("600,%D0%B0%D0%B1,true,100,в")},
+
+    { njs_str("var s = decodeURIComponent('x'.repeat(40) + '%D0%B0%D0%B1');"
+              "[s.length, s.charAt(40), s.indexOf('б')]"),
+      njs_str("42,а,41")},
+
+    { njs_str("[decodeURIComponent('аб%20в').length,"
+              " decodeURIComponent('%41бв%42'), decodeURI('а%2Fb%2f%41')]"),
+      njs_str("4,AбвB,а%2Fb%2fA")},
+
+    { njs_str("decodeURIComponent('a'.repeat(100) + '%4')"),
+      njs_str("URIError") },
+
+    { njs_str("decodeURIComponent('a'.repeat(100) + '%41%G1b')"),
+      njs_str("URIError") },
+
     /* Functions. */
 
     { njs_str("return"),
@@ -8634,6 +8988,58 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("var r = /3/g; r.exec('123') +' '+ r.exec('3')"),
       njs_str("3 null") },
 
+    { njs_str("var r = /b\\/c/g, m, a = [];"
+              "while ((m = r.exec('ab/cb/c')) !== null) {"
+              "    a.push(m.index, r.lastIndex)"
+              "} a"),
+      njs_str("1,4,4,7") },
+
+    { njs_str("[/^\\/api\\//.test('/api/v1'), /^\\/api\\//.test('x/api/'),"
+              " /^ab/m.test('x\\nab'), /^ab/.test('x\\nab')]"),
+      njs_str("true,false,true,false") },
+
+    { njs_str("'one two three'.replace(/two|one|thr/g, '[$&]')"),
+      njs_str("[one] [two] [thr]ee") },
+
+    { njs_str("/ab|a/.exec('xab')[0] + /a|ab/.exec('xab')[0]"),
+      njs_str("aba") },
+
+    { njs_str("[/cd|b|abc/.exec('xabcd').index, /cd|bc|b/.exec('xabcd')[0],"
+              " /zz|yy/.exec('xyz'), /de|a/.exec('abcde')[0]]"),
+      njs_str("1,bc,,a") },
+
+    { njs_str("var s = 'a'.repeat(100000);"
+              "[new RegExp('a'.repeat(2000) + 'b').test(s),"
+              " new RegExp('a'.repeat(2000) + 'b|aab').test(s + 'b')]"),
+      njs_str("false,true") },
+
+    { njs_str("'привет мир'.split(/ |и/)"),
+      njs_str("пр,вет,м,р") },
+
+    { njs_str("['аб/аб'.search(/б\\//), '\\x80a/'.toBytes().search(/\\//)]"),
+      njs_str("1,2") },
+
+    { njs_str("var r = /б/g, m, a = [];"
+              "while ((m = r.exec('аббв')) !== null) {"
+              "    a.push(m.index + ':' + r.lastIndex)"
+              "} a"),
+      njs_str("1:2,2:3") },
+
+    { njs_str("var r = /(б)/g; r.lastIndex = 2; var m = r.exec('бббв');"
+              "[m.index, m[1], r.lastIndex]"),
+      njs_str("2,б,3") },
+
+    { njs_str("var r = /^a/g; r.lastIndex = 1; r.exec('aaa')"),
+      njs_str("null") },
+
+    { njs_str("['aaa'.match(/^a/g), 'aaa'.split(/^a/), 'ab'.match(/(?=b)/g)]"
+              ".map(v => JSON.stringify(v))"),
+      njs_str("[\"a\"],[\"\",\"aa\"],[\"\"]") },
+
+    { njs_str("var s = 'x'.repeat(40) + 'ёж' + 'y'.repeat(40);"
+              "s.match(/x+|ё|y+/g).map(v => v.length)"),
+      njs_str("40,1,40") },
+
 #if (!NJS_HAVE_MEMORY_SANITIZER) /* FIXME */
     { njs_str("var r = /бв/ig;"
                  "var a = r.exec('АБВ');"
@@ -8644,7 +9050,7 @@ static njs_unit_test_t  njs_test[] =
 
     { njs_str("var r = /\\x80/g; r.exec('\\u0081\\u0080'.toBytes());"
                  "r.lastIndex +' '+ r.source +' '+ r.source.length +' '+ r"),
-      njs_str("1 \\x80 4 /\\x80/g") },
+      njs_str("2 \\x80 4 /\\x80/g") },
 
     { njs_str("var descs = Object.getOwnPropertyDescriptors(RegExp('a'));"
               "Object.keys(descs)"),
@@ -14461,6 +14867,97 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("JSON.parse('['.repeat(32))"),
       njs_str("SyntaxError: Nested too deep at position 31") },
 
+    /* The tokens and the escapes on the 64-byte block boundaries. */
+
+    { njs_str("var b = '\\\\';"
+                 "JSON.parse('[\"' + 'a'.repeat(62) + b + b + '\",\"x\"]')[1]"),
+      njs_str("x") },
+
+    { njs_str("var b = '\\\\';"
+                 "JSON.parse('[\"' + 'a'.repeat(61) + b + '\"\",\"x\"]')[0]"
+                 ".slice(-2)"),
+      njs_str("a\"") },
+
+    { njs_str("var b = '\\\\';"
+                 "JSON.parse('[\"' + 'a'.repeat(62) + b + '\"' + b + b + '\", 1]')"
+                 "[0].length"),
+      njs_str("64") },
+
+    { njs_str("var b = '\\\\';"
+                 "JSON.parse('\"' + (b + b).repeat(100) + '\"').length"),
+      njs_str("100") },
+
+    { njs_str("var b = '\\\\';"
+                 "JSON.parse('{\"' + 'k'.repeat(70) + b + 'u03B1\": \"'"
+                 "           + 'α'.repeat(40) + '\"}')['k'.repeat(70) + 'α']"
+                 ".length"),
+      njs_str("40") },
+
+    { njs_str("JSON.parse('[' + '{\"a\": [1, true, null, \"б\"]}, '.repeat(100)"
+                 "           + '{}]').length"),
+      njs_str("101") },
+
+    { njs_str("var s = JSON.stringify({a:[1, {b:'x\"y'}], c:'z'.repeat(70)},"
+                 "                       null, 4);"
+                 "JSON.parse(s).a[1].b"),
+      njs_str("x\"y") },
+
+    { njs_str("JSON.parse('[' + ' '.repeat(100) + '1' + ' '.repeat(100) + ']')"),
+      njs_str("1") },
+
+    { njs_str("JSON.parse('[' + '{\"a\":'.repeat(15) + '[[]]' + '}'.repeat(15)"
+                 "           + ']')[0].a.a.a.a.a.a.a.a.a.a.a.a.a.a.a.length"),
+      njs_str("1") },
+
+    { njs_str("JSON.parse('[\"' + 'x'.repeat(100) + '\\x01\"]')"),
+      njs_str("SyntaxError: Forbidden source char at position 102") },
+
+    { njs_str("JSON.parse('[\"' + 'x'.repeat(100) + '\"' + ' '.repeat(60)"
+                 "           + '\\x01]')"),
+      njs_str("SyntaxError: Unexpected token at position 163") },
+
+    { njs_str("JSON.parse('\"' + 'x'.repeat(100))"),
+      njs_str("SyntaxError: Unexpected end of input at position 101") },
+
+    { njs_str("JSON.parse('[' + 'x'.repeat(70) + ']')"),
+      njs_str("SyntaxError: Unexpected token at position 1") },
+
+    { njs_str("JSON.parse('[1x]')"),
+      njs_str("SyntaxError: Unexpected token at position 2") },
+
+    { njs_str("JSON.parse('[truex]')"),
+      njs_str("SyntaxError: Unexpected token at position 5") },
+
+    { njs_str("JSON.parse('[1 2]')"),
+      njs_str("SyntaxError: Unexpected token at position 3") },
+
+    { njs_str("JSON.parse('{\"a\":1\"b\":2}')"),
+      njs_str("SyntaxError: Unexpected token at position 6") },
+
+    { njs_str("JSON.parse('[\\\\\"a\"]')"),
+      njs_str("SyntaxError: Unexpected token at position 1") },
+
+    { njs_str("JSON.parse('[{\"long_property_name\":1,\"b\":[]},"
+              "             {\"long_property_name\":2,\"b\":{}}]')"
+              ".map(o => Object.keys(o) + ':' + o.long_property_name)"
+              ".join('|')"),
+      njs_str("long_property_name,b:1|long_property_name,b:2") },
+
+    { njs_str("var o = JSON.parse('{\"a\":1,\"\\\\u0061\":2,\"b\":0,\"a\":3}');"
+              "Object.keys(o) + ':' + o.a"),
+      njs_str("a,b:3") },
+
+    { njs_str("JSON.parse('[{\"ключ\":1},{\"ключ\":2}]')"
+              ".map(o => Object.keys(o)[0].length + o['ключ'])"),
+      njs_str("5,6") },
+
+    { njs_str("var a = JSON.parse('[' + Array(600).fill(0)"
+              "                   .map((v, i) => '{\"k' + i + '\":' + i + '}')"
+              "                   .join(',') + ']');"
+              "a.every((o, i) => o['k' + i] === i"
+              "                  && Object.keys(o).length == 1)"),
+      njs_str("true") },
+
     { njs_str("var o = JSON.parse('{', function(k, v) {return v;});o"),
       njs_str("SyntaxError: Unexpected end of input at position 1") },
 
@@ -14468,6 +14965,95 @@ static njs_unit_test_t  njs_test[] =
                  "                   function(k, v) {return v.a.a;}); o"),
       njs_str("TypeError: cannot get property \"a\" of undefined") },
 
+    /* JSON.createParser() */
+
+    { njs_str("var p = JSON.createParser();"
+              "[p.write('{\"a\":1} [1,2'), p.write(',3]\\n\"x\\\\\"y\" 12'),"
+              " p.write('3 true'), p.end()].map(v => JSON.stringify(v))"
+              ".join('|')"),
+      njs_str("[{\"a\":1}]|[[1,2,3],\"x\\\"y\"]|[123]|[true]") },
+
+    { njs_str("var p = JSON.createParser({elements: true});"
+              "[p.write(' [ {\"a\":\"]}\"}, 1'), p.write('0, \"s\\\\'),"
+              " p.write('\"\", null, [[]]'), p.end(' ] ')]"
+              ".map(v => JSON.stringify(v)).join('|')"),
+      njs_str("[{\"a\":\"]}\"}]|[10]|[\"s\\\"\",null,[[]]]|[]") },
+
+    { njs_str("var s = '[{\"id\":1,\"s\":\"a\\\\\"b\\\\\\\\c]}{\",'"
+              "        + '\"t\":[true,null,-1.5e3]},\"Ωé\",123,{}]';"
+              "var r = [];"
+              "for (var i = 0; i <= s.length; i++) {"
+              "    var p = JSON.createParser({elements: true});"
+              "    var v = JSON.stringify(p.write(s.slice(0, i))"
+              "                           .concat(p.end(s.slice(i))));"
+              "    if (r.indexOf(v) == -1) { r.push(v) }"
+              "}"
+              "r.join('|')"),
+      njs_str("[{\"id\":1,\"s\":\"a\\\"b\\\\c]}{\",\"t\":[true,null,-1500]},"
+              "\"Ωé\",123,{}]") },
+
+    { njs_str("var p = JSON.createParser({elements: true});"
+              "p.write(String.bytesFrom([0x5b, 0x22, 0xce]));"
+              "p.end(String.bytesFrom([0xa9, 0x22, 0x5d]))[0]"),
+      njs_str("Ω") },
+
+    { njs_str("JSON.createParser().end(' ')"),
+      njs_str("") },
+
+    { njs_str("JSON.createParser({elements: true}).end('[]')"),
+      njs_str("") },
+
+    { njs_str("JSON.createParser({elements: true}).end(' ')"),
+      njs_str("SyntaxError: Unexpected end of input") },
+
+    { njs_str("JSON.createParser({elements: true}).write('[1,]')"),
+      njs_str("SyntaxError: Trailing comma") },
+
+    { njs_str("JSON.createParser({elements: true}).write('[1 2]')"),
+      njs_str("SyntaxError: Unexpected token") },
+
+    { njs_str("JSON.createParser({elements: true}).write('[] 1')"),
+      njs_str("SyntaxError: Unexpected token") },
+
+    { njs_str("JSON.createParser().write('}')"),
+      njs_str("SyntaxError: Unexpected token") },
+
+    { njs_str("JSON.createParser().end('{\"a\":')"),
+      njs_str("SyntaxError: Unexpected end of input") },
+
+    { njs_str("JSON.createParser().end('[1, tru]')"),
+      njs_str("SyntaxError: Unexpected token at position 4") },
+
+    { njs_str("var p = JSON.createParser();"
+              "p.write('{\"key_name_long_enough\":1}\\n')"
+              ".concat(p.end('{\"key_name_long_enough\":2}'))"
+              ".map(o => o.key_name_long_enough)"),
+      njs_str("1,2") },
+
+    { njs_str("var p = JSON.createParser(); p.end(); p.write('1')"),
+      njs_str("Error: JSON parser is closed") },
+
+    { njs_str("var p = JSON.createParser();"
+              "try { p.write('[1}') } catch (e) {}; p.write('1')"),
+      njs_str("Error: JSON parser is closed") },
+
+    { njs_str("JSON.createParser().write(1)"),
+      njs_str("TypeError: chunk must be a string or an ArrayBuffer") },
+
+    { njs_str("JSON.createParser(1)"),
+      njs_str("TypeError: options must be an object") },
+
+    { njs_str("JSON.createParser().write.call({}, '1')"),
+      njs_str("TypeError: \"this\" is not a JSONParser") },
+
+    { njs_str("Object.prototype.toString.call(JSON.createParser())"),
+      njs_str("[object JSONParser]") },
+
+    { njs_str("var a = [1]; for (var i = 0; i < 30; i++) { a = [a] };"
+              "JSON.createParser({elements: true})"
+              ".end('[' + JSON.stringify(a) + ']')"),
+      njs_str("SyntaxError: Nested too deep at position 30") },
+
     /* JSON.stringify() */
 
     { njs_str("JSON.stringify()"),
@@ -14821,6 +15407,76 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("var a = {}; a.a = a; JSON.stringify(a)"),
       njs_str("TypeError: Nested too deep or a cyclic structure") },
 
+    { njs_str("Object.prototype.toJSON = () => 'P';"
+              "var r = JSON.stringify({a:[1]});"
+              "delete Object.prototype.toJSON;"
+              "r + JSON.stringify({a:[1]})"),
+      njs_str("\"P\"{\"a\":[1]}") },
+
+    { njs_str("Array.prototype.toJSON = function() {return this.length};"
+              "JSON.stringify({a:[1,2,3]})"),
+      njs_str("{\"a\":3}") },
+
+    { njs_str("JSON.stringify(Object.defineProperty({a:1}, 'toJSON',"
+              "                                     {value: () => 'x'}))"),
+      njs_str("\"x\"") },
+
+    { njs_str("JSON.stringify({a:{toJSON(k) {return 'k:' + k}},"
+              "                b:[{toJSON: null}]})"),
+      njs_str("{\"a\":\"k:a\",\"b\":[{\"toJSON\":null}]}") },
+
+    { njs_str("JSON.stringify({a:1, get b() {return this.a + 1}, c:3})"),
+      njs_str("{\"a\":1,\"b\":2,\"c\":3}") },
+
+    { njs_str("var o = {a:1, b:2, c:3}; delete o.b; JSON.stringify(o)"),
+      njs_str("{\"a\":1,\"c\":3}") },
+
+    { njs_str("JSON.stringify(['abcdefghijklmno\"pqrstuvwxyz0123\\\\45678"
+              "\\n9abcdef\\u0001\\u001f'])"),
+      njs_str("[\"abcdefghijklmno\\\"pqrstuvwxyz0123\\\\45678"
+              "\\n9abcdef\\u0001\\u001F\"]") },
+
+    { njs_str("JSON.stringify([0, -0, 1.5, -42, 2**53, 2**53 + 2, -(2**53),"
+              "                1e21, NaN, -Infinity])"),
+      njs_str("[0,0,1.5,-42,9007199254740992,9007199254740994,"
+              "-9007199254740992,1e+21,null,null]") },
+
+    { njs_str("JSON.stringify({a:undefined, b:Symbol(), c:() => 1, d:null,"
+              "                e:[undefined, Symbol(), () => 1]})"),
+      njs_str("{\"d\":null,\"e\":[null,null,null]}") },
+
+    { njs_str("var a = [1]; for (var i = 0; i < 30; i++) { a = [a] };"
+              "JSON.stringify(a).length"),
+      njs_str("63") },
+
+    { njs_str("var a = [1]; for (var i = 0; i < 31; i++) { a = [a] };"
+              "JSON.stringify(a)"),
+      njs_str("TypeError: Nested too deep or a cyclic structure") },
+
+    { njs_str("var o = {}; for (var i = 0; i < 30; i++) { o = {o:o} };"
+              "JSON.stringify(o).length"),
+      njs_str("182") },
+
+    { njs_str("var o = {}; for (var i = 0; i < 31; i++) { o = {o:o} };"
+              "JSON.stringify(o)"),
+      njs_str("TypeError: Nested too deep or a cyclic structure") },
+
+    { njs_str("var s = JSON.stringify({s:'αβγ\"',"
+              "                        b:String.bytesFrom([0xff, 0x41])});"
+              "[s.length, s.charCodeAt(19)]"),
+      njs_str("25,58") },
+
+    { njs_str("var s = JSON.stringify('x'.repeat(3000) + 'α');"
+              "[s.length, s.slice(-3)]"),
+      njs_str("3003,xα\"") },
+
+    { njs_str("JSON.stringify([new Number(1), new String('s'),"
+              "                new Boolean(false), Object.create(null)])"),
+      njs_str("[1,\"s\",false,{}]") },
+
+    { njs_str("njs.dump({a:'it\\'s \"q\"', b:['\\n']})"),
+      njs_str("{a:'it's \"q\"',b:['\\n']}") },
+
     /* njs.dump(). */
 
     { njs_str("njs.dump({a:1, b:[1,,2,{c:new Boolean(1)}]})"),
@@ -14850,6 +15506,93 @@ static njs_unit_test_t  njs_test[] =
     { njs_str("njs.dump(njs) == `njs {version:'${njs.version}'}`"),
       njs_str("true") },
 
+    { njs_str("var sb = new njs.StringBuilder();"
+              "sb.append('a', 1, null).append('αβ');"
+              "[sb.length, sb.toString(), sb.toString().length]"),
+      njs_str("8,a1nullαβ,8") },
+
+    { njs_str("var sb = njs.StringBuilder();"
+              "for (var i = 0; i < 10000; i++) { sb.append(i, 'б') }"
+              "var s = sb.toString(); [sb.length, s.length, s.slice(-5), s[10]]"),
+      njs_str("48890,48890,9999б,5") },
+
+    { njs_str("var sb = new njs.StringBuilder();"
+              "sb.append('x').appendBytes(String.bytesFrom([0xff, 0x41]));"
+              "[sb.length, sb.toString().toString('hex')]"),
+      njs_str("3,78ff41") },
+
+    { njs_str("new njs.StringBuilder().appendBytes(new ArrayBuffer(4)).length"),
+      njs_str("4") },
+
+    { njs_str("new njs.StringBuilder().toString() === ''"),
+      njs_str("true") },
+
+    { njs_str("var sb = new njs.StringBuilder(); sb.append('a');"
+              "[sb.toString(), sb.append('b').toString(), sb + '!']"),
+      njs_str("a,ab,ab!") },
+
+    { njs_str("var sb = new njs.StringBuilder();"
+              "[sb.constructor === njs.StringBuilder,"
+              " Object.prototype.toString.call(sb), njs.dump(sb)]"),
+      njs_str("true,[object StringBuilder],StringBuilder {}") },
+
+    { njs_str("njs.StringBuilder.prototype.append.call({}, 'a')"),
+      njs_str("TypeError: \"this\" is not a StringBuilder") },
+
+    { njs_str("var h = require('crypto').createHash('md5');"
+              "njs.StringBuilder.prototype.toString.call(h)"),
+      njs_str("TypeError: \"this\" is not a StringBuilder") },
+
+    { njs_str("new njs.StringBuilder().appendBytes(1)"),
+      njs_str("TypeError: data must be a string or an ArrayBuffer") },
+
+    { njs_str("new njs.StringBuilder().append(Symbol())"),
+      njs_str("TypeError: Cannot convert a Symbol value to a string") },
+
+    { njs_str("var v = njs.jsonView(' {\"a\":{\"b\":[1,{\"c\":\"x\\\\\"y\"},[2,3]],"
+              "\"d\":null},\"e\\\\u0041\":5,\"f\":[]} ');"
+              "JSON.stringify([v.get('a', 'b', 1), v.get('a', 'b', 2, 1),"
+              "                v.get('a', 'b', '2'), v.get('a', 'd'), v.get('eA'),"
+              "                v.get('f'), v.get('a', 'b', 1, 'c')])"),
+      njs_str("[{\"c\":\"x\\\"y\"},3,[2,3],null,5,[],\"x\\\"y\"]") },
+
+    { njs_str("var v = njs.jsonView('{\"a\":{\"b\":[1]},\"c\":\"d\"}');"
+              "[v.get('x'), v.get('a', 'b', 1), v.get('a', 'b', 'x'),"
+              " v.get('a', 'b', -1), v.get('c', 0), v.get('a', 'b', 0, 0),"
+              " v.get(Symbol())].every(v => v === undefined)"),
+      njs_str("true") },
+
+    { njs_str("var v = njs.jsonView('{\"a\":1,\"b\":{\"c\":2},\"a\":3}');"
+              "[v.get('a'), JSON.stringify(v.get()), v.get() === v.get()]"),
+      njs_str("3,{\"a\":3,\"b\":{\"c\":2}},false") },
+
+    { njs_str("var v = njs.jsonView('[\"αβ\",{\"ключ\":[true,\"☃\"]},12]');"
+              "[v.get(0), v.get(0).length, v.get(1, 'ключ', 1), v.get(2)]"),
+      njs_str("αβ,2,☃,12") },
+
+    { njs_str("[njs.jsonView(' 1.5 ').get(), njs.jsonView('\"a\"').get(0),"
+              " njs.jsonView('[]').get(0), njs.jsonView('{}').get('a')]"),
+      njs_str("1.5,,,") },
+
+    { njs_str("var v = njs.jsonView('{}');"
+              "[Object.prototype.toString.call(v), v.constructor.name, njs.dump(v)]"),
+      njs_str("[object JSONView],JSONView,JSONView {}") },
+
+    { njs_str("['', '[1,]', '{\"a\":1,}', '{\"a\" 1}', '[1 2]', '\"\\\\x\"', 'tru',"
+              " '{\"a\":}', '[1]x', '{', '\"\\\\u12\"', '['.repeat(40)]"
+              ".every(s => {"
+              "    var e1, e2;"
+              "    try { JSON.parse(s) } catch (e) { e1 = e.message }"
+              "    try { njs.jsonView(s) } catch (e) { e2 = e.message }"
+              "    return e1 !== undefined && e1 === e2 })"),
+      njs_str("true") },
+
+    { njs_str("njs.jsonView('[1,2')"),
+      njs_str("SyntaxError: Unexpected end of input at position 4") },
+
+    { njs_str("njs.jsonView('{}').get.call({}, 'a')"),
+      njs_str("TypeError: \"this\" is not a JSONView") },
+
     { njs_str("njs.dump(-0)"),
       njs_str("-0") },
 
@@ -15565,6 +16308,25 @@ static njs_unit_test_t  njs_shared_test[] =
 
     { njs_str("$r.bind('XXX', 37); XXX"),
       njs_str("37") },
+
+    { njs_str("var re = /b+/g;"
+              "['abbc', 'αbbγ', 'abbc'.toBytes(), 'abbc'].map(s => s.match(re))"
+              ".join('|')"),
+      njs_str("bb|bb|bb|bb") },
+
+    { njs_str("'abc'.toBytes().replace(/(b)/, '[$1]')"),
+      njs_str("a[b]c") },
+
+    { njs_str("'a,,b'.toBytes().split(/,+/).join('|')"),
+      njs_str("a|b") },
+
+    { njs_str("[/^$/.test(''), /y+/.test('xyz'.toBytes()),"
+              " 'xyz'.toBytes().search(/y+/)]"),
+      njs_str("true,true,1") },
+
+    { njs_str("var r = /(?<b>b+)/; var m = r.exec('abbc'.toBytes());"
+              "[m.index, m.groups.b, r.exec('αbb').groups.b]"),
+      njs_str("1,bb,bb") },
 };
 
 
@@ -16403,6 +17165,7 @@ typedef struct {
     njs_bool_t  verbose;
     njs_bool_t  unsafe;
     njs_bool_t  module;
+    njs_bool_t  regexp_prewarm;
     njs_uint_t  repeat;
 } njs_opts_t;
 
@@ -16456,6 +17219,7 @@ njs_unit_test(njs_unit_test_t tests[], size_t num, const char *name,
 
         options.module = opts->module;
         options.unsafe = opts->unsafe;
+        options.regexp_prewarm = opts->regexp_prewarm;
 
         vm = njs_vm_create(&options);
         if (vm == NULL) {
@@ -16757,6 +17521,227 @@ done:
 }
 
 
+static njs_int_t
+njs_vm_json_parser_test(njs_opts_t *opts, njs_stat_t *stat)
+{
+    u_char        *p, buf[64];
+    njs_vm_t      *vm;
+    njs_int_t     ret;
+    njs_str_t     s, result;
+    njs_uint_t    i;
+    njs_stat_t    prev;
+    njs_value_t   parser, options, values, value;
+    njs_vm_opt_t  vm_options;
+
+    static const njs_value_t  elements_key = njs_string("elements");
+
+    static const njs_str_t  script = njs_str("null");
+
+    static const njs_str_t  chunks[] = {
+        njs_str(" [{\"a\""),
+        njs_str(":\"xy\\"),
+        njs_str("\"z\"}, 1"),
+        njs_str("2,[]"),
+        njs_str("] "),
+    };
+
+    static const njs_str_t  expected =
+                          njs_str("[][][{\"a\":\"xy\\\"z\"}][12,[]][]");
+
+    prev = *stat;
+
+    ret = NJS_ERROR;
+
+    memset(&vm_options, 0, sizeof(njs_vm_opt_t));
+    vm_options.init = 1;
+
+    vm = njs_vm_create(&vm_options);
+    if (vm == NULL) {
+        njs_printf("njs_vm_create() failed\n");
+        goto done;
+    }
+
+    p = script.start;
+
+    if (njs_vm_compile(vm, &p, p + script.length) != NJS_OK
+        || njs_vm_start(vm) != NJS_OK)
+    {
+        njs_printf("njs_vm_compile() failed\n");
+        goto done;
+    }
+
+    njs_value_boolean_set(&value, 1);
+
+    if (njs_vm_object_alloc(vm, &options, &elements_key, &value, NULL)
+        != NJS_OK)
+    {
+        njs_printf("njs_vm_object_alloc() failed\n");
+        goto done;
+    }
+
+    if (njs_vm_json_parser_create(vm, &options, 1) != NJS_OK) {
+        njs_printf("njs_vm_json_parser_create() failed\n");
+        goto done;
+    }
+
+    parser = *njs_vm_retval(vm);
+
+    p = buf;
+
+    for (i = 0; i < njs_nitems(chunks); i++) {
+        ret = njs_vm_json_parse_chunk(vm, &parser, chunks[i].start,
+                                      chunks[i].length,
+                                      i == njs_nitems(chunks) - 1);
+        if (ret != NJS_OK) {
+            njs_printf("njs_vm_json_parse_chunk() failed\n");
+            goto done;
+        }
+
+        values = *njs_vm_retval(vm);
+
+        ret = njs_vm_json_stringify(vm, &values, 1);
+        if (ret != NJS_OK || njs_vm_retval_string(vm, &s) != NJS_OK) {
+            njs_printf("njs_vm_json_stringify() failed\n");
+            ret = NJS_ERROR;
+            goto done;
+        }
+
+        p = njs_cpymem(p, s.start, s.length);
+    }
+
+    result.start = buf;
+    result.length = p - buf;
+
+    if (!njs_strstr_eq(&expected, &result)) {
+        njs_printf("njs_vm_json_parser_test:\n"
+                   "expected: \"%V\"\n     got: \"%V\"\n", &expected, &result);
+        stat->failed++;
+
+    } else {
+        stat->passed++;
+    }
+
+    /* The parser is closed by the last chunk. */
+
+    if (njs_vm_json_parse_chunk(vm, &parser, (u_char *) "1", 1, 1) == NJS_OK) {
+        njs_printf("njs_vm_json_parser_test: the parser is not closed\n");
+        stat->failed++;
+
+    } else {
+        stat->passed++;
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    njs_unit_test_report("VM json parser API tests", &prev, stat);
+
+    if (vm != NULL) {
+        njs_vm_destroy(vm);
+    }
+
+    return ret;
+}
+
+
+static njs_int_t
+njs_vm_regexp_cache_test(njs_opts_t *opts, njs_stat_t *stat)
+{
+    u_char                      *p;
+    njs_vm_t                    *vm, *nvm;
+    njs_int_t                   ret;
+    njs_str_t                   s;
+    njs_uint_t                  i;
+    njs_stat_t                  prev;
+    njs_vm_opt_t                vm_options;
+    njs_vm_regexp_cache_stat_t  cache;
+
+    static const njs_str_t  script = njs_str(
+        "var re = ['a', 'b', 'a', 'c', 'a'].map(s => new RegExp('^' + s));"
+        "re.every((r, i) => r.test('abaca'[i]) && !r.test('x'))");
+
+    static const njs_str_t  result = njs_str("true");
+
+    static const njs_vm_regexp_cache_stat_t  expected[] = {
+        { .size = 2, .max = 2, .hits = 2, .misses = 3 },
+        { .size = 2, .max = 2, .hits = 5, .misses = 5 },
+    };
+
+    prev = *stat;
+
+    nvm = NULL;
+    ret = NJS_ERROR;
+
+    memset(&vm_options, 0, sizeof(njs_vm_opt_t));
+    vm_options.regexp_cache_size = 2;
+
+    vm = njs_vm_create(&vm_options);
+    if (vm == NULL) {
+        njs_printf("njs_vm_create() failed\n");
+        goto done;
+    }
+
+    p = script.start;
+
+    if (njs_vm_compile(vm, &p, p + script.length) != NJS_OK) {
+        njs_printf("njs_vm_compile() failed\n");
+        goto done;
+    }
+
+    for (i = 0; i < njs_nitems(expected); i++) {
+        nvm = njs_vm_clone(vm, NULL);
+        if (nvm == NULL) {
+            njs_printf("njs_vm_clone() failed\n");
+            goto done;
+        }
+
+        if (njs_vm_start(nvm) != NJS_OK
+            || njs_vm_retval_string(nvm, &s) != NJS_OK)
+        {
+            njs_printf("njs_vm_start() failed\n");
+            goto done;
+        }
+
+        njs_vm_regexp_cache_stat(nvm, &cache);
+
+        if (!njs_strstr_eq(&s, &result)
+            || cache.size != expected[i].size
+            || cache.max != expected[i].max
+            || cache.hits != expected[i].hits
+            || cache.misses != expected[i].misses)
+        {
+            njs_printf("njs_vm_regexp_cache_test: run %ui: \"%V\" "
+                       "size:%ui max:%ui hits:%uL misses:%uL\n", i, &s,
+                       cache.size, cache.max, cache.hits, cache.misses);
+            stat->failed++;
+
+        } else {
+            stat->passed++;
+        }
+
+        njs_vm_destroy(nvm);
+        nvm = NULL;
+    }
+
+    ret = NJS_OK;
+
+done:
+
+    njs_unit_test_report("VM regexp cache API tests", &prev, stat);
+
+    if (nvm != NULL) {
+        njs_vm_destroy(nvm);
+    }
+
+    if (vm != NULL) {
+        njs_vm_destroy(vm);
+    }
+
+    return ret;
+}
+
+
 static njs_int_t
 njs_vm_object_alloc_test(njs_vm_t *vm, njs_opts_t *opts, njs_stat_t *stat)
 {
@@ -17182,6 +18167,16 @@ main(int argc, char **argv)
         return ret;
     }
 
+    ret = njs_vm_json_parser_test(&opts, &stat);
+    if (ret != NJS_OK) {
+        return ret;
+    }
+
+    ret = njs_vm_regexp_cache_test(&opts, &stat);
+    if (ret != NJS_OK) {
+        return ret;
+    }
+
     ret = njs_api_test(&opts, &stat);
     if (ret != NJS_OK) {
         return ret;
@@ -17204,6 +18199,14 @@ main(int argc, char **argv)
         return ret;
     }
 
+    opts.regexp_prewarm = 1;
+
+    ret = njs_unit_test(njs_shared_test, njs_nitems(njs_shared_test),
+                        "shared tests (regexp prewarm)", &opts, &stat);
+    if (ret != NJS_OK) {
+        return ret;
+    }
+
     njs_printf("TOTAL: %s [%ui/%ui]\n", stat.failed ? "FAILED" : "PASSED",
                stat.passed, stat.passed + stat.failed);
 
@@ -186,6 +186,188 @@ utf8_unit_test(njs_uint_t start)
 }
 
 
+
+static ssize_t
+utf8_reference_length(const u_char *p, size_t len, ssize_t *safe_length,
+    ssize_t *safe_size)
+{
+    ssize_t       length, size;
+    uint32_t      u;
+    const u_char  *pp, *end;
+
+    end = p + len;
+
+    size = 0;
+    length = 0;
+    pp = p;
+
+    while (pp < end) {
+        u = njs_utf8_safe_decode(&pp, end);
+        size += njs_utf8_size(u);
+        length++;
+    }
+
+    *safe_length = length;
+    *safe_size = size;
+
+    length = 0;
+
+    while (p < end) {
+        if (njs_utf8_decode(&p, end) == 0xFFFFFFFF) {
+            return -1;
+        }
+
+        length++;
+    }
+
+    return length;
+}
+
+
+static njs_int_t
+utf8_length_test(void)
+{
+    u_char        *p, *start, buf[1024];
+    size_t        len;
+    ssize_t       length, expected, size, safe_length, safe_size;
+    uint32_t      key;
+    njs_bool_t    valid;
+    njs_uint_t    i, n, offset;
+    njs_str_t     *piece;
+
+    static njs_str_t  pieces[] = {
+        njs_str("a"),
+        njs_str("abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUV"),
+        njs_str("abcdefghijklmnop"),
+        njs_str("α"),
+        njs_str("€"),
+        njs_str("😀"),
+        njs_str("абвгдежзийклмноп"),
+        njs_str("\x80"),
+        njs_str("\xC3"),
+        njs_str("\xE0\x80"),
+        njs_str("\xF5\x80\x80\x80"),
+        njs_str("\xED\xA0\x80"),
+    };
+
+    njs_printf("utf8 length test started\n");
+
+    key = 0;
+
+    for (i = 0; i < 100000; i++) {
+        key = njs_murmur_hash2(&key, sizeof(uint32_t));
+
+        offset = key % 32;
+        len = (key >> 8) % 400;
+        p = &buf[offset];
+        start = p;
+
+        while ((size_t) (p - start) < len) {
+            key = njs_murmur_hash2(&key, sizeof(uint32_t));
+
+            n = key % 64;
+
+            /* Invalid sequences are rare. */
+
+            if (n < 7 * 9) {
+                piece = &pieces[n % 7];
+
+            } else {
+                piece = &pieces[7 + (key >> 8) % 5];
+            }
+
+            p = njs_cpymem(p, piece->start, piece->length);
+        }
+
+        len = p - start;
+
+        expected = utf8_reference_length(start, len, &safe_length, &safe_size);
+
+        length = njs_utf8_length(start, len);
+        valid = njs_utf8_is_valid(start, len);
+
+        if (length != expected || valid != (expected >= 0)) {
+            njs_printf("njs_utf8_length() failed: %z, expected: %z, "
+                       "valid: %d, offset: %ui, size: %uz\n", length,
+                       expected, (int) valid, offset, len);
+            return NJS_ERROR;
+        }
+
+        length = njs_utf8_safe_length(start, len, &size);
+
+        if (length != safe_length || size != safe_size) {
+            njs_printf("njs_utf8_safe_length() failed: %z:%z, "
+                       "expected: %z:%z\n", length, size, safe_length,
+                       safe_size);
+            return NJS_ERROR;
+        }
+    }
+
+    njs_printf("utf8 length test passed\n");
+
+    return NJS_OK;
+}
+
+
+static njs_int_t
+utf8_length_throughput(const char *name, const u_char *piece, size_t len)
+{
+    u_char        *buf, *p;
+    size_t        size;
+    ssize_t       length, expected, safe_length, safe_size;
+    uint64_t      start, reference_time, time;
+    njs_uint_t    i;
+
+    static const njs_uint_t  repeats = 10;
+
+    size = 4 * 1024 * 1024;
+
+    buf = njs_malloc(size + len);
+    if (buf == NULL) {
+        return NJS_ERROR;
+    }
+
+    for (p = buf; p < buf + size; p += len) {
+        memcpy(p, piece, len);
+    }
+
+    size = p - buf;
+
+    expected = 0;
+    start = njs_time();
+
+    for (i = 0; i < repeats; i++) {
+        expected = utf8_reference_length(buf, size, &safe_length, &safe_size);
+    }
+
+    reference_time = njs_time() - start;
+
+    length = 0;
+    start = njs_time();
+
+    for (i = 0; i < repeats; i++) {
+        length = njs_utf8_length(buf, size);
+        (void) njs_utf8_safe_length(buf, size, NULL);
+    }
+
+    time = njs_time() - start;
+
+    njs_free(buf);
+
+    if (length != expected) {
+        njs_printf("njs_utf8_length() failed on %s: %z, expected: %z\n",
+                   name, length, expected);
+        return NJS_ERROR;
+    }
+
+    njs_printf("utf8 length of 4MB %s: %.1f MB/s, reference: %.1f MB/s\n",
+               name, (double) (2 * repeats * size) / time * 1000,
+               (double) (2 * repeats * size) / reference_time * 1000);
+
+    return NJS_OK;
+}
+
+
 int
 main(int argc, char **argv)
 {
@@ -198,5 +380,22 @@ main(int argc, char **argv)
         start = 256;
     }
 
-    return utf8_unit_test(start);
+    if (utf8_unit_test(start) != NJS_OK || utf8_length_test() != NJS_OK) {
+        return 1;
+    }
+
+    if (utf8_length_throughput("ASCII text",
+                               (u_char *) "The quick brown fox jumps over "
+                               "the lazy dog. ", 45) != NJS_OK
+        || utf8_length_throughput("mostly ASCII text",
+                                  (u_char *) "The quick brown fox jumps over "
+                                  "the lazy dog \xE2\x80\x94 ", 47) != NJS_OK
+        || utf8_length_throughput("Cyrillic text",
+                                  (u_char *) "\xD0\xB0\xD0\xB1\xD0\xB2 ",
+                                  7) != NJS_OK)
+    {
+        return 1;
+    }
+
+    return 0;
 }